@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+// Handed to each benchmark body, which wraps the measured operation in
+// `while (state.keep_running()) { ... }`. Only the loop is timed, so setup before it is free.
+class State {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit State(std::uint64_t iterations) : iterations_(iterations), remaining_(iterations) {}
+
+    bool keep_running() {
+        if (!started_) {
+            started_ = true;
+            start_ = Clock::now();
+        }
+        if (remaining_ == 0) {
+            stop_ = Clock::now();
+            return false;
+        }
+        --remaining_;
+        return true;
+    }
+
+    [[nodiscard]] std::uint64_t iterations() const { return iterations_; }
+    [[nodiscard]] Clock::duration elapsed() const { return stop_ - start_; }
+
+private:
+    std::uint64_t iterations_;
+    std::uint64_t remaining_;
+    bool started_ = false;
+    Clock::time_point start_{};
+    Clock::time_point stop_{};
+};
+
+// Keeps the compiler from discarding a computed value or hoisting it out of the loop
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    double ns_per_op = 0.0;
+    std::uint64_t iterations = 0;
+};
+
+class Registry {
+public:
+    using Body = std::function<void(State&)>;
+
+    void add(std::string name, Body body) {
+        entries_.push_back({std::move(name), std::move(body)});
+    }
+
+    // Runs every benchmark whose name contains `filter`
+    [[nodiscard]] std::vector<Result> run(const std::string& filter,
+                                          std::chrono::milliseconds min_time) const;
+
+private:
+    struct Entry {
+        std::string name;
+        Body body;
+    };
+    std::vector<Entry> entries_;
+};
+
+// Defined in the bench_*.cpp files
+void register_simulation_benchmarks(Registry& registry);
+void register_renderer_benchmarks(Registry& registry);
+
+} // namespace bench
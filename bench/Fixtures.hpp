@@ -0,0 +1,40 @@
+#pragma once
+
+#include "../src/Direction.hpp"
+#include "../src/RunLengthBody.hpp"
+#include "../src/Snake.hpp"
+
+#include <utility>
+
+namespace bench {
+
+// Direction of a Hamiltonian cycle through the grid: column 0 runs back up to the top and the
+// remaining columns are swept row by row. Odd heights leave the last row out of the cycle. A
+// snake that follows it never dies, so update() can be timed at a fixed length indefinitely.
+inline Direction cycle_direction(sf::Vector2i p, int w, int h) {
+    const int rows = h - h % 2;
+    if (p.x == 0) return p.y == 0 ? Direction::Right : Direction::Up;
+    if (p.y % 2 == 0) return p.x < w - 1 ? Direction::Right : Direction::Down;
+    if (p.x > 1) return Direction::Left;
+    return p.y == rows - 1 ? Direction::Left : Direction::Down;
+}
+
+// Snake of the given length laid along the cycle, reset to a w x h grid
+inline Snake snake_on_cycle(int length, int w, int h) {
+    RunLengthBody body;
+    sf::Vector2i cell{0, 0};
+    Direction dir = Direction::Up; // how the tail entered (0, 0)
+    body.push_front(cell, dir);
+    for (int i = 1; i < length; ++i) {
+        dir = cycle_direction(cell, w, h);
+        cell += direction_delta(dir);
+        body.push_front(cell, dir);
+    }
+
+    Snake snake;
+    snake.reset(w, h);
+    snake.restore(std::move(body), dir, dir, false);
+    return snake;
+}
+
+} // namespace bench
@@ -0,0 +1,134 @@
+#include "Bench.hpp"
+#include "Fixtures.hpp"
+
+#include "../src/Board.hpp"
+#include "../src/Config.hpp"
+#include "../src/Game.hpp"
+#include "../src/Renderer.hpp"
+
+#include <SFML/Graphics/RenderTexture.hpp>
+
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <print>
+#include <span>
+#include <vector>
+
+namespace bench {
+
+namespace {
+
+// A mid-game frame of the given board; tiles non-empty for the split screen
+RenderContext playing_context(const Snake& snake, const Board& board,
+                              const ParticleSystem& particles, std::span<const GameTile> tiles,
+                              const sf::View& view, int grid) {
+    const auto length = static_cast<int>(snake.body().size());
+    return RenderContext{
+        .snake = snake,
+        .board = board,
+        .particles = particles,
+        .heatmap = nullptr,
+        .tiles = tiles,
+        .state = GameState::Playing,
+        .score = length - 3,
+        .high_score = length,
+        .is_new_high_score = false,
+        .autopilot = false,
+        .alpha = 0.5f,
+        .cell_size = Config::cell_size,
+        .grid_w = grid,
+        .grid_h = grid,
+        .elapsed_time = 1.f,
+        .bonus_time_remaining = 0.f,
+        .shake_offset = {},
+        .game_view = view,
+        .settings_cursor = 0,
+        .settings_binding_mode = false,
+        .settings_grid_size = grid,
+        .settings_speed_label = "Normal",
+        .settings_ai_rollouts = 0,
+        .settings_level = "Open",
+        .settings_split_games = tiles.empty() ? 1 : static_cast<int>(tiles.size()),
+        .settings_key_up = "Up",
+        .settings_key_down = "Down",
+        .settings_key_left = "Left",
+        .settings_key_right = "Right",
+        .settings_key_pause = "P",
+    };
+}
+
+} // namespace
+
+void register_renderer_benchmarks(Registry& registry) {
+    // Offscreen target the size of the largest preset; shared so each benchmark does not pay
+    // for creating a GL context
+    constexpr int grid = 30;
+    constexpr auto side = static_cast<unsigned>(grid * Config::cell_size);
+    auto target = std::make_shared<sf::RenderTexture>();
+    if (!target->resize({side, side})) {
+        std::println(stderr, "[bench] No render context, skipping Renderer benchmarks");
+        return;
+    }
+
+    auto renderer = Renderer::create();
+    if (!renderer) {
+        std::println(stderr, "[bench] {}, skipping Renderer benchmarks", renderer.error());
+        return;
+    }
+    auto shared = std::make_shared<Renderer>(std::move(*renderer));
+    const auto size = static_cast<float>(side);
+    const sf::View view(sf::FloatRect({0.f, 0.f}, {size, size}));
+
+    for (const int length : {4, 64, 200, 800}) {
+        registry.add(std::format("Renderer::draw/len={}/grid={}", length, grid),
+                     [=](State& state) {
+                         const Snake snake = snake_on_cycle(length, grid, grid);
+                         Board board(grid, grid, 1);
+                         board.spawn_food(snake);
+                         board.spawn_bonus(snake);
+                         const ParticleSystem particles(0);
+                         const RenderContext ctx =
+                             playing_context(snake, board, particles, {}, view, grid);
+
+                         while (state.keep_running()) {
+                             shared->draw(*target, ctx);
+                             target->display();
+                         }
+                     });
+    }
+
+    // Every split screen board in the same frame, snakes of assorted lengths
+    constexpr int games = 16;
+    registry.add(std::format("Renderer::draw_split/games={}/grid={}", games, grid),
+                 [=](State& state) {
+                     std::vector<Snake> snakes;
+                     std::vector<Board> boards;
+                     for (int i = 0; i < games; ++i) {
+                         snakes.push_back(snake_on_cycle(4 + i * 50, grid, grid));
+                         boards.emplace_back(grid, grid, static_cast<std::uint64_t>(i + 1));
+                         boards.back().spawn_food(snakes.back());
+                         boards.back().spawn_bonus(snakes.back());
+                     }
+                     std::vector<GameTile> tiles;
+                     for (int i = 0; i < games; ++i) {
+                         const auto n = static_cast<std::size_t>(i);
+                         tiles.push_back({.snake = snakes[n],
+                                          .board = boards[n],
+                                          .alpha = 0.5f,
+                                          .bonus_time_remaining = 2.f,
+                                          .score = i * 50 + 1,
+                                          .name = "Greedy"});
+                     }
+                     const ParticleSystem particles(0);
+                     const RenderContext ctx = playing_context(snakes.front(), boards.front(),
+                                                               particles, tiles, view, grid);
+
+                     while (state.keep_running()) {
+                         shared->draw(*target, ctx);
+                         target->display();
+                     }
+                 });
+}
+
+} // namespace bench
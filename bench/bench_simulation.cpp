@@ -0,0 +1,512 @@
+#include "Bench.hpp"
+#include "Fixtures.hpp"
+
+#include "../src/Bitboard.hpp"
+#include "../src/Board.hpp"
+#include "../src/Config.hpp"
+#include "../src/Dataset.hpp"
+#include "../src/DistanceField.hpp"
+#include "../src/FileIO.hpp"
+#include "../src/Heatmap.hpp"
+#include "../src/Level.hpp"
+#include "../src/Mcts.hpp"
+#include "../src/Metrics.hpp"
+#include "../src/Observation.hpp"
+#include "../src/Particles.hpp"
+#include "../src/Policy.hpp"
+#include "../src/Simulation.hpp"
+#include "../src/Snapshot.hpp"
+#include "../src/Spectator.hpp"
+#include "../src/TimerWheel.hpp"
+
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <print>
+#include <vector>
+
+namespace bench {
+
+namespace {
+
+// Lengths are capped by the smallest grid's cycle (15 x 14 cells)
+constexpr std::array lengths = {4, 64, 200};
+constexpr std::array grids = {15, 30};
+
+void register_snake(Registry& registry) {
+    for (const int grid : grids) {
+        for (const int length : lengths) {
+            registry.add(std::format("Snake::update/len={}/grid={}", length, grid),
+                         [=](State& state) {
+                             Snake snake = snake_on_cycle(length, grid, grid);
+                             while (state.keep_running()) {
+                                 snake.set_direction(cycle_direction(snake.head(), grid, grid));
+                                 snake.update();
+                                 do_not_optimize(snake.hash());
+                             }
+                         });
+
+            registry.add(std::format("Snake::occupies/len={}/grid={}", length, grid),
+                         [=](State& state) {
+                             const Snake snake = snake_on_cycle(length, grid, grid);
+                             std::vector<sf::Vector2i> probes(1024);
+                             Rng rng(1);
+                             for (auto& p : probes) {
+                                 p = {static_cast<int>(rng.below(grid)),
+                                      static_cast<int>(rng.below(grid))};
+                             }
+                             std::size_t i = 0;
+                             while (state.keep_running()) {
+                                 do_not_optimize(snake.occupies(probes[i++ % probes.size()]));
+                             }
+                         });
+
+            registry.add(std::format("Board::spawn_food/len={}/grid={}", length, grid),
+                         [=](State& state) {
+                             const Snake snake = snake_on_cycle(length, grid, grid);
+                             Board board(grid, grid, 1);
+                             while (state.keep_running()) {
+                                 board.spawn_food(snake);
+                                 do_not_optimize(board.food_position());
+                             }
+                         });
+        }
+    }
+
+    // Near-full board, where free cells are scarce
+    registry.add("Board::spawn_food/len=800/grid=30", [](State& state) {
+        const Snake snake = snake_on_cycle(800, 30, 30);
+        Board board(30, 30, 1);
+        while (state.keep_running()) {
+            board.spawn_food(snake);
+            do_not_optimize(board.food_position());
+        }
+    });
+}
+
+// A mid-game position reached by the rollout policy
+Simulation mid_game(std::uint64_t seed) {
+    Simulation sim(Config::grid_width, Config::grid_height, Config::initial_tick, seed);
+    Rng rng(seed);
+    while (!sim.is_over() && sim.tick() < 200) {
+        sim.set_direction(heuristic_move(sim, rng));
+        sim.step();
+    }
+    return sim;
+}
+
+void register_state(Registry& registry) {
+    registry.add("Simulation::snapshot", [](State& state) {
+        const Simulation sim = mid_game(1);
+        Snapshot snap;
+        while (state.keep_running()) {
+            sim.snapshot(snap);
+            do_not_optimize(snap);
+        }
+    });
+
+    registry.add("Simulation::restore", [](State& state) {
+        Simulation sim = mid_game(1);
+        Snapshot snap;
+        sim.snapshot(snap);
+        while (state.keep_running()) {
+            sim.restore(snap);
+            do_not_optimize(sim.hash());
+        }
+    });
+
+    // What Mcts does instead of restore() to start each rollout from the root
+    registry.add("Simulation/copy", [](State& state) {
+        const Simulation root = mid_game(1);
+        Simulation sim = root;
+        while (state.keep_running()) {
+            sim = root;
+            do_not_optimize(sim.hash());
+        }
+    });
+
+    registry.add("RewindBuffer::push", [](State& state) {
+        // Consecutive frames of one game, so the deltas are as small as in play
+        std::vector<Snapshot> frames(64);
+        Simulation sim = mid_game(1);
+        Rng rng(1);
+        for (auto& frame : frames) {
+            sim.snapshot(frame);
+            sim.set_direction(heuristic_move(sim, rng));
+            sim.step();
+        }
+        RewindBuffer buffer(Config::rewind_seconds * 1000 / Config::initial_tick.count(),
+                            Config::rewind_buffer_bytes);
+        std::size_t i = 0;
+        while (state.keep_running()) {
+            buffer.push(frames[i++ % frames.size()]);
+            do_not_optimize(buffer.bytes_used());
+        }
+    });
+}
+
+void register_games(Registry& registry) {
+    // Whole headless games driven by the rollout policy; ops/s is games per second
+    registry.add("game/heuristic/grid=20", [](State& state) {
+        std::uint64_t seed = 0;
+        while (state.keep_running()) {
+            Simulation sim(20, 20, Config::initial_tick, ++seed);
+            Rng rng(seed);
+            while (!sim.is_over() && sim.tick() < 5000) {
+                sim.set_direction(heuristic_move(sim, rng));
+                sim.step();
+            }
+            do_not_optimize(sim.score());
+        }
+    });
+
+    // Games driven by the weighted autopilot that snake_tune evaluates, at its starting weights
+    registry.add("game/weighted/grid=20", [](State& state) {
+        const PolicyWeights weights{.food = 1.0f, .space = 0.5f, .tail = 0.5f};
+        std::uint64_t seed = 0;
+        while (state.keep_running()) {
+            Simulation sim(20, 20, Config::initial_tick, ++seed);
+            sim.enable_distance_field();
+            while (!sim.is_over() && sim.tick() < 5000) {
+                sim.set_direction(weighted_move(sim, weights));
+                sim.step();
+            }
+            do_not_optimize(sim.score());
+        }
+    });
+
+    // The same games recorded into a heatmap, as snake_batch does; the gap is the per-tick cost
+    registry.add("game/heuristic/grid=20/heatmap", [](State& state) {
+        Heatmap heatmap(20, 20);
+        std::uint64_t seed = 0;
+        while (state.keep_running()) {
+            Simulation sim(20, 20, Config::initial_tick, ++seed);
+            Rng rng(seed);
+            heatmap.record_start(sim);
+            while (!sim.is_over() && sim.tick() < 5000) {
+                sim.set_direction(heuristic_move(sim, rng));
+                heatmap.record(sim, sim.step());
+            }
+            do_not_optimize(sim.score());
+        }
+        do_not_optimize(heatmap.max(HeatCounter::Visits));
+    });
+
+    // The same games recorded as training data; the I/O thread's packing and writing count too
+    // when they share the core
+    registry.add("game/heuristic/grid=20/dataset", [](State& state) {
+        const auto path = std::filesystem::temp_directory_path() / "snake_bench_dataset.bin";
+        {
+            auto writer = DatasetWriter::create(path.string());
+            if (!writer) return;
+            DatasetBuffer buffer = writer->buffer();
+            std::uint64_t seed = 0;
+            while (state.keep_running()) {
+                Simulation sim(20, 20, Config::initial_tick, ++seed);
+                Rng rng(seed);
+                while (!sim.is_over() && sim.tick() < 5000) {
+                    const Direction move = heuristic_move(sim, rng);
+                    buffer.begin_step(sim, move);
+                    sim.set_direction(move);
+                    buffer.end_step(sim, sim.step());
+                }
+                do_not_optimize(sim.score());
+            }
+        }
+        std::filesystem::remove(path);
+    });
+
+    // One autopilot decision at the lowest budget, single-threaded
+    registry.add("Mcts::search/rollouts=1000/threads=1", [](State& state) {
+        const Simulation sim = mid_game(1);
+        Mcts mcts(1);
+        while (state.keep_running()) {
+            const auto deadline = Mcts::Clock::now() + std::chrono::seconds(10);
+            do_not_optimize(mcts.search(sim, 1000, deadline));
+        }
+    });
+}
+
+void register_particles(Registry& registry) {
+    // The frame budget for effects is 1 ms at full capacity. Lifetimes outlast the run, so the
+    // population stays at capacity and each op is one full pass.
+    registry.add("ParticleSystem::update/n=100000", [](State& state) {
+        ParticleSystem particles(100'000, 1);
+        particles.burst({320.f, 320.f}, particles.capacity(), Config::food_color,
+                        Config::particle_speed, 1e9f);
+        while (state.keep_running()) {
+            particles.update(1.f / 240.f);
+            do_not_optimize(particles.x()[0]);
+        }
+    });
+
+    // Steady churn: every particle expires within a few frames and is replaced by bursts
+    registry.add("ParticleSystem::update/churn/n=100000", [](State& state) {
+        ParticleSystem particles(100'000, 1);
+        while (state.keep_running()) {
+            particles.burst({320.f, 320.f}, particles.capacity() - particles.size(),
+                            Config::food_color, Config::particle_speed, 0.05f);
+            particles.update(1.f / 60.f);
+            do_not_optimize(particles.size());
+        }
+    });
+}
+
+// Walled square rooms of every preset size with a pillar grid inside, packed and mapped
+LevelPack bench_pack() {
+    std::vector<LevelSpec> specs;
+    for (const int size : {15, 20, 25, 30}) {
+        std::string text;
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                const bool border = x == 0 || y == 0 || x == size - 1 || y == size - 1;
+                const bool pillar = x % 4 == 2 && y % 4 == 2;
+                text += x == size / 2 && y == size / 2 ? '<' : border || pillar ? '#' : '.';
+            }
+            text += '\n';
+        }
+        specs.push_back(parse_level(std::format("Room{}", size), text).value());
+    }
+    const std::string path = "bench_levels.pack";
+    write_file_atomically(path, LevelPack::build(specs));
+    auto pack = LevelPack::open(path);
+    std::remove(path.c_str());
+    return std::move(pack).value();
+}
+
+void register_levels(Registry& registry) {
+    // Switching levels is a new Simulation over views into the mapping; nothing is parsed or
+    // copied per level
+    registry.add("Simulation/level-switch", [](State& state) {
+        const LevelPack pack = bench_pack();
+        std::size_t i = 0;
+        while (state.keep_running()) {
+            const Simulation sim(pack.level(i % pack.size()), Config::initial_tick, i);
+            ++i;
+            do_not_optimize(sim.board().food_position());
+        }
+    });
+
+    // Food placement on a walled level; compare Board::spawn_food/len=*/grid=30 for open boards
+    registry.add("Board::spawn_food/level=Room30", [](State& state) {
+        const LevelPack pack = bench_pack();
+        const Level& level = pack.level(3);
+        Snake snake;
+        snake.reset(level);
+        Board board(level, 1);
+        while (state.keep_running()) {
+            board.spawn_food(snake);
+            do_not_optimize(board.food_position());
+        }
+    });
+}
+
+template <typename T>
+void encode_batch(State& state, int batch) {
+    const ObservationLayout layout;
+    std::vector<Simulation> games;
+    for (int i = 0; i < batch; ++i) games.push_back(mid_game(static_cast<std::uint64_t>(i)));
+    std::vector<T> out(games.size() * layout.stride());
+    while (state.keep_running()) {
+        encode_observations(games, layout, out);
+        do_not_optimize(out.back());
+    }
+}
+
+void register_observations(Registry& registry) {
+    // A batch of 4096 is one learner step over that many parallel games
+    for (const int batch : {1, 4096}) {
+        registry.add(std::format("encode_observations/batch={}/float", batch),
+                     [=](State& state) { encode_batch<float>(state, batch); });
+        registry.add(std::format("encode_observations/batch={}/uint8", batch),
+                     [=](State& state) { encode_batch<std::uint8_t>(state, batch); });
+    }
+}
+
+void register_distance_field(Registry& registry) {
+    // A full BFS, which every food respawn pays, against the incremental update every other tick
+    // pays; Snake::update/len=200/grid=30 is the snake's own share of the tick
+    registry.add("DistanceField::reset/len=200/grid=30", [](State& state) {
+        const Snake snake = snake_on_cycle(200, 30, 30);
+        DistanceField field(Level::open_board(30, 30));
+        while (state.keep_running()) {
+            field.reset({15, 20}, snake);
+            do_not_optimize(field.reachable_count());
+        }
+    });
+
+    registry.add("DistanceField/tick/len=200/grid=30", [](State& state) {
+        Snake snake = snake_on_cycle(200, 30, 30);
+        DistanceField field(Level::open_board(30, 30));
+        field.reset({15, 20}, snake);
+        while (state.keep_running()) {
+            snake.set_direction(cycle_direction(snake.head(), 30, 30));
+            snake.update();
+            field.unblock(snake.prev_tail());
+            field.block(snake.head());
+            do_not_optimize(field.reachable_count());
+        }
+    });
+}
+
+void register_bitboards(Registry& registry) {
+    // Flood fill over the whole free area of a 30x30 board, 64 cells per word per step; compare
+    // DistanceField::reset for the same area one cell at a time
+    registry.add("flood_fill/len=200/grid=30", [](State& state) {
+        const Snake snake = snake_on_cycle(200, 30, 30);
+        Bitboard free = Bitboard::full(30, 30);
+        free.subtract(Bitboard::from(snake.occupancy()));
+        Bitboard seed(30, 30);
+        seed.set({15, 20});
+        while (state.keep_running()) do_not_optimize(flood_fill(seed, free, {}).count());
+    });
+
+    // The lookahead check itself: legal, and room for the snake once it has moved
+    registry.add("BitboardState::leaves_room/len=200/grid=30", [](State& state) {
+        Simulation sim(30, 30, Config::initial_tick, 1);
+        const Snake snake = snake_on_cycle(200, 30, 30);
+        BitboardState position = BitboardState::from(sim);
+        position.body = Bitboard::from(snake.occupancy());
+        position.head = snake.head();
+        position.tail = snake.body().back();
+        position.direction = snake.direction();
+        position.length = 200;
+        std::size_t i = 0;
+        while (state.keep_running()) {
+            do_not_optimize(position.leaves_room(all_directions[i++ % all_directions.size()]));
+        }
+    });
+}
+
+void register_timers(Registry& registry) {
+    // One tick of a wheel holding 10000 timers (power-ups, arena snakes), each rescheduled as
+    // it fires; per-timer polling would touch all of them every tick
+    registry.add("TimerWheel::advance/timers=10000", [](State& state) {
+        TimerWheel<std::uint32_t> wheel;
+        Rng rng(1);
+        for (std::uint32_t id = 0; id < 10'000; ++id) wheel.schedule(1 + rng.below(4096), id);
+        while (state.keep_running()) {
+            wheel.advance(wheel.now() + 1,
+                          [&](std::uint32_t id) { wheel.schedule(1 + rng.below(4096), id); });
+            do_not_optimize(wheel.size());
+        }
+    });
+}
+
+void register_metrics(Registry& registry) {
+    // What the game thread pays per frame, and the scrape thread per request
+    registry.add("Histogram::observe", [](State& state) {
+        Histogram histogram{1'000, 4'000, 8'000, 12'000, 17'000, 25'000, 34'000, 50'000};
+        std::uint64_t value = 0;
+        while (state.keep_running()) {
+            histogram.observe(value);
+            value = (value + 7'919) % 60'000;
+        }
+    });
+
+    registry.add("Metrics::render", [](State& state) {
+        while (state.keep_running()) do_not_optimize(Metrics::render().size());
+    });
+}
+
+void register_spectator(Registry& registry) {
+    // A state whose body slice wraps around the end of the cell ring
+    auto body_of = [](int length) {
+        Snapshot snap{};
+        snap.grid_w = snap.grid_h = 30;
+        snap.body_length = static_cast<std::uint16_t>(length);
+        snap.body_start = Snapshot::max_cells - 100;
+        return snap;
+    };
+
+    // What the game thread pays per tick with --spectate
+    for (const int length : {4, 200, 800}) {
+        registry.add(std::format("SpectatorFeed::publish/len={}", length), [=](State& state) {
+            auto feed = SpectatorFeed::create("/snake-bench");
+            if (!feed) {
+                std::println(stderr, "[bench] {}", feed.error());
+                return;
+            }
+            const Snapshot snap = body_of(length);
+            while (state.keep_running()) feed->publish(snap);
+        });
+    }
+
+    registry.add("SpectatorReader::next/len=200", [=](State& state) {
+        auto feed = SpectatorFeed::create("/snake-bench");
+        if (!feed) {
+            std::println(stderr, "[bench] {}", feed.error());
+            return;
+        }
+        auto reader = SpectatorReader::open("/snake-bench");
+        if (!reader) return;
+        Snapshot snap = body_of(200);
+        while (state.keep_running()) {
+            feed->publish(snap);
+            do_not_optimize(reader->next(snap));
+        }
+    });
+}
+
+} // namespace
+
+void register_dataset(Registry& registry) {
+    // Steps of recorded games read back in order and at random
+    const auto path = std::filesystem::temp_directory_path() / "snake_bench_dataset_read.bin";
+    auto write_games = [path] {
+        auto writer = DatasetWriter::create(path.string());
+        if (!writer) return;
+        DatasetBuffer buffer = writer->buffer();
+        for (std::uint64_t seed = 1; seed <= 200; ++seed) {
+            Simulation sim(20, 20, Config::initial_tick, seed);
+            Rng rng(seed);
+            while (!sim.is_over()) {
+                const Direction move = heuristic_move(sim, rng);
+                buffer.begin_step(sim, move);
+                sim.set_direction(move);
+                buffer.end_step(sim, sim.step());
+            }
+        }
+    };
+
+    registry.add("DatasetReader::read", [=](State& state) {
+        write_games();
+        auto reader = DatasetReader::open(path.string());
+        if (!reader || reader->size() == 0) return;
+        Transition step;
+        std::uint64_t i = 0;
+        while (state.keep_running()) {
+            do_not_optimize(reader->read(i, step));
+            if (++i == reader->size()) i = 0;
+        }
+        std::filesystem::remove(path);
+    });
+
+    registry.add("DatasetReader::sample", [=](State& state) {
+        write_games();
+        auto reader = DatasetReader::open(path.string());
+        if (!reader) return;
+        Rng rng(1);
+        Transition step;
+        while (state.keep_running()) do_not_optimize(reader->sample(rng, step));
+        std::filesystem::remove(path);
+    });
+}
+
+void register_simulation_benchmarks(Registry& registry) {
+    register_snake(registry);
+    register_state(registry);
+    register_games(registry);
+    register_particles(registry);
+    register_levels(registry);
+    register_observations(registry);
+    register_distance_field(registry);
+    register_bitboards(registry);
+    register_timers(registry);
+    register_metrics(registry);
+    register_spectator(registry);
+    register_dataset(registry);
+}
+
+} // namespace bench
@@ -0,0 +1,188 @@
+#include "Bench.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <map>
+#include <print>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace bench {
+
+namespace {
+
+constexpr int repetitions = 5;
+constexpr std::uint64_t max_iterations = std::uint64_t{1} << 32;
+
+double seconds(State::Clock::duration d) { return std::chrono::duration<double>(d).count(); }
+
+std::uint64_t calibrate(const Registry::Body& body, double target_seconds) {
+    std::uint64_t iterations = 1;
+    while (iterations < max_iterations) {
+        State state(iterations);
+        body(state);
+        const double elapsed = seconds(state.elapsed());
+        if (elapsed >= target_seconds) break;
+        // Jump straight to the estimate once the timer resolution stops mattering
+        if (elapsed > target_seconds / 100) {
+            return std::max<std::uint64_t>(
+                1, static_cast<std::uint64_t>(target_seconds / elapsed * iterations));
+        }
+        iterations *= 10;
+    }
+    return iterations;
+}
+
+} // namespace
+
+std::vector<Result> Registry::run(const std::string& filter,
+                                  std::chrono::milliseconds min_time) const {
+    const double target = std::chrono::duration<double>(min_time).count() / repetitions;
+
+    std::vector<Result> results;
+    for (const auto& entry : entries_) {
+        if (!entry.name.contains(filter)) continue;
+
+        const auto iterations = calibrate(entry.body, target);
+        std::vector<double> samples;
+        for (int i = 0; i < repetitions; ++i) {
+            State state(iterations);
+            entry.body(state);
+            samples.push_back(seconds(state.elapsed()) * 1e9 / static_cast<double>(iterations));
+        }
+        std::ranges::sort(samples);
+        const double median = samples[samples.size() / 2];
+
+        std::println("{:<48} {:>14.1f} ns/op {:>14.0f} ops/s", entry.name, median, 1e9 / median);
+        results.push_back({entry.name, median, iterations});
+    }
+    return results;
+}
+
+} // namespace bench
+
+namespace {
+
+// One benchmark per line, so the baseline diffs cleanly and is easy to read back
+bool write_json(const std::string& path, const std::vector<bench::Result>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "{\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"ns_per_op\": " << r.ns_per_op
+            << ", \"iterations\": " << r.iterations << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+// Reads back the subset of JSON written above; anything else is ignored
+std::map<std::string, double> read_json(const std::string& path) {
+    std::map<std::string, double> baseline;
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    const std::string text = ss.str();
+
+    constexpr std::string_view name_key = "\"name\": \"";
+    constexpr std::string_view ns_key = "\"ns_per_op\": ";
+    for (std::size_t pos = text.find(name_key); pos != std::string::npos;
+         pos = text.find(name_key, pos)) {
+        pos += name_key.size();
+        const auto name_end = text.find('"', pos);
+        const auto ns_pos = text.find(ns_key, name_end);
+        if (name_end == std::string::npos || ns_pos == std::string::npos) break;
+
+        double ns = 0.0;
+        const char* first = text.data() + ns_pos + ns_key.size();
+        if (std::from_chars(first, text.data() + text.size(), ns).ec == std::errc{}) {
+            baseline[text.substr(pos, name_end - pos)] = ns;
+        }
+        pos = ns_pos;
+    }
+    return baseline;
+}
+
+// Prints the change against the baseline; returns the number of regressions past threshold
+int compare(const std::vector<bench::Result>& results,
+            const std::map<std::string, double>& baseline, double threshold_percent) {
+    int regressions = 0;
+    std::println("\n{:<48} {:>12} {:>12} {:>9}", "benchmark", "baseline", "current", "change");
+    for (const auto& r : results) {
+        const auto it = baseline.find(r.name);
+        if (it == baseline.end()) {
+            std::println("{:<48} {:>12} {:>12.1f} {:>9}", r.name, "-", r.ns_per_op, "new");
+            continue;
+        }
+        const double change = (r.ns_per_op - it->second) / it->second * 100.0;
+        const bool regressed = change > threshold_percent;
+        regressions += regressed ? 1 : 0;
+        std::println("{:<48} {:>12.1f} {:>12.1f} {:>+8.1f}%{}", r.name, it->second, r.ns_per_op,
+                     change, regressed ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
+
+void print_usage() {
+    std::println("usage: snake_benchmarks [--filter <substring>] [--min-time <ms>]\n"
+                 "                        [--json <out.json>] [--compare <baseline.json>]\n"
+                 "                        [--threshold <percent>]");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    std::string json_path;
+    std::string baseline_path;
+    double threshold = 10.0;
+    std::chrono::milliseconds min_time{500};
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            print_usage();
+            return arg == "--help" ? 0 : 2;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--filter") filter = value;
+        else if (arg == "--json") json_path = value;
+        else if (arg == "--compare") baseline_path = value;
+        else if (arg == "--threshold") threshold = std::stod(value);
+        else if (arg == "--min-time") min_time = std::chrono::milliseconds{std::stoi(value)};
+        else {
+            print_usage();
+            return 2;
+        }
+    }
+
+    bench::Registry registry;
+    bench::register_simulation_benchmarks(registry);
+    bench::register_renderer_benchmarks(registry);
+
+    const auto results = registry.run(filter, min_time);
+
+    if (!json_path.empty() && !write_json(json_path, results)) {
+        std::println(stderr, "[bench] Failed to write {}", json_path);
+        return 1;
+    }
+
+    if (!baseline_path.empty()) {
+        const auto baseline = read_json(baseline_path);
+        if (baseline.empty()) {
+            std::println(stderr, "[bench] No results in baseline {}", baseline_path);
+            return 1;
+        }
+        const int regressions = compare(results, baseline, threshold);
+        if (regressions > 0) {
+            std::println("\n{} benchmark(s) slower than baseline by more than {}%", regressions,
+                         threshold);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,22 @@
+# Generates a C++ source defining a byte array with the contents of a file.
+# Run in script mode at build time:
+#   cmake -DINPUT=<file> -DOUTPUT=<file.cpp> -DSYMBOL=<name> -P EmbedFile.cmake
+# The source defines `extern const unsigned char <SYMBOL>[]` and `extern const std::size_t
+# <SYMBOL>_size`.
+
+file(READ "${INPUT}" HEX_CONTENT HEX)
+string(LENGTH "${HEX_CONTENT}" HEX_LENGTH)
+math(EXPR BYTE_COUNT "${HEX_LENGTH} / 2")
+
+# Two hex digits per byte, 16 bytes per line (CMake regexes have no {n} repetition)
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BYTES "${HEX_CONTENT}")
+string(REPEAT "0x[0-9a-f][0-9a-f]," 16 LINE_PATTERN)
+string(REGEX REPLACE "(${LINE_PATTERN})" "\\1\n    " BYTES "${BYTES}")
+
+file(WRITE "${OUTPUT}"
+"// Generated by cmake/EmbedFile.cmake from ${INPUT}; do not edit\n"
+"#include <cstddef>\n\n"
+"extern const unsigned char ${SYMBOL}[];\n"
+"extern const std::size_t ${SYMBOL}_size;\n\n"
+"const unsigned char ${SYMBOL}[] = {\n    ${BYTES}\n};\n"
+"const std::size_t ${SYMBOL}_size = ${BYTE_COUNT};\n")
@@ -0,0 +1,30 @@
+// Replaces the global allocation functions to count calls in Metrics::allocations. Linked only
+// into the game; the array and nothrow forms forward to these, and the counter is sharded per
+// thread so allocating threads do not contend on one cache line.
+
+#include "Metrics.hpp"
+
+#include <cstdlib>
+#include <new>
+
+void* operator new(std::size_t size) {
+    Metrics::allocations.add();
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    Metrics::allocations.add();
+    const auto alignment = static_cast<std::size_t>(align);
+    // aligned_alloc needs the size to be a multiple of the alignment
+    const std::size_t rounded = (size + alignment - 1) / alignment * alignment;
+    if (void* p = std::aligned_alloc(alignment, rounded == 0 ? alignment : rounded)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t /*size*/) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t /*align*/) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t /*size*/, std::align_val_t /*align*/) noexcept {
+    std::free(p);
+}
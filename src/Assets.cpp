@@ -0,0 +1,20 @@
+#include "Assets.hpp"
+
+#include <cstddef>
+
+#ifdef SNAKE_EMBEDDED_ASSETS
+
+extern const unsigned char snake_embedded_font[];
+extern const std::size_t snake_embedded_font_size;
+
+std::span<const std::uint8_t> embedded_font() {
+    return {snake_embedded_font, snake_embedded_font_size};
+}
+
+#else
+
+std::span<const std::uint8_t> embedded_font() {
+    return {};
+}
+
+#endif
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+// Files compiled into the executable by the SNAKE_EMBED_ASSETS build option (see
+// cmake/EmbedFile.cmake); empty when the build loads them from assets/ at runtime instead
+std::span<const std::uint8_t> embedded_font();
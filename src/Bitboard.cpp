@@ -0,0 +1,218 @@
+#include "Bitboard.hpp"
+
+#include "Simulation.hpp"
+
+#include <utility>
+#include <variant>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Per width, every cell except the first or last column; the shifts in expand() wrap a row's
+// edge onto the next row and these clear the wrapped bits
+struct EdgeMasks {
+    std::array<std::uint64_t, Bitboard::word_count> not_first{};
+    std::array<std::uint64_t, Bitboard::word_count> not_last{};
+};
+
+constexpr auto edge_masks = [] {
+    std::array<EdgeMasks, Config::max_grid_size + 1> table{};
+    for (int width = 1; width <= Config::max_grid_size; ++width) {
+        EdgeMasks& masks = table[static_cast<std::size_t>(width)];
+        for (std::size_t i = 0; i < 64 * Bitboard::word_count; ++i) {
+            const auto column = static_cast<int>(i % static_cast<std::size_t>(width));
+            const std::uint64_t bit = std::uint64_t{1} << (i % 64);
+            if (column != 0) masks.not_first[i / 64] |= bit;
+            if (column != width - 1) masks.not_last[i / 64] |= bit;
+        }
+    }
+    return table;
+}();
+
+} // namespace
+
+Bitboard Bitboard::full(int width, int height) {
+    Bitboard board(width, height);
+    const auto cells = static_cast<std::size_t>(width * height);
+    for (std::size_t i = 0; i < cells / 64; ++i) board.word(i) = ~std::uint64_t{0};
+    if (cells % 64 != 0) board.word(cells / 64) = (std::uint64_t{1} << (cells % 64)) - 1;
+    return board;
+}
+
+Bitboard Bitboard::walls(const Level& level) {
+    Bitboard board(level.width, level.height);
+    for (std::size_t i = 0; i < level.walls.size(); ++i) board.word(i) = level.walls[i];
+    return board;
+}
+
+Bitboard Bitboard::from(const AnyOccupancy& occupancy) {
+    return std::visit(
+        [](const auto& occ) {
+            Bitboard board(occ.width(), occ.height());
+            for (std::size_t i = 0; i < occ.word_count(); ++i) board.word(i) = occ.words()[i];
+            return board;
+        },
+        occupancy);
+}
+
+Bitboard& Bitboard::operator&=(const Bitboard& other) {
+    for (std::size_t i = 0; i < bits_.size(); ++i) bits_[i] &= other.bits_[i];
+    return *this;
+}
+
+Bitboard& Bitboard::operator|=(const Bitboard& other) {
+    for (std::size_t i = 0; i < bits_.size(); ++i) bits_[i] |= other.bits_[i];
+    return *this;
+}
+
+Bitboard& Bitboard::subtract(const Bitboard& other) {
+    for (std::size_t i = 0; i < bits_.size(); ++i) bits_[i] &= ~other.bits_[i];
+    return *this;
+}
+
+#if defined(__AVX2__)
+
+Bitboard Bitboard::expand(const Bitboard& mask) const {
+    const EdgeMasks& edges = edge_masks[static_cast<std::size_t>(width_)];
+    const __m128i one = _mm_cvtsi32_si128(1);
+    const __m128i last_bit = _mm_cvtsi32_si128(63);
+    const __m128i row = _mm_cvtsi32_si128(width_);
+    const __m128i row_carry = _mm_cvtsi32_si128(64 - width_);
+    const auto load = [](const std::uint64_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); // NOLINT
+    };
+
+    Bitboard out(width_, height_);
+    // Four words per vector; the unaligned loads one word either side supply the bits that
+    // shift in from the neighbouring words
+    for (std::size_t k = 0; k < word_count; k += 4) {
+        const std::uint64_t* p = bits_.data() + 1 + k;
+        const __m256i cur = load(p);
+        const __m256i prev = load(p - 1);
+        const __m256i next = load(p + 1);
+        const __m256i east = _mm256_and_si256(
+            _mm256_or_si256(_mm256_sll_epi64(cur, one), _mm256_srl_epi64(prev, last_bit)),
+            load(edges.not_first.data() + k));
+        const __m256i west = _mm256_and_si256(
+            _mm256_or_si256(_mm256_srl_epi64(cur, one), _mm256_sll_epi64(next, last_bit)),
+            load(edges.not_last.data() + k));
+        const __m256i south =
+            _mm256_or_si256(_mm256_sll_epi64(cur, row), _mm256_srl_epi64(prev, row_carry));
+        const __m256i north =
+            _mm256_or_si256(_mm256_srl_epi64(cur, row), _mm256_sll_epi64(next, row_carry));
+        const __m256i grown = _mm256_or_si256(_mm256_or_si256(cur, east),
+                                              _mm256_or_si256(_mm256_or_si256(west, south), north));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.bits_.data() + 1 + k), // NOLINT
+                            _mm256_and_si256(grown, load(mask.bits_.data() + 1 + k)));
+    }
+    return out;
+}
+
+#else
+
+Bitboard Bitboard::expand(const Bitboard& mask) const {
+    const EdgeMasks& edges = edge_masks[static_cast<std::size_t>(width_)];
+    const int carry = 64 - width_;
+
+    Bitboard out(width_, height_);
+    for (std::size_t i = 1; i <= word_count; ++i) {
+        const std::uint64_t cur = bits_[i];
+        const std::uint64_t prev = bits_[i - 1];
+        const std::uint64_t next = bits_[i + 1];
+        const std::uint64_t east = ((cur << 1) | (prev >> 63)) & edges.not_first[i - 1];
+        const std::uint64_t west = ((cur >> 1) | (next << 63)) & edges.not_last[i - 1];
+        const std::uint64_t south = (cur << width_) | (prev >> carry);
+        const std::uint64_t north = (cur >> width_) | (next << carry);
+        out.bits_[i] = (cur | east | west | south | north) & mask.bits_[i];
+    }
+    return out;
+}
+
+#endif
+
+Bitboard flood_fill(Bitboard seed, const Bitboard& free, std::span<const Portal> portals,
+                    int stop_at) {
+    const bool stops_early = stop_at != std::numeric_limits<int>::max();
+    while (!stops_early || seed.count() < stop_at) {
+        Bitboard grown = seed.expand(free);
+        grown |= seed;
+        // Stepping onto either end of a portal lands on the other
+        for (const Portal& portal : portals) {
+            if (grown.test(portal.a()) && free.test(portal.b())) grown.set(portal.b());
+            if (grown.test(portal.b()) && free.test(portal.a())) grown.set(portal.a());
+        }
+        if (grown == seed) break;
+        seed = grown;
+    }
+    return seed;
+}
+
+BitboardState BitboardState::from(const Simulation& sim) {
+    const Snake& snake = sim.snake();
+    const Board& board = sim.board();
+    BitboardState state{
+        .body = Bitboard::from(snake.occupancy()),
+        .walls = Bitboard::walls(board.level()),
+        .food = Bitboard(board.width(), board.height()),
+        .board = Bitboard::full(board.width(), board.height()),
+        .level = board.level(),
+        .head = snake.head(),
+        .tail = snake.body().back(),
+        .direction = snake.direction(),
+        .growing = snake.is_growing(),
+        .length = static_cast<int>(snake.body().size()),
+    };
+    state.food.set(board.food_position());
+    return state;
+}
+
+Bitboard BitboardState::free() const {
+    Bitboard cells = board;
+    cells.subtract(walls);
+    cells.subtract(body);
+    return cells;
+}
+
+Bitboard BitboardState::open() const {
+    Bitboard cells = free();
+    if (!growing) cells.set(tail);
+    return cells;
+}
+
+sf::Vector2i BitboardState::food_cell() const {
+    sf::Vector2i cell;
+    food.for_each([&](sf::Vector2i p) { cell = p; });
+    return cell;
+}
+
+std::uint8_t BitboardState::legal_moves() const {
+    const Bitboard cells = open();
+    std::uint8_t moves = 0;
+    for (const Direction dir : {Direction::Up, Direction::Down, Direction::Left,
+                                Direction::Right}) {
+        if (is_opposite(dir, direction)) continue;
+        const sf::Vector2i next = level.portal_exit(head + direction_delta(dir));
+        const bool in_bounds =
+            next.x >= 0 && next.x < level.width && next.y >= 0 && next.y < level.height;
+        if (in_bounds && cells.test(next)) {
+            moves |= static_cast<std::uint8_t>(1U << std::to_underlying(dir));
+        }
+    }
+    return moves;
+}
+
+bool BitboardState::leaves_room(Direction dir) const {
+    if ((legal_moves() & (1U << std::to_underlying(dir))) == 0) return false;
+    const sf::Vector2i next = level.portal_exit(head + direction_delta(dir));
+
+    Bitboard cells = open();
+    cells.reset(next);
+    Bitboard start(level.width, level.height);
+    start.set(next);
+    // The fill counts the head's own cell, so one more than the length is needed
+    const int needed = length + (growing ? 1 : 0) + 1;
+    return flood_fill(start, cells, level.portals, needed).count() >= needed;
+}
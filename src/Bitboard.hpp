@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Config.hpp"
+#include "Direction.hpp"
+#include "Level.hpp"
+#include "Occupancy.hpp"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+class Simulation;
+
+// Grid cells as a bitset in Occupancy's layout (row-major, bit y * width + x in 64-bit words),
+// always sized for the largest grid so every operation is a fixed loop over the same words.
+// expand() moves a whole set one step in every direction with word shifts and edge masks, 64
+// cells per word, and uses AVX2 when the build enables it (SNAKE_AVX2).
+class Bitboard {
+public:
+    static constexpr std::size_t word_count = 16; // 1024 cells
+    static_assert(Config::max_grid_size * Config::max_grid_size <= 64 * word_count);
+
+    Bitboard() = default;
+    Bitboard(int width, int height) : width_(width), height_(height) {}
+
+    // Every cell of a width x height board
+    static Bitboard full(int width, int height);
+    static Bitboard walls(const Level& level);
+    static Bitboard from(const AnyOccupancy& occupancy);
+
+    [[nodiscard]] int width() const { return width_; }
+    [[nodiscard]] int height() const { return height_; }
+
+    // p must be in bounds
+    [[nodiscard]] bool test(sf::Vector2i p) const {
+        const auto i = index(p);
+        return ((word(i / 64) >> (i % 64)) & 1U) != 0;
+    }
+    void set(sf::Vector2i p) {
+        const auto i = index(p);
+        word(i / 64) |= std::uint64_t{1} << (i % 64);
+    }
+    void reset(sf::Vector2i p) {
+        const auto i = index(p);
+        word(i / 64) &= ~(std::uint64_t{1} << (i % 64));
+    }
+    [[nodiscard]] int count() const {
+        int n = 0;
+        for (const std::uint64_t w : words()) n += std::popcount(w);
+        return n;
+    }
+    [[nodiscard]] bool empty() const { return count() == 0; }
+
+    Bitboard& operator&=(const Bitboard& other);
+    Bitboard& operator|=(const Bitboard& other);
+    // Clears the cells set in other
+    Bitboard& subtract(const Bitboard& other);
+    friend Bitboard operator&(Bitboard a, const Bitboard& b) { return a &= b; }
+    friend Bitboard operator|(Bitboard a, const Bitboard& b) { return a |= b; }
+    friend bool operator==(const Bitboard& a, const Bitboard& b) = default;
+
+    // The set cells plus their four neighbours, limited to mask
+    [[nodiscard]] Bitboard expand(const Bitboard& mask) const;
+
+    // Calls f(sf::Vector2i) for every set cell in index order, e.g. to rebuild cell lists
+    template <typename F>
+    void for_each(F f) const {
+        for (std::size_t i = 0; i < word_count; ++i) {
+            for (std::uint64_t w = words()[i]; w != 0; w &= w - 1) {
+                const auto cell = static_cast<int>(i * 64) + std::countr_zero(w);
+                f(sf::Vector2i{cell % width_, cell / width_});
+            }
+        }
+    }
+
+    [[nodiscard]] std::span<const std::uint64_t, word_count> words() const {
+        return std::span<const std::uint64_t, word_count>(bits_.data() + 1, word_count);
+    }
+
+private:
+    [[nodiscard]] std::size_t index(sf::Vector2i p) const {
+        return static_cast<std::size_t>(p.y * width_ + p.x);
+    }
+    [[nodiscard]] std::uint64_t word(std::size_t i) const { return bits_[i + 1]; }
+    std::uint64_t& word(std::size_t i) { return bits_[i + 1]; }
+
+    // A zero word either side of the board lets shifts read neighbouring words without branches
+    std::array<std::uint64_t, word_count + 2> bits_{};
+    int width_ = 0;
+    int height_ = 0;
+};
+
+// Cells reachable from seed in steps through free (seed cells need not be free), crossing
+// portals. Stops early once at least stop_at cells are reached.
+[[nodiscard]] Bitboard flood_fill(Bitboard seed, const Bitboard& free,
+                                  std::span<const Portal> portals,
+                                  int stop_at = std::numeric_limits<int>::max());
+
+// A Simulation's position as bitboards, for lookahead that needs set operations rather than
+// the body's order. food_cell() and the Snake it came from map it back onto a Board and Snake;
+// a bitset has no head-to-tail order, so the body order itself stays with the Snake.
+struct BitboardState {
+    Bitboard body;
+    Bitboard walls;
+    Bitboard food;
+    Bitboard board; // every cell of the grid
+    Level level;    // for its portals
+    sf::Vector2i head;
+    sf::Vector2i tail;
+    Direction direction = Direction::Left;
+    bool growing = false;
+    int length = 0;
+
+    static BitboardState from(const Simulation& sim);
+
+    // Cells on the board that are neither wall nor body
+    [[nodiscard]] Bitboard free() const;
+    // free() plus the tail when it moves away this tick: the cells the head may enter
+    [[nodiscard]] Bitboard open() const;
+    [[nodiscard]] sf::Vector2i food_cell() const;
+    // Bit 1 << Direction for every move that does not end the game next tick, as is_safe_move
+    [[nodiscard]] std::uint8_t legal_moves() const;
+    // True when dir is legal and the head then still reaches at least as many free cells as the
+    // snake is long, so it cannot be boxed into a pocket smaller than itself
+    [[nodiscard]] bool leaves_room(Direction dir) const;
+};
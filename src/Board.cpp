@@ -1,46 +1,106 @@
 #include "Board.hpp"
 
-Board::Board(int grid_w, int grid_h)
-    : grid_w_(grid_w), grid_h_(grid_h), rng_(std::random_device{}()) {
-    food_ = {grid_w / 4, grid_h / 4};
+#include "Trace.hpp"
+#include "Zobrist.hpp"
+
+#include <variant>
+
+Board::Board(int grid_w, int grid_h) : Board(grid_w, grid_h, Rng::random_seed()) {}
+
+Board::Board(int grid_w, int grid_h, std::uint64_t seed)
+    : Board(Level::open_board(grid_w, grid_h), seed) {}
+
+Board::Board(const Level& level, std::uint64_t seed) : level_(level), rng_(seed) {
+    food_ = {level.width / 4, level.height / 4};
+    hash_ = Zobrist::food(food_);
+}
+
+void Board::set_food(sf::Vector2i pos) {
+    hash_ ^= Zobrist::food(food_) ^ Zobrist::food(pos);
+    food_ = pos;
+}
+
+void Board::set_bonus(std::optional<sf::Vector2i> pos) {
+    if (bonus_pos_) hash_ ^= Zobrist::bonus(*bonus_pos_);
+    if (pos) hash_ ^= Zobrist::bonus(*pos);
+    bonus_pos_ = pos;
+}
+
+std::optional<sf::Vector2i> Board::random_free_cell(const Snake& snake,
+                                                    std::optional<sf::Vector2i> exclude) {
+    return std::visit(
+        [&](const auto& occ) -> std::optional<sf::Vector2i> {
+            if (level_.walls.empty()) {
+                const bool excluded = exclude && occ.in_bounds(*exclude) && !occ.test(*exclude);
+                const int free = occ.cells() - occ.count() - (excluded ? 1 : 0);
+                if (free <= 0) return std::nullopt;
+                const auto n = static_cast<int>(rng_.below(static_cast<std::uint32_t>(free)));
+                return occ.nth_free(n, exclude);
+            }
+
+            // A few draws from the precomputed free-cell table settle it in O(1) unless the
+            // snake covers most of the level
+            const auto table = static_cast<std::uint32_t>(level_.free_cells.size());
+            for (int attempt = 0; attempt < 4; ++attempt) {
+                const std::uint16_t i = level_.free_cells[rng_.below(table)];
+                const sf::Vector2i cell{i % level_.width, i / level_.width};
+                if (!occ.test(cell) && cell != exclude) return cell;
+            }
+            // Otherwise the same masked scan as an open board, with the walls masked out too
+            const bool excluded = exclude && occ.in_bounds(*exclude) && !occ.test(*exclude) &&
+                                  !level_.is_wall(*exclude);
+            const int free =
+                occ.cells() - level_.wall_count() - occ.count() - (excluded ? 1 : 0);
+            if (free <= 0) return std::nullopt;
+            const auto n = static_cast<int>(rng_.below(static_cast<std::uint32_t>(free)));
+            return occ.nth_free(n, exclude, level_.walls.data());
+        },
+        snake.occupancy());
 }
 
 void Board::spawn_food(const Snake& snake) {
-    std::uniform_int_distribution<int> dist_x(0, grid_w_ - 1);
-    std::uniform_int_distribution<int> dist_y(0, grid_h_ - 1);
+    SNAKE_TRACE_ZONE("Board::spawn_food");
+    if (auto pos = random_free_cell(snake, bonus_pos_)) set_food(*pos);
+    if (field_) field_->reset(food_, snake);
+}
 
-    int attempts = grid_w_ * grid_h_;
-    do {
-        food_ = {dist_x(rng_), dist_y(rng_)};
-    } while ((snake.occupies(food_) || (bonus_pos_ && food_ == *bonus_pos_)) && --attempts > 0);
+void Board::enable_distance_field(const Snake& snake) {
+    if (!field_) field_.emplace(level_);
+    field_->reset(food_, snake);
 }
 
-void Board::spawn_bonus(const Snake& snake) {
-    std::uniform_int_distribution<int> dist_x(0, grid_w_ - 1);
-    std::uniform_int_distribution<int> dist_y(0, grid_h_ - 1);
+void Board::snake_moved(const Snake& snake) {
+    if (!field_) return;
+    // After growing the tail stays put and prev_tail() is the current tail
+    if (snake.prev_tail() != snake.body().back()) field_->unblock(snake.prev_tail());
+    field_->block(snake.head());
+}
 
-    sf::Vector2i pos;
-    int attempts = grid_w_ * grid_h_;
-    do {
-        pos = {dist_x(rng_), dist_y(rng_)};
-    } while ((snake.occupies(pos) || pos == food_) && --attempts > 0);
+void Board::rebuild_distance_field(const Snake& snake) {
+    if (field_) field_->reset(food_, snake);
+}
 
-    bonus_pos_ = pos;
-    bonus_timer_ = Config::bonus_duration;
+void Board::spawn_bonus(const Snake& snake) {
+    SNAKE_TRACE_ZONE("Board::spawn_bonus");
+    auto pos = random_free_cell(snake, food_);
+    if (!pos) return;
+
+    set_bonus(pos);
 }
 
-void Board::update_bonus(float dt) {
-    if (!bonus_pos_) return;
-    bonus_timer_ -= dt;
-    if (bonus_timer_ <= 0.f) { // NOLINT(readability-use-std-min-max)
-        bonus_pos_.reset();
-        bonus_timer_ = 0.f;
-    }
+bool Board::try_spawn_bonus(const Snake& snake) {
+    if (bonus_pos_ || rng_.unit() >= Config::bonus_spawn_chance) return false;
+    spawn_bonus(snake);
+    return true;
 }
 
-void Board::clear_bonus() {
-    bonus_pos_.reset();
-    bonus_timer_ = 0.f;
+void Board::clear_bonus() { set_bonus(std::nullopt); }
+
+void Board::restore(sf::Vector2i food, std::optional<sf::Vector2i> bonus,
+                    std::uint64_t rng_state) {
+    set_food(food);
+    set_bonus(bonus);
+    rng_.set_state(rng_state);
 }
 
 sf::Vector2f Board::grid_to_pixel(sf::Vector2i grid_pos, int cell_size) {
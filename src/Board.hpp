@@ -1,37 +1,71 @@
 #pragma once
 
 #include "Config.hpp"
+#include "DistanceField.hpp"
+#include "Level.hpp"
+#include "Rng.hpp"
 #include "Snake.hpp"
 
 #include <SFML/System/Vector2.hpp>
 
-#include <chrono>
+#include <cstdint>
 #include <optional>
-#include <random>
 
 class Board {
 public:
     Board(int grid_w, int grid_h);
+    Board(int grid_w, int grid_h, std::uint64_t seed);
+    // The level's views are kept, not copied, so its pack must outlive the board
+    Board(const Level& level, std::uint64_t seed);
 
     void spawn_food(const Snake& snake);
     void spawn_bonus(const Snake& snake);
-    void update_bonus(float dt);
+    bool try_spawn_bonus(const Snake& snake);
     void clear_bonus();
 
+    // Opt-in DistanceField towards the food, kept current by spawn_food() and snake_moved().
+    // Off by default so that copies made for search rollouts stay small.
+    void enable_distance_field(const Snake& snake);
+    // Applies the snake's last update() to the field, if enabled
+    void snake_moved(const Snake& snake);
+    // Recomputes the field, if enabled, after the snake or food were replaced wholesale
+    void rebuild_distance_field(const Snake& snake);
+
+    // Restores state captured from the accessors below (see Simulation::restore)
+    void restore(sf::Vector2i food, std::optional<sf::Vector2i> bonus, std::uint64_t rng_state);
+
     [[nodiscard]] sf::Vector2i food_position() const { return food_; }
     [[nodiscard]] std::optional<sf::Vector2i> bonus_position() const { return bonus_pos_; }
-    [[nodiscard]] float bonus_time_remaining() const { return bonus_timer_; }
+    [[nodiscard]] std::uint64_t rng_state() const { return rng_.state(); }
+    // Zobrist hash of the food and bonus positions, updated whenever either moves
+    [[nodiscard]] std::uint64_t hash() const { return hash_; }
 
-    [[nodiscard]] int width() const { return grid_w_; }
-    [[nodiscard]] int height() const { return grid_h_; }
+    [[nodiscard]] int width() const { return level_.width; }
+    [[nodiscard]] int height() const { return level_.height; }
+    [[nodiscard]] const Level& level() const { return level_; }
+    [[nodiscard]] const DistanceField* distance_field() const {
+        return field_ ? &*field_ : nullptr;
+    }
+    // Off the board or a wall; O(1) either way
+    [[nodiscard]] bool is_blocked(sf::Vector2i p) const {
+        return p.x < 0 || p.x >= level_.width || p.y < 0 || p.y >= level_.height ||
+               level_.is_wall(p);
+    }
 
     static sf::Vector2f grid_to_pixel(sf::Vector2i grid_pos, int cell_size);
 
 private:
-    int grid_w_;
-    int grid_h_;
+    // Uniformly chosen cell not covered by the snake, a wall or `exclude`; the snake must have
+    // been reset to this board's level
+    [[nodiscard]] std::optional<sf::Vector2i> random_free_cell(const Snake& snake,
+                                                               std::optional<sf::Vector2i> exclude);
+    void set_food(sf::Vector2i pos);
+    void set_bonus(std::optional<sf::Vector2i> pos);
+
+    Level level_;
     sf::Vector2i food_;
     std::optional<sf::Vector2i> bonus_pos_;
-    float bonus_timer_ = 0.f;
-    std::mt19937 rng_;
+    Rng rng_;
+    std::uint64_t hash_ = 0;
+    std::optional<DistanceField> field_;
 };
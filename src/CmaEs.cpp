@@ -0,0 +1,123 @@
+#include "CmaEs.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+#include <utility>
+
+SepCmaEs::SepCmaEs(std::vector<double> mean, double sigma, std::size_t population,
+                   std::uint64_t seed)
+    : mean_(std::move(mean)),
+      sigma_(sigma),
+      population_(population != 0 ? population : default_population(mean_.size())),
+      rng_(seed),
+      variance_(mean_.size(), 1.0),
+      path_sigma_(mean_.size(), 0.0),
+      path_c_(mean_.size(), 0.0),
+      candidates_(population_, std::vector<double>(mean_.size())),
+      steps_(population_, std::vector<double>(mean_.size())) {
+    const auto n = static_cast<double>(mean_.size());
+
+    const std::size_t parents = std::max<std::size_t>(1, population_ / 2);
+    weights_.resize(parents);
+    for (std::size_t i = 0; i < parents; ++i) {
+        weights_[i] = std::log(static_cast<double>(parents) + 0.5) -
+                      std::log(static_cast<double>(i) + 1.0);
+    }
+    const double sum = std::accumulate(weights_.begin(), weights_.end(), 0.0);
+    double squares = 0.0;
+    for (double& w : weights_) {
+        w /= sum;
+        squares += w * w;
+    }
+    mu_eff_ = 1.0 / squares;
+
+    c_sigma_ = (mu_eff_ + 2.0) / (n + mu_eff_ + 5.0);
+    d_sigma_ = 1.0 + 2.0 * std::max(0.0, std::sqrt((mu_eff_ - 1.0) / (n + 1.0)) - 1.0) + c_sigma_;
+    c_c_ = (4.0 + mu_eff_ / n) / (n + 4.0 + 2.0 * mu_eff_ / n);
+    // The full-covariance rates, raised as only n entries are learned rather than n^2
+    const double separable = (n + 2.0) / 3.0;
+    c_1_ = std::min(1.0, separable * 2.0 / ((n + 1.3) * (n + 1.3) + mu_eff_));
+    c_mu_ = std::min(1.0 - c_1_, separable * 2.0 * (mu_eff_ - 2.0 + 1.0 / mu_eff_) /
+                                     ((n + 2.0) * (n + 2.0) + mu_eff_));
+    chi_n_ = std::sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+}
+
+std::size_t SepCmaEs::default_population(std::size_t dimensions) {
+    return 4 + static_cast<std::size_t>(3.0 * std::log(static_cast<double>(dimensions)));
+}
+
+double SepCmaEs::normal() {
+    // Box-Muller, two values per pair of uniforms
+    if (has_spare_) {
+        has_spare_ = false;
+        return spare_normal_;
+    }
+    const double u = (static_cast<double>(rng_() >> 11) + 1.0) * 0x1p-53; // (0, 1]
+    const double v = static_cast<double>(rng_() >> 11) * 0x1p-53;
+    const double radius = std::sqrt(-2.0 * std::log(u));
+    const double angle = 2.0 * std::numbers::pi * v;
+    spare_normal_ = radius * std::sin(angle);
+    has_spare_ = true;
+    return radius * std::cos(angle);
+}
+
+const std::vector<std::vector<double>>& SepCmaEs::ask() {
+    for (std::size_t k = 0; k < population_; ++k) {
+        for (std::size_t i = 0; i < mean_.size(); ++i) {
+            steps_[k][i] = std::sqrt(variance_[i]) * normal();
+            candidates_[k][i] = mean_[i] + sigma_ * steps_[k][i];
+        }
+    }
+    return candidates_;
+}
+
+void SepCmaEs::tell(std::span<const double> fitness) {
+    const std::size_t count = std::min(fitness.size(), population_);
+    std::vector<std::size_t> order(count);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::ranges::stable_sort(order, [&](std::size_t a, std::size_t b) {
+        return fitness[a] > fitness[b];
+    });
+    if (count > 0 && fitness[order[0]] > best_fitness_) {
+        best_fitness_ = fitness[order[0]];
+        best_ = candidates_[order[0]];
+    }
+    ++generation_;
+
+    const std::size_t n = mean_.size();
+    const std::size_t parents = std::min(weights_.size(), count);
+    std::vector<double> step(n, 0.0); // weighted mean of the parents' steps
+    for (std::size_t p = 0; p < parents; ++p) {
+        for (std::size_t i = 0; i < n; ++i) step[i] += weights_[p] * steps_[order[p]][i];
+    }
+
+    const double sigma_rate = std::sqrt(c_sigma_ * (2.0 - c_sigma_) * mu_eff_);
+    double path_length = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        mean_[i] += sigma_ * step[i];
+        path_sigma_[i] = (1.0 - c_sigma_) * path_sigma_[i] +
+                         sigma_rate * step[i] / std::sqrt(variance_[i]);
+        path_length += path_sigma_[i] * path_sigma_[i];
+    }
+    path_length = std::sqrt(path_length);
+
+    // Stalls the covariance path while the step size path is still long from a big move
+    const double decay = std::pow(1.0 - c_sigma_, 2.0 * static_cast<double>(generation_));
+    const bool h_sigma = path_length / std::sqrt(1.0 - decay) <
+                         (1.4 + 2.0 / (static_cast<double>(n) + 1.0)) * chi_n_;
+    const double c_rate = std::sqrt(c_c_ * (2.0 - c_c_) * mu_eff_);
+    for (std::size_t i = 0; i < n; ++i) {
+        path_c_[i] = (1.0 - c_c_) * path_c_[i] + (h_sigma ? c_rate * step[i] : 0.0);
+        double rank_mu = 0.0;
+        for (std::size_t p = 0; p < parents; ++p) {
+            rank_mu += weights_[p] * steps_[order[p]][i] * steps_[order[p]][i];
+        }
+        const double rank_one = path_c_[i] * path_c_[i] +
+                                (h_sigma ? 0.0 : c_c_ * (2.0 - c_c_) * variance_[i]);
+        variance_[i] = (1.0 - c_1_ - c_mu_) * variance_[i] + c_1_ * rank_one + c_mu_ * rank_mu;
+    }
+
+    sigma_ *= std::exp(c_sigma_ / d_sigma_ * (path_length / chi_n_ - 1.0));
+}
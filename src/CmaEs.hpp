@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Rng.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+// Separable CMA-ES (Ros and Hansen, 2008): an evolution strategy that samples each generation
+// from a normal distribution around its mean, moves the mean towards the best candidates and
+// adapts a step size and one variance per dimension from the path the mean took. Keeping the
+// covariance diagonal makes a generation linear in the dimensions; it maximises fitness.
+//
+// The caller drives it: ask() for a generation, score every candidate in any order or in
+// parallel, then tell() the scores. Sampling uses Rng, so a seed gives the same search on
+// every platform.
+class SepCmaEs {
+public:
+    // population 0 picks the usual 4 + 3 ln(dimensions)
+    SepCmaEs(std::vector<double> mean, double sigma, std::size_t population, std::uint64_t seed);
+
+    static std::size_t default_population(std::size_t dimensions);
+
+    // Samples the next generation
+    [[nodiscard]] const std::vector<std::vector<double>>& ask();
+    // One fitness per candidate of the last ask(), in the same order
+    void tell(std::span<const double> fitness);
+
+    [[nodiscard]] const std::vector<double>& mean() const { return mean_; }
+    [[nodiscard]] double sigma() const { return sigma_; }
+    [[nodiscard]] std::size_t dimensions() const { return mean_.size(); }
+    [[nodiscard]] std::size_t population() const { return population_; }
+    [[nodiscard]] std::uint32_t generation() const { return generation_; }
+    // The fittest candidate told so far
+    [[nodiscard]] const std::vector<double>& best() const { return best_; }
+    [[nodiscard]] double best_fitness() const { return best_fitness_; }
+
+private:
+    double normal();
+
+    std::vector<double> mean_;
+    double sigma_;
+    std::size_t population_;
+    Rng rng_;
+
+    std::vector<double> weights_; // recombination weights of the best parents, summing to 1
+    double mu_eff_ = 0.0;
+    double c_sigma_ = 0.0;
+    double d_sigma_ = 0.0;
+    double c_c_ = 0.0;
+    double c_1_ = 0.0;
+    double c_mu_ = 0.0;
+    double chi_n_ = 0.0; // expected length of a standard normal vector
+
+    std::vector<double> variance_; // the covariance's diagonal
+    std::vector<double> path_sigma_;
+    std::vector<double> path_c_;
+    std::vector<std::vector<double>> candidates_;
+    std::vector<std::vector<double>> steps_; // (candidate - mean) / sigma
+
+    std::uint32_t generation_ = 0;
+    std::vector<double> best_;
+    double best_fitness_ = -std::numeric_limits<double>::infinity();
+    double spare_normal_ = 0.0;
+    bool has_spare_ = false;
+};
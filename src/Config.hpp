@@ -3,12 +3,14 @@
 #include <SFML/Graphics/Color.hpp>
 
 #include <chrono>
+#include <cstddef>
 
 struct Config {
     // Grid (defaults, overridden by Settings)
     static constexpr int grid_width = 20;
     static constexpr int grid_height = 20;
     static constexpr int cell_size = 32;
+    static constexpr int max_grid_size = 30; // largest preset, bounds Snapshot
 
     // Window
     static constexpr int window_width = grid_width * cell_size;
@@ -29,6 +31,9 @@ struct Config {
     static inline const sf::Color text_color{205, 214, 244};
     static inline const sf::Color overlay_bg{30, 30, 46, 200};
     static inline const sf::Color bonus_food_color{250, 200, 50};
+    static inline const sf::Color wall_color{88, 91, 112};
+    static inline const sf::Color portal_color{137, 180, 250};
+    static inline const sf::Color heatmap_color{250, 179, 135}; // alpha scales with visits
 
     // Bonus food
     static constexpr float bonus_spawn_chance = 0.3f;
@@ -36,9 +41,50 @@ struct Config {
     static constexpr int bonus_points = 5;
 
     // Screen shake
-    static constexpr float shake_duration = 0.3f;
+    static constexpr auto shake_duration = std::chrono::milliseconds{300};
     static constexpr float shake_intensity = 6.0f;
 
+    // Particles (pixels and seconds)
+    static constexpr std::size_t max_particles = 100'000;
+    static constexpr float particle_drag = 3.0f;      // velocity decay rate per second
+    static constexpr float particle_gravity = 240.0f; // downward acceleration
+    static constexpr float particle_size = 6.0f;
+    static constexpr float particle_speed = 220.0f;
+    static constexpr float particle_lifetime = 0.7f;
+    static constexpr std::size_t food_burst = 40;
+    static constexpr std::size_t bonus_burst = 120;
+    static constexpr std::size_t death_burst_per_cell = 12;
+
+    // Rewind (bounded by both duration and memory)
+    static constexpr int rewind_seconds = 30;
+    static constexpr std::size_t rewind_buffer_bytes = 512 * 1024;
+
+    // Autopilot (Monte Carlo tree search)
+    static constexpr int mcts_rollout_depth = 40;
+    static constexpr float mcts_exploration = 0.7f;
+    static constexpr float mcts_think_fraction = 0.8f; // share of a tick spent searching
+
+    // External autopilot engines (--engine); each move's budget is mcts_think_fraction of a tick
+    static constexpr std::chrono::milliseconds engine_handshake_timeout{2000};
+
+    // Persistent files, written in the background by Game's AsyncFileWriter
+    static constexpr const char* replay_path = "replay.bin"; // last finished game
+    static constexpr const char* leaderboard_path = "leaderboard.bin";
+    static constexpr const char* legacy_highscore_path = "highscore.txt"; // imported once
+
+    // Level pack built from levels/*.txt by snake_levelpack; CMake points this at the build tree
+#ifdef SNAKE_LEVEL_PACK_PATH
+    static constexpr const char* level_pack_path = SNAKE_LEVEL_PACK_PATH;
+#else
+    static constexpr const char* level_pack_path = "levels.pack";
+#endif
+
+    // POSIX shared-memory name of the live state feed enabled by --spectate
+    static constexpr const char* spectator_feed = "/snake-spectator";
+
+    // Chrome trace-event output when built with SNAKE_TRACING (F9 or exit)
+    static constexpr const char* trace_path = "trace.json";
+
     // Font
     static constexpr const char* font_path = "assets/fonts/JetBrainsMono-Regular.ttf";
 };
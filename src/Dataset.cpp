@@ -0,0 +1,785 @@
+#include "Dataset.hpp"
+
+#include "Log.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <format>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+
+static_assert(std::endian::native == std::endian::little,
+              "datasets are read in place and stored little-endian");
+
+// File layout, little-endian, every part a multiple of 8 bytes so columns are word-aligned:
+//   header   "SNKD", u16 version, u16 reserved, char[24] level name (NUL-padded)
+//   chunks   "SNKC", u32 steps, u32 keyframes, u32 body runs, u32 events, u32 chunk bytes
+//            including this header, then each column in DatasetColumn order:
+//            u64 base, u64 bits, packed_words(values, bits) u64 words holding value - base at
+//            bit i * bits
+//
+// Only the action is stored for every step. The rest of a step's state is predicted from the
+// step before: one more tick, the score plus the reward, the heading the action turned to, the
+// head one cell along it, after a growing step one more body cell and the growing over, and
+// everything else unchanged. An event records each field that differs from its prediction,
+// e.g. new food or a portal jump. A keyframe holds the whole state, body included, at the
+// start of every chunk and game and every DatasetBuffer::keyframe_interval steps, so a read
+// replays at most that many steps.
+
+namespace {
+
+enum class DatasetColumn : std::uint8_t {
+    // One value per step
+    Action,
+    // One value per keyframe
+    KeyStep, // index of the keyframe's step in the chunk
+    GameLow, // the 64-bit game id in halves, so consecutive seeds share a constant high half
+    GameHigh,
+    Tick,
+    Score,
+    GridW,
+    GridH,
+    Direction,
+    Flags,
+    FoodX,
+    FoodY,
+    BonusX,
+    BonusY,
+    BonusExpiry,
+    HeadX,
+    HeadY,
+    RunCount,
+    // One value per straight run of a keyframe's body (see RunLengthBody), head to tail
+    RunDir,
+    RunLength,
+    RunDx, // this run's first cell minus the one the previous run came from (or the head):
+    RunDy, // 0 unless a portal lies between them
+    // One value per event, in step order
+    EventStep,
+    EventField, // DatasetEvent
+    EventValue,
+};
+
+// Fields an event can set. Cells are packed as x | y << 8, a bonus also with 1 << 16.
+enum class DatasetEvent : std::uint8_t {
+    Direction,
+    Flags,
+    Food,
+    Bonus, // 0 when it disappears
+    BonusExpiry,
+    Head,
+    Length,
+    Score,
+    // The step's outcome rather than its state
+    Reward,
+    Done,
+};
+
+// Each column counts one of these
+enum class DatasetTable : std::uint8_t { Steps, Keys, Runs, Events };
+
+constexpr std::array<char, 4> file_magic = {'S', 'N', 'K', 'D'};
+constexpr std::array<char, 4> chunk_magic = {'S', 'N', 'K', 'C'};
+constexpr std::uint16_t format_version = 2; // 2 replaced per-step state with keyframes and events
+constexpr std::size_t header_size = 32;
+constexpr std::size_t name_size = 24;
+constexpr std::size_t chunk_header_size = 24;
+constexpr std::size_t column_header_size = 16;
+constexpr std::size_t column_count = static_cast<std::size_t>(DatasetColumn::EventValue) + 1;
+constexpr std::size_t table_count = 4;
+// Chunks handed over but not yet written; recording threads wait beyond this
+constexpr std::size_t max_queued_chunks = 16;
+
+// direction_delta as a table: run directions are too irregular for its branches to predict
+constexpr std::array<sf::Vector2i, 4> run_deltas = {
+    direction_delta(Direction::Up), direction_delta(Direction::Down),
+    direction_delta(Direction::Left), direction_delta(Direction::Right)};
+
+constexpr std::size_t index(DatasetColumn column) { return static_cast<std::size_t>(column); }
+constexpr std::size_t index(DatasetTable table) { return static_cast<std::size_t>(table); }
+
+constexpr DatasetTable table_of(DatasetColumn column) {
+    if (column < DatasetColumn::KeyStep) return DatasetTable::Steps;
+    if (column < DatasetColumn::RunDir) return DatasetTable::Keys;
+    if (column < DatasetColumn::EventStep) return DatasetTable::Runs;
+    return DatasetTable::Events;
+}
+
+constexpr DatasetColumn first_column(DatasetTable table) {
+    constexpr std::array<DatasetColumn, table_count> firsts = {
+        DatasetColumn::Action, DatasetColumn::KeyStep, DatasetColumn::RunDir,
+        DatasetColumn::EventStep};
+    return firsts[index(table)];
+}
+
+constexpr std::int32_t pack_cell(sf::Vector2i cell) { return cell.x | cell.y << 8; }
+
+constexpr std::int32_t pack_bonus(std::optional<sf::Vector2i> bonus) {
+    return bonus ? pack_cell(*bonus) | 1 << 16 : 0;
+}
+
+// One spare word so a value straddling the last word boundary reads two words
+constexpr std::size_t packed_words(std::size_t values, unsigned bits) {
+    return (values * bits + 63) / 64 + 1;
+}
+
+// Appends values frame-of-reference packed. The words are copied out as they are in memory,
+// which is their file layout on a little-endian machine.
+void pack_column(Bytes& out, std::span<const std::int32_t> values) {
+    std::int64_t min = 0;
+    unsigned bits = 0;
+    if (!values.empty()) {
+        const auto [lo, hi] = std::ranges::minmax(values);
+        min = lo;
+        bits = static_cast<unsigned>(std::bit_width(static_cast<std::uint64_t>(hi - min)));
+    }
+    put_le(out, static_cast<std::uint64_t>(min));
+    put_le(out, static_cast<std::uint64_t>(bits));
+
+    const std::size_t begin = out.size();
+    out.resize(begin + 8 * packed_words(values.size(), bits), 0);
+    if (bits == 0) return;
+    std::uint8_t* words = out.data() + begin;
+    std::uint64_t word = 0;
+    unsigned used = 0;
+    for (const std::int32_t value : values) {
+        const auto offset = static_cast<std::uint64_t>(value - min);
+        word |= offset << used;
+        used += bits;
+        if (used >= 64) { // bits is at most 32, so nothing is shifted out entirely
+            std::memcpy(words, &word, 8);
+            words += 8;
+            used -= 64;
+            word = used == 0 ? 0 : offset >> (bits - used);
+        }
+    }
+    if (used > 0) std::memcpy(words, &word, 8);
+}
+
+std::uint8_t flags_of(const Simulation& sim) {
+    std::uint8_t flags = 0;
+    if (sim.board().bonus_position()) flags |= Snapshot::HasBonus;
+    if (sim.snake().is_growing()) flags |= Snapshot::ShouldGrow;
+    if (sim.is_over()) flags |= Snapshot::Over;
+    return flags;
+}
+
+std::uint32_t bonus_expiry(const Simulation& sim) {
+    return sim.board().bonus_position() ? sim.tick() + sim.bonus_ticks_remaining() : 0;
+}
+
+} // namespace
+
+// One chunk being filled, by index so recording is plain stores: the step table holds a full
+// chunk, and the keyframe, run and event tables grow when they would overflow. The step count
+// is DatasetBuffer's until it hands the chunk over.
+struct DatasetColumns {
+    std::array<std::vector<std::int32_t>, column_count> values;
+    std::array<std::size_t, table_count> counts{};
+
+    DatasetColumns() {
+        for (std::size_t c = 0; c < column_count; ++c) {
+            const bool steps = table_of(static_cast<DatasetColumn>(c)) == DatasetTable::Steps;
+            values[c].resize(steps ? DatasetBuffer::chunk_steps : DatasetBuffer::chunk_steps / 32);
+        }
+    }
+
+    [[nodiscard]] std::size_t steps() const { return counts[index(DatasetTable::Steps)]; }
+    [[nodiscard]] std::size_t count(DatasetTable table) const { return counts[index(table)]; }
+
+    // Makes room for count more rows of table, doubling rather than growing by a few
+    void reserve(DatasetTable table, std::size_t count) {
+        const std::size_t needed = counts[index(table)] + count;
+        // Columns of a table share their size, so the first one tells
+        if (values[index(first_column(table))].size() >= needed) return;
+        for (std::size_t c = 0; c < column_count; ++c) {
+            if (table_of(static_cast<DatasetColumn>(c)) != table) continue;
+            values[c].resize(std::max(needed, 2 * values[c].size()));
+        }
+    }
+
+    void event(std::size_t step, DatasetEvent field, std::int32_t value) {
+        using enum DatasetColumn;
+        reserve(DatasetTable::Events, 1);
+        const std::size_t row = counts[index(DatasetTable::Events)]++;
+        values[index(EventStep)][row] = static_cast<std::int32_t>(step);
+        values[index(EventField)][row] = static_cast<std::int32_t>(field);
+        values[index(EventValue)][row] = value;
+    }
+
+    [[nodiscard]] std::span<const std::int32_t> column(std::size_t c) const {
+        return std::span(values[c]).first(count(table_of(static_cast<DatasetColumn>(c))));
+    }
+    void clear() { counts = {}; }
+};
+
+struct DatasetWriter::Worker {
+    std::string path;
+    std::FILE* file;
+    std::mutex mutex;
+    std::condition_variable_any wake;
+    std::condition_variable_any drained;
+    std::deque<std::unique_ptr<DatasetColumns>> queue;
+    std::vector<std::unique_ptr<DatasetColumns>> spare; // written, cleared for reuse
+    bool busy = false;
+    std::uint64_t steps = 0;
+    std::uint64_t bytes = header_size;
+    Bytes packed;
+    std::jthread thread{[this](const std::stop_token& stop) { run(stop); }};
+
+    Worker(std::string path, std::FILE* file) : path(std::move(path)), file(file) {}
+
+    // Drains the queue before closing the file
+    ~Worker() {
+        thread.request_stop();
+        thread.join();
+        std::fclose(file);
+    }
+
+    Worker(const Worker&) = delete;
+    Worker& operator=(const Worker&) = delete;
+
+    void run(const std::stop_token& stop) {
+        Trace::set_thread_name("dataset");
+        std::unique_lock lock(mutex);
+        for (;;) {
+            wake.wait(lock, stop, [this] { return !queue.empty(); });
+            if (queue.empty()) return; // stop requested with nothing left to write
+
+            auto columns = std::move(queue.front());
+            queue.pop_front();
+            busy = true;
+            lock.unlock();
+            encode(*columns);
+            const bool ok = std::fwrite(packed.data(), 1, packed.size(), file) == packed.size() &&
+                            std::fflush(file) == 0;
+            if (!ok) Log::error("Failed to write training data to {}", path);
+            const std::size_t written = columns->steps();
+            columns->clear();
+            lock.lock();
+            if (ok) {
+                steps += written;
+                bytes += packed.size();
+            }
+            spare.push_back(std::move(columns));
+            busy = false;
+            drained.notify_all();
+        }
+    }
+
+    void encode(const DatasetColumns& columns) {
+        SNAKE_TRACE_ZONE("DatasetWriter::encode");
+        packed.clear();
+        packed.insert(packed.end(), chunk_magic.begin(), chunk_magic.end());
+        for (const std::size_t count : columns.counts) {
+            put_le(packed, static_cast<std::uint32_t>(count));
+        }
+        put_le(packed, std::uint32_t{0}); // chunk size, filled in below
+        for (std::size_t c = 0; c < column_count; ++c) pack_column(packed, columns.column(c));
+        const auto size = static_cast<std::uint32_t>(packed.size());
+        for (std::size_t i = 0; i < 4; ++i) {
+            packed[20 + i] = static_cast<std::uint8_t>(size >> (8 * i));
+        }
+    }
+
+    // Queues columns and replaces them with cleared ones
+    void submit(std::unique_ptr<DatasetColumns>& columns) {
+        {
+            std::unique_lock lock(mutex);
+            drained.wait(lock, [this] { return queue.size() < max_queued_chunks; });
+            queue.push_back(std::move(columns));
+            if (!spare.empty()) {
+                columns = std::move(spare.back());
+                spare.pop_back();
+            }
+        }
+        wake.notify_one();
+        if (!columns) columns = std::make_unique<DatasetColumns>();
+    }
+};
+
+std::expected<DatasetWriter, std::string> DatasetWriter::create(const std::string& path,
+                                                                std::string_view level) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) return std::unexpected("Cannot create dataset " + path);
+
+    Bytes header(file_magic.begin(), file_magic.end());
+    put_le(header, format_version);
+    put_le(header, std::uint16_t{0});
+    const std::string_view name = level.substr(0, name_size - 1);
+    header.insert(header.end(), name.begin(), name.end());
+    header.resize(header_size, 0);
+    if (std::fwrite(header.data(), 1, header.size(), file) != header.size() ||
+        std::fflush(file) != 0) {
+        std::fclose(file);
+        return std::unexpected("Cannot write dataset " + path);
+    }
+    return DatasetWriter(std::make_unique<Worker>(path, file));
+}
+
+DatasetWriter::DatasetWriter(std::unique_ptr<Worker> worker) : worker_(std::move(worker)) {}
+DatasetWriter::DatasetWriter(DatasetWriter&&) noexcept = default;
+DatasetWriter& DatasetWriter::operator=(DatasetWriter&&) noexcept = default;
+DatasetWriter::~DatasetWriter() = default;
+
+DatasetBuffer DatasetWriter::buffer() {
+    std::unique_ptr<DatasetColumns> columns;
+    {
+        const std::scoped_lock lock(worker_->mutex);
+        if (!worker_->spare.empty()) {
+            columns = std::move(worker_->spare.back());
+            worker_->spare.pop_back();
+        }
+    }
+    if (!columns) columns = std::make_unique<DatasetColumns>();
+    return {worker_.get(), std::move(columns)};
+}
+
+void DatasetWriter::flush() {
+    std::unique_lock lock(worker_->mutex);
+    worker_->drained.wait(lock, [this] { return worker_->queue.empty() && !worker_->busy; });
+}
+
+std::uint64_t DatasetWriter::steps_written() const {
+    const std::scoped_lock lock(worker_->mutex);
+    return worker_->steps;
+}
+
+std::uint64_t DatasetWriter::bytes_written() const {
+    const std::scoped_lock lock(worker_->mutex);
+    return worker_->bytes;
+}
+
+DatasetBuffer::DatasetBuffer(DatasetWriter::Worker* worker,
+                             std::unique_ptr<DatasetColumns> columns)
+    : worker_(worker), columns_(std::move(columns)) {
+    reset();
+}
+
+DatasetBuffer::DatasetBuffer(DatasetBuffer&& other) noexcept
+    : worker_(std::exchange(other.worker_, nullptr)),
+      columns_(std::move(other.columns_)),
+      actions_(std::exchange(other.actions_, nullptr)),
+      steps_(std::exchange(other.steps_, 0)),
+      last_(other.last_),
+      quiet_(std::exchange(other.quiet_, false)) {}
+
+DatasetBuffer& DatasetBuffer::operator=(DatasetBuffer&& other) noexcept {
+    if (this != &other) {
+        std::swap(worker_, other.worker_);
+        std::swap(columns_, other.columns_);
+        std::swap(actions_, other.actions_);
+        std::swap(steps_, other.steps_);
+        std::swap(last_, other.last_);
+        std::swap(quiet_, other.quiet_);
+    }
+    return *this;
+}
+
+DatasetBuffer::~DatasetBuffer() { submit(); }
+
+DatasetBuffer::State DatasetBuffer::state_of(const Simulation& sim) {
+    const Board& board = sim.board();
+    const Snake& snake = sim.snake();
+    return {.score = sim.score(),
+            .direction = snake.direction(),
+            .flags = flags_of(sim),
+            .food = pack_cell(board.food_position()),
+            .bonus = pack_bonus(board.bonus_position()),
+            .head = snake.head(),
+            .length = snake.body().size()};
+}
+
+void DatasetBuffer::begin_step_slow(const Simulation& sim, Direction action) {
+    DatasetColumns& c = *columns_;
+    actions_[steps_] = static_cast<std::int32_t>(action);
+
+    // Anything but the next tick of the same game starts over from a full state
+    if (steps_ == 0 || steps_ - last_.key_step >= keyframe_interval ||
+        sim.seed() != last_.game || sim.tick() != last_.tick + 1) {
+        keyframe(sim);
+    } else {
+        // One more tick along the heading the action turned to, and after a growing step one
+        // more cell with the growing over
+        State predicted = last_.state;
+        if (!is_opposite(last_.action, predicted.direction)) predicted.direction = last_.action;
+        predicted.head += run_deltas[static_cast<std::size_t>(predicted.direction)];
+        if ((predicted.flags & Snapshot::ShouldGrow) != 0) {
+            ++predicted.length;
+            predicted.flags &= static_cast<std::uint8_t>(~Snapshot::ShouldGrow);
+        }
+
+        // An event for each field that differs from its prediction
+        const State actual = state_of(sim);
+        const auto event = [&](DatasetEvent field, auto value) {
+            c.event(steps_, field, static_cast<std::int32_t>(value));
+        };
+        using enum DatasetEvent;
+        if (actual.direction != predicted.direction) event(Direction, actual.direction);
+        if (actual.length != predicted.length) event(Length, actual.length);
+        if (actual.score != predicted.score) event(Score, actual.score);
+        if (actual.flags != predicted.flags) event(Flags, actual.flags);
+        if (actual.food != predicted.food) event(Food, actual.food);
+        // A bonus only spawns where there was none, so its expiry changes only along with it
+        if (actual.bonus != predicted.bonus) {
+            event(Bonus, actual.bonus);
+            if (const std::uint32_t expiry = bonus_expiry(sim); expiry != last_.bonus_expiry) {
+                event(BonusExpiry, expiry);
+                last_.bonus_expiry = expiry;
+            }
+        }
+        if (actual.head != predicted.head) event(Head, pack_cell(actual.head));
+        last_.tick = sim.tick();
+        last_.state = actual;
+    }
+    last_.action = action;
+    // Nothing but the head moves on the next step unless end_step() sees an event
+    quiet_ = (last_.state.flags & Snapshot::ShouldGrow) == 0;
+}
+
+void DatasetBuffer::end_step_slow(const Simulation& sim) {
+    DatasetColumns& c = *columns_;
+    if (const std::int32_t reward = sim.score() - last_.state.score; reward != 0) {
+        c.event(steps_, DatasetEvent::Reward, reward);
+    }
+    if (sim.is_over()) c.event(steps_, DatasetEvent::Done, 1);
+    last_.state.score = sim.score();
+    quiet_ = false;
+}
+
+void DatasetBuffer::keyframe(const Simulation& sim) {
+    DatasetColumns& c = *columns_;
+    const Board& board = sim.board();
+    const Snake& snake = sim.snake();
+    const auto& runs = snake.body().runs();
+    const auto as_i32 = [](auto value) { return static_cast<std::int32_t>(value); };
+
+    last_ = Recorded{.game = sim.seed(),
+                     .tick = sim.tick(),
+                     .action = last_.action,
+                     .bonus_expiry = bonus_expiry(sim),
+                     .key_step = steps_,
+                     .state = state_of(sim)};
+
+    using enum DatasetColumn;
+    c.reserve(DatasetTable::Keys, 1);
+    const std::size_t key = c.counts[index(DatasetTable::Keys)]++;
+    const auto set = [&](DatasetColumn column, std::int32_t value) {
+        c.values[index(column)][key] = value;
+    };
+    const auto bonus = board.bonus_position();
+    set(KeyStep, as_i32(steps_));
+    set(GameLow, as_i32(static_cast<std::uint32_t>(sim.seed())));
+    set(GameHigh, as_i32(static_cast<std::uint32_t>(sim.seed() >> 32)));
+    set(Tick, as_i32(sim.tick()));
+    set(Score, sim.score());
+    set(GridW, board.width());
+    set(GridH, board.height());
+    set(Direction, as_i32(snake.direction()));
+    set(Flags, last_.state.flags);
+    set(FoodX, board.food_position().x);
+    set(FoodY, board.food_position().y);
+    set(BonusX, bonus ? bonus->x : 0);
+    set(BonusY, bonus ? bonus->y : 0);
+    set(BonusExpiry, as_i32(last_.bonus_expiry));
+    set(HeadX, snake.head().x);
+    set(HeadY, snake.head().y);
+    set(RunCount, as_i32(runs.size()));
+
+    // Where the previous run came from, so the next run's start when no portal intervenes
+    c.reserve(DatasetTable::Runs, runs.size());
+    const std::size_t first = c.counts[index(DatasetTable::Runs)];
+    std::int32_t* dirs = c.values[index(RunDir)].data() + first;
+    std::int32_t* lengths = c.values[index(RunLength)].data() + first;
+    std::int32_t* dxs = c.values[index(RunDx)].data() + first;
+    std::int32_t* dys = c.values[index(RunDy)].data() + first;
+    sf::Vector2i next = snake.head();
+    for (const RunLengthBody::Run& run : runs) {
+        *dirs++ = as_i32(run.dir);
+        *lengths++ = run.length;
+        *dxs++ = run.start.x - next.x;
+        *dys++ = run.start.y - next.y;
+        const sf::Vector2i delta = run_deltas[static_cast<std::size_t>(run.dir)];
+        next = run.start - delta * run.length;
+    }
+    c.counts[index(DatasetTable::Runs)] += runs.size();
+}
+
+void DatasetBuffer::reset() {
+    actions_ = columns_->values[index(DatasetColumn::Action)].data();
+    steps_ = 0;
+    quiet_ = false; // the next step is a keyframe
+}
+
+void DatasetBuffer::submit() {
+    if (worker_ == nullptr || !columns_ || steps_ == 0) return;
+    columns_->counts[index(DatasetTable::Steps)] = steps_;
+    worker_->submit(columns_);
+    reset();
+}
+
+std::uint64_t DatasetReader::Column::get(std::size_t i) const {
+    if (bits == 0) return base;
+    const std::size_t pos = i * bits;
+    const auto shift = static_cast<unsigned>(pos % 64);
+    std::uint64_t value = words[pos / 64] >> shift;
+    if (shift + bits > 64) value |= words[pos / 64 + 1] << (64 - shift);
+    if (bits < 64) value &= (std::uint64_t{1} << bits) - 1;
+    return base + value;
+}
+
+std::expected<DatasetReader, std::string> DatasetReader::open(const std::string& path) {
+    SNAKE_TRACE_ZONE("DatasetReader::open");
+    static_assert(DatasetReader::column_count == ::column_count);
+    auto file = MappedFile::open(path);
+    if (!file) return std::unexpected("Cannot open dataset " + path);
+    const auto bytes = file->bytes(); // stays valid when file moves into the reader
+
+    ByteReader in(bytes);
+    std::array<char, 4> magic{};
+    std::uint16_t version = 0;
+    std::uint16_t reserved = 0;
+    std::array<char, name_size> name{};
+    if (!in.get(magic) || magic != file_magic || !in.get(version) || version != format_version ||
+        !in.get(reserved) || !in.get(name)) {
+        return std::unexpected("Invalid dataset " + path);
+    }
+
+    DatasetReader reader(std::move(*file));
+    reader.level_.assign(name.data(), std::ranges::find(name, '\0') - name.begin());
+
+    // A chunk that does not fit is the partial tail of an interrupted write, and ends the file
+    std::size_t offset = header_size;
+    while (bytes.size() - offset >= chunk_header_size) {
+        ByteReader chunk_in(bytes.subspan(offset));
+        Chunk chunk;
+        std::uint32_t size = 0;
+        chunk_in.get(magic);
+        for (std::uint32_t& count : chunk.counts) chunk_in.get(count);
+        chunk_in.get(size);
+        if (magic != chunk_magic || size < chunk_header_size || size % 8 != 0 ||
+            size > bytes.size() - offset) {
+            break;
+        }
+
+        std::size_t pos = offset + chunk_header_size;
+        const std::size_t end = offset + size;
+        bool valid = true;
+        for (std::size_t c = 0; c < column_count && valid; ++c) {
+            const std::size_t values = chunk.counts[index(table_of(static_cast<DatasetColumn>(c)))];
+            ByteReader column_in(bytes.subspan(pos, std::min(end - pos, column_header_size)));
+            std::uint64_t base = 0;
+            std::uint64_t bits = 0;
+            valid = column_in.get(base) && column_in.get(bits) && bits <= 64;
+            const std::size_t words = valid ? packed_words(values, static_cast<unsigned>(bits)) : 0;
+            valid = valid && (end - pos - column_header_size) / 8 >= words;
+            if (!valid) break;
+            chunk.columns[c] = Column{
+                .words = reinterpret_cast<const std::uint64_t*>(bytes.data() + pos +
+                                                               column_header_size),
+                .base = base,
+                .bits = static_cast<unsigned>(bits)};
+            pos += column_header_size + 8 * words;
+        }
+        if (!valid || pos != end) break;
+
+        // Every step needs a keyframe at or before it, and the keyframes' runs must add up
+        const std::size_t keys = chunk.counts[index(DatasetTable::Keys)];
+        const std::size_t steps = chunk.counts[index(DatasetTable::Steps)];
+        if (steps > 0 && (keys == 0 || chunk.columns[index(DatasetColumn::KeyStep)].get(0) != 0)) {
+            break;
+        }
+        std::uint64_t runs = 0;
+        chunk.run_starts.reserve(keys);
+        for (std::size_t key = 0; key < keys; ++key) {
+            chunk.run_starts.push_back(static_cast<std::uint32_t>(runs));
+            runs += chunk.columns[index(DatasetColumn::RunCount)].get(key);
+            if (runs > chunk.counts[index(DatasetTable::Runs)]) break;
+        }
+        if (runs != chunk.counts[index(DatasetTable::Runs)]) break;
+
+        reader.chunk_starts_.push_back(reader.size_);
+        reader.chunks_.push_back(std::move(chunk));
+        reader.size_ += steps;
+        offset = end;
+    }
+    return reader;
+}
+
+bool DatasetReader::read(std::uint64_t step, Transition& out) const {
+    if (step >= size_) return false;
+    const auto found = std::ranges::upper_bound(chunk_starts_, step) - 1;
+    const Chunk& chunk = chunks_[static_cast<std::size_t>(found - chunk_starts_.begin())];
+    const auto i = static_cast<std::size_t>(step - *found);
+    const auto get = [&](DatasetColumn column, std::size_t row) {
+        return static_cast<std::int64_t>(chunk.columns[index(column)].get(row));
+    };
+    using enum DatasetColumn;
+
+    // The last keyframe at or before the step; open() made sure the first is at step 0
+    std::size_t key = 0;
+    for (std::size_t count = chunk.counts[index(DatasetTable::Keys)]; count > 1;) {
+        const std::size_t half = count / 2;
+        if (static_cast<std::size_t>(get(KeyStep, key + half)) <= i) key += half;
+        count -= half;
+    }
+    const auto key_step = static_cast<std::size_t>(get(KeyStep, key));
+    const std::int64_t w = get(GridW, key);
+    const std::int64_t h = get(GridH, key);
+    const std::int64_t run_count = get(RunCount, key);
+    std::int64_t dir = get(Direction, key);
+    if (key_step > i || i - key_step >= DatasetBuffer::keyframe_interval || w < 1 ||
+        w > Config::max_grid_size || h < 1 || h > Config::max_grid_size || run_count < 1 ||
+        dir < 0 || dir > 3) {
+        return false;
+    }
+
+    const auto in_grid = [&](std::int64_t x, std::int64_t y) {
+        return x >= 0 && x < w && y >= 0 && y < h;
+    };
+    const auto cell = [](std::int64_t x, std::int64_t y) {
+        return Snapshot::Cell{static_cast<std::int8_t>(x), static_cast<std::int8_t>(y)};
+    };
+    const auto unpack_cell = [&](std::int64_t packed) { return cell(packed & 0xFF, packed >> 8); };
+
+    // The keyframe's body, head first
+    Snapshot& s = out.state;
+    s = Snapshot{};
+    std::int64_t x = get(HeadX, key);
+    std::int64_t y = get(HeadY, key);
+    std::size_t length = 0;
+    const std::size_t first_run = chunk.run_starts[key];
+    for (std::size_t run = first_run; run < first_run + static_cast<std::size_t>(run_count);
+         ++run) {
+        const std::int64_t run_dir = get(RunDir, run);
+        const std::int64_t run_length = get(RunLength, run);
+        if (run_dir < 0 || run_dir > 3 || run_length < 1 ||
+            run_length > Snapshot::max_cells - static_cast<std::int64_t>(length)) {
+            return false;
+        }
+        const sf::Vector2i delta = direction_delta(static_cast<::Direction>(run_dir));
+        x += get(RunDx, run);
+        y += get(RunDy, run);
+        for (std::int64_t c = 0; c < run_length; ++c, x -= delta.x, y -= delta.y) {
+            s.cells[length++] = cell(x, y);
+        }
+    }
+
+    // Every cell the head has been on, oldest first: the keyframe's body, then one per step
+    std::array<Snapshot::Cell, Snapshot::max_cells + DatasetBuffer::keyframe_interval> trail;
+    std::size_t trail_length = length;
+    std::ranges::reverse_copy(std::span(s.cells).first(length), trail.begin());
+
+    std::uint32_t tick = static_cast<std::uint32_t>(get(Tick, key));
+    std::int64_t score = get(Score, key);
+    std::int64_t flags = get(Flags, key);
+    Snapshot::Cell food = cell(get(FoodX, key), get(FoodY, key));
+    std::int64_t bonus = (flags & Snapshot::HasBonus) != 0
+                             ? get(BonusX, key) | get(BonusY, key) << 8 | 1 << 16
+                             : 0;
+    std::int64_t expiry = get(BonusExpiry, key);
+    Snapshot::Cell head = s.cells[0];
+    std::int64_t reward = 0;
+    bool done = false;
+
+    // Replays the steps since the keyframe: each is its prediction from the one before,
+    // corrected by its events
+    std::size_t event = 0;
+    for (std::size_t count = chunk.counts[index(DatasetTable::Events)]; count > 0;) {
+        const std::size_t half = count / 2;
+        if (static_cast<std::size_t>(get(EventStep, event + half)) < key_step) {
+            event += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    for (std::size_t at = key_step;; ++at) {
+        if (at > key_step) {
+            const std::int64_t action = get(Action, at - 1);
+            if (action < 0 || action > 3) return false;
+            if (!is_opposite(static_cast<::Direction>(action), static_cast<::Direction>(dir))) {
+                dir = action;
+            }
+            if ((flags & Snapshot::ShouldGrow) != 0) {
+                ++length;
+                flags &= ~std::int64_t{Snapshot::ShouldGrow};
+            }
+            score += reward;
+            ++tick;
+        }
+        reward = 0;
+        done = false;
+        bool jumped = false;
+        for (; event < chunk.counts[index(DatasetTable::Events)] &&
+               static_cast<std::size_t>(get(EventStep, event)) <= at;
+             ++event) {
+            const std::int64_t value = get(EventValue, event);
+            switch (static_cast<DatasetEvent>(get(EventField, event))) {
+            case DatasetEvent::Direction:
+                if (value < 0 || value > 3) return false;
+                dir = value;
+                break;
+            case DatasetEvent::Flags: flags = value; break;
+            case DatasetEvent::Food: food = unpack_cell(value); break;
+            case DatasetEvent::Bonus: bonus = value; break;
+            case DatasetEvent::BonusExpiry: expiry = value; break;
+            case DatasetEvent::Head:
+                head = unpack_cell(value);
+                jumped = true;
+                break;
+            case DatasetEvent::Length: length = static_cast<std::size_t>(value); break;
+            case DatasetEvent::Score: score = value; break;
+            case DatasetEvent::Reward: reward = value; break;
+            case DatasetEvent::Done: done = value != 0; break;
+            default: return false;
+            }
+        }
+        if (at > key_step) {
+            if (!jumped) {
+                const sf::Vector2i delta = direction_delta(static_cast<::Direction>(dir));
+                head = cell(head.x + delta.x, head.y + delta.y);
+            }
+            trail[trail_length++] = head;
+        }
+        if (at == i) break;
+    }
+    if (length < 1 || length > trail_length || length > Snapshot::max_cells) return false;
+
+    s.tick = tick;
+    s.score = static_cast<std::int32_t>(score);
+    s.grid_w = static_cast<std::uint8_t>(w);
+    s.grid_h = static_cast<std::uint8_t>(h);
+    s.direction = static_cast<std::uint8_t>(dir);
+    s.pending_direction = s.direction;
+    s.flags = static_cast<std::uint8_t>(flags);
+    s.food = food;
+    if ((s.flags & Snapshot::HasBonus) != 0) {
+        s.bonus = unpack_cell(bonus);
+        s.bonus_expiry = static_cast<std::uint32_t>(expiry);
+    }
+    s.body_length = static_cast<std::uint16_t>(length);
+    for (std::size_t c = 0; c < length; ++c) {
+        s.cells[c] = trail[trail_length - 1 - c];
+        if (!in_grid(s.cells[c].x, s.cells[c].y)) return false;
+    }
+
+    out.game = static_cast<std::uint32_t>(get(GameLow, key)) |
+               std::uint64_t{static_cast<std::uint32_t>(get(GameHigh, key))} << 32;
+    out.action = static_cast<::Direction>(get(Action, i));
+    out.reward = static_cast<std::int32_t>(reward);
+    out.done = done;
+    return out.action <= ::Direction::Right;
+}
+
+bool DatasetReader::sample(Rng& rng, Transition& out) const {
+    // The modulo bias is below 2^-40 for any file that fits on a disk
+    return size_ > 0 && read(rng() % size_, out);
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "Direction.hpp"
+#include "FileIO.hpp"
+#include "Rng.hpp"
+#include "Simulation.hpp"
+#include "Snapshot.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Training data for offline learning: (state, action, reward, done) for every step of many
+// headless games, in an append-only file of self-contained chunks.
+//
+// Each chunk stores about sixteen thousand steps column by column. A column is
+// frame-of-reference bit-packed: its minimum, then every value minus the minimum in just as
+// many bits as the largest needs, so a coordinate on a 20x20 board takes 5 bits and a flag 1.
+// Only the action is stored for every step; the rest of the state is predicted from the step
+// before, with an event for whatever differs, such as new food or a portal jump. A keyframe
+// holds the whole state every 64 steps, its body as RunLengthBody's straight runs, and a read
+// replays the steps since the last one. A step of the rollout policy on a 20x20 board takes
+// about 1.5 bytes.
+//
+// Recording threads each fill their own DatasetBuffer; full chunks go to the writer's I/O
+// thread, which packs and appends them, so recording costs a store and a few comparisons per
+// step. A crash can at worst leave a partial last chunk, which the reader ignores.
+
+// One recorded step
+struct Transition {
+    std::uint64_t game = 0; // the game's Simulation::seed(), so it can be replayed
+    // Before the action. rng_state is not recorded and reads back as 0; pending_direction
+    // reads back as direction, with the action applied on top of it.
+    Snapshot state{};
+    Direction action = Direction::Left;
+    std::int32_t reward = 0; // score gained by the step
+    bool done = false;       // the step ended the game
+};
+
+struct DatasetColumns; // one chunk being filled, see Dataset.cpp
+class DatasetBuffer;
+
+// Appends chunks to a file from a background thread. Destruction waits for every chunk handed
+// over so far, including those of buffers destroyed before it.
+class DatasetWriter {
+public:
+    // Replaces path. level names the LevelPack level the games were played on, if any.
+    static std::expected<DatasetWriter, std::string> create(const std::string& path,
+                                                            std::string_view level = {});
+
+    DatasetWriter(DatasetWriter&&) noexcept;
+    DatasetWriter& operator=(DatasetWriter&&) noexcept;
+    ~DatasetWriter();
+
+    // A buffer for one recording thread; it must not outlive the writer
+    [[nodiscard]] DatasetBuffer buffer();
+    // Blocks until every chunk handed over so far is in the file
+    void flush();
+
+    [[nodiscard]] std::uint64_t steps_written() const;
+    [[nodiscard]] std::uint64_t bytes_written() const;
+
+private:
+    friend class DatasetBuffer;
+    struct Worker;
+    explicit DatasetWriter(std::unique_ptr<Worker> worker);
+
+    std::unique_ptr<Worker> worker_;
+};
+
+class DatasetBuffer {
+public:
+    static constexpr std::size_t chunk_steps = 16384;
+    // Steps of a game between keyframes, which bounds the steps DatasetReader::read() replays
+    static constexpr std::size_t keyframe_interval = 64;
+
+    DatasetBuffer(DatasetBuffer&&) noexcept;
+    DatasetBuffer& operator=(DatasetBuffer&&) noexcept;
+    // Hands over what is left
+    ~DatasetBuffer();
+
+    // Records one step in two calls around Simulation::step(): sim's state and the action about
+    // to be set first, then sim again with the events step() returned. Inline so a step that
+    // only moves the snake costs a store and a few predictable branches; the first step of a
+    // game or chunk, and the steps after something happened, are recorded out of line.
+    void begin_step(const Simulation& sim, Direction action) {
+        if (quiet_ && steps_ < last_.key_step + keyframe_interval &&
+            sim.tick() == last_.tick + 1 && sim.seed() == last_.game) {
+            const Direction turned = is_opposite(last_.action, last_.state.direction)
+                                         ? last_.state.direction
+                                         : last_.action;
+            const sf::Vector2i head = last_.state.head + direction_delta(turned);
+            if (sim.snake().direction() == turned && sim.snake().head() == head) {
+                actions_[steps_] = static_cast<std::int32_t>(action);
+                last_.tick = sim.tick();
+                last_.action = action;
+                last_.state.direction = turned;
+                last_.state.head = head;
+                return;
+            }
+        }
+        begin_step_slow(sim, action);
+    }
+    void end_step(const Simulation& sim, const TickEvents& events) {
+        if (events.died || events.ate_food || events.ate_bonus || events.bonus_spawned ||
+            events.bonus_expired) {
+            end_step_slow(sim);
+        }
+        if (++steps_ == chunk_steps) submit();
+    }
+
+    // Hands the recorded steps to the writer now rather than when the chunk is full
+    void submit();
+
+private:
+    friend class DatasetWriter;
+    DatasetBuffer(DatasetWriter::Worker* worker, std::unique_ptr<DatasetColumns> columns);
+
+    // The fields of a step that are predicted from the step before
+    struct State {
+        std::int32_t score = 0;
+        Direction direction = Direction::Left;
+        std::uint8_t flags = 0; // Snapshot::Flags
+        std::int32_t food = 0;  // cells packed as in Dataset.cpp
+        std::int32_t bonus = 0;
+        sf::Vector2i head;
+        std::size_t length = 0;
+
+        bool operator==(const State&) const = default;
+    };
+    // The last recorded step
+    struct Recorded {
+        std::uint64_t game = 0;
+        std::uint32_t tick = 0;
+        Direction action = Direction::Left;
+        std::uint32_t bonus_expiry = 0;
+        std::size_t key_step = 0;
+        State state; // with its score after the step, once end_step() saw it
+    };
+
+    static State state_of(const Simulation& sim);
+    void begin_step_slow(const Simulation& sim, Direction action);
+    void end_step_slow(const Simulation& sim);
+    void keyframe(const Simulation& sim);
+    // Starts recording into columns_ from its first step
+    void reset();
+
+    DatasetWriter::Worker* worker_ = nullptr;
+    std::unique_ptr<DatasetColumns> columns_;
+    std::int32_t* actions_ = nullptr; // columns_' action column
+    std::size_t steps_ = 0;           // recorded into columns_
+    Recorded last_;
+    // Only the head moved since the last step was predicted in full, so the next step is
+    // predicted from the head and the action alone
+    bool quiet_ = false;
+};
+
+// Memory-mapped view of a dataset file. open() indexes the chunks; each read() then unpacks one
+// step straight from the mapping, so streaming and random sampling cost the same.
+class DatasetReader {
+public:
+    static std::expected<DatasetReader, std::string> open(const std::string& path);
+
+    [[nodiscard]] std::uint64_t size() const { return size_; }
+    [[nodiscard]] std::size_t chunk_count() const { return chunks_.size(); }
+    [[nodiscard]] const std::string& level() const { return level_; }
+
+    // Step index in 0-size(); false if it does not decode to a valid state
+    bool read(std::uint64_t index, Transition& out) const;
+    // A step drawn uniformly at random
+    bool sample(Rng& rng, Transition& out) const;
+
+private:
+    struct Column {
+        const std::uint64_t* words = nullptr;
+        std::uint64_t base = 0;
+        unsigned bits = 0;
+
+        [[nodiscard]] std::uint64_t get(std::size_t i) const;
+    };
+    static constexpr std::size_t column_count = 25; // per step, keyframe, body run and event
+    struct Chunk {
+        std::array<std::uint32_t, 4> counts{}; // steps, keyframes, body runs, events
+        std::array<Column, column_count> columns;
+        std::vector<std::uint32_t> run_starts; // each keyframe's first body run
+    };
+
+    explicit DatasetReader(MappedFile file) : file_(std::move(file)) {}
+
+    MappedFile file_;
+    std::string level_;
+    std::vector<Chunk> chunks_;
+    std::vector<std::uint64_t> chunk_starts_; // index of each chunk's first step
+    std::uint64_t size_ = 0;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <utility>
+
+enum class Direction { Up, Down, Left, Right };
+
+[[nodiscard]] constexpr sf::Vector2i direction_delta(Direction dir) {
+    switch (dir) {
+    case Direction::Up: return {0, -1};
+    case Direction::Down: return {0, 1};
+    case Direction::Left: return {-1, 0};
+    case Direction::Right: return {1, 0};
+    default: std::unreachable();
+    }
+}
+
+[[nodiscard]] constexpr bool is_opposite(Direction a, Direction b) {
+    return (a == Direction::Up && b == Direction::Down) ||
+           (a == Direction::Down && b == Direction::Up) ||
+           (a == Direction::Left && b == Direction::Right) ||
+           (a == Direction::Right && b == Direction::Left);
+}
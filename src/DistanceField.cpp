@@ -0,0 +1,208 @@
+#include "DistanceField.hpp"
+
+#include "Snake.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace {
+
+enum Blocked : std::uint8_t { Free, Body, Wall };
+
+constexpr std::array directions = {Direction::Up, Direction::Down, Direction::Left,
+                                   Direction::Right};
+
+// A blocked head that strands more than this share of the board is cheaper to redo from scratch
+constexpr std::size_t fallback_divisor = 4;
+
+} // namespace
+
+DistanceField::DistanceField(const Level& level) : level_(level) {
+    const auto cells = static_cast<std::size_t>(level.width * level.height);
+    dist_.assign(cells, unreachable);
+    blocked_.assign(cells, Free);
+    visited_.assign(cells, 0);
+    queue_.reserve(cells);
+    seeds_.reserve(cells);
+}
+
+std::size_t DistanceField::successor(std::size_t i, Direction dir) const {
+    const sf::Vector2i next = level_.portal_exit(cell(i) + direction_delta(dir));
+    if (!in_bounds(next)) return none;
+    const std::size_t n = index(next);
+    return blocked_[n] == Free ? n : none;
+}
+
+std::size_t DistanceField::predecessor(std::size_t i, Direction dir) const {
+    // portal_exit is its own inverse, so this is the cell whose successor() in dir is i
+    const sf::Vector2i from = level_.portal_exit(cell(i)) - direction_delta(dir);
+    if (!in_bounds(from)) return none;
+    const std::size_t p = index(from);
+    return blocked_[p] == Free ? p : none;
+}
+
+void DistanceField::set(std::size_t i, std::uint16_t distance) {
+    reachable_ += static_cast<int>(distance != unreachable) -
+                  static_cast<int>(dist_[i] != unreachable);
+    dist_[i] = distance;
+}
+
+void DistanceField::reset(sf::Vector2i target, const Snake& snake) {
+    SNAKE_TRACE_ZONE("DistanceField::reset");
+    target_ = target;
+    for (int y = 0; y < level_.height; ++y) {
+        for (int x = 0; x < level_.width; ++x) {
+            blocked_[index({x, y})] = level_.is_wall({x, y}) ? Wall : Free;
+        }
+    }
+    for (const sf::Vector2i c : snake.body()) {
+        if (in_bounds(c) && blocked_[index(c)] == Free) blocked_[index(c)] = Body;
+    }
+    recompute();
+}
+
+void DistanceField::recompute() {
+    ++full_recomputes_;
+    std::ranges::fill(dist_, unreachable);
+    reachable_ = 0;
+    queue_.clear();
+    if (!in_bounds(target_) || blocked_[index(target_)] != Free) return;
+
+    set(index(target_), 0);
+    queue_.push_back(index(target_));
+    for (std::size_t head = 0; head < queue_.size(); ++head) {
+        const std::size_t x = queue_[head];
+        const auto next = static_cast<std::uint16_t>(dist_[x] + 1);
+        for (const Direction dir : directions) {
+            const std::size_t p = predecessor(x, dir);
+            if (p == none || dist_[p] != unreachable) continue;
+            set(p, next);
+            queue_.push_back(p);
+        }
+    }
+}
+
+void DistanceField::unblock(sf::Vector2i c) {
+    if (!in_bounds(c) || blocked_[index(c)] != Body) return;
+    const std::size_t i = index(c);
+    blocked_[i] = Free;
+
+    std::uint16_t best = unreachable;
+    for (const Direction dir : directions) {
+        const std::size_t n = successor(i, dir);
+        if (n != none) best = std::min(best, dist_[n]);
+    }
+    if (best == unreachable) return;
+
+    // Distances only fall, in BFS order out from the freed cell
+    set(i, static_cast<std::uint16_t>(best + 1));
+    queue_.clear();
+    queue_.push_back(i);
+    for (std::size_t head = 0; head < queue_.size(); ++head) {
+        const std::size_t x = queue_[head];
+        const auto next = static_cast<std::uint16_t>(dist_[x] + 1);
+        for (const Direction dir : directions) {
+            const std::size_t p = predecessor(x, dir);
+            if (p == none || dist_[p] <= next) continue;
+            set(p, next);
+            queue_.push_back(p);
+        }
+    }
+}
+
+void DistanceField::block(sf::Vector2i c) {
+    SNAKE_TRACE_ZONE("DistanceField::block");
+    if (!in_bounds(c) || blocked_[index(c)] != Free) return;
+    const std::size_t i = index(c);
+    const std::uint16_t old = dist_[i];
+    blocked_[i] = Body;
+    set(i, unreachable);
+    if (old == unreachable) return;
+    if (c == target_) {
+        recompute();
+        return;
+    }
+
+    // Find the stranded cells level by level outwards from c: a cell is stranded when every
+    // neighbour one step closer to the target is blocked or stranded itself
+    ++epoch_;
+    queue_.clear();
+    const auto enqueue_farther = [&](std::size_t x, std::uint16_t dx) {
+        for (const Direction dir : directions) {
+            const std::size_t p = predecessor(x, dir);
+            if (p == none || dist_[p] != dx + 1 || visited_[p] == epoch_) continue;
+            visited_[p] = epoch_;
+            queue_.push_back(p);
+        }
+    };
+    enqueue_farther(i, old);
+    std::size_t stranded = 0;
+    const std::size_t limit = dist_.size() / fallback_divisor;
+    for (std::size_t head = 0; head < queue_.size(); ++head) {
+        const std::size_t x = queue_[head];
+        const std::uint16_t dx = dist_[x];
+        const bool supported = std::ranges::any_of(directions, [&](Direction dir) {
+            const std::size_t n = successor(x, dir);
+            return n != none && dist_[n] + 1 == dx;
+        });
+        if (supported) continue;
+        enqueue_farther(x, dx);
+        set(x, unreachable);
+        queue_[stranded++] = x; // compacted in place, always behind the read position
+        if (stranded > limit) {
+            recompute();
+            return;
+        }
+    }
+    queue_.resize(stranded);
+
+    // Re-settle them from their unaffected neighbours, closest first: the sorted seeds merged
+    // with a FIFO of relaxations is Dijkstra for unit-length moves
+    seeds_.clear();
+    for (const std::size_t x : queue_) {
+        std::uint16_t best = unreachable;
+        for (const Direction dir : directions) {
+            const std::size_t n = successor(x, dir);
+            if (n != none) best = std::min(best, dist_[n]);
+        }
+        if (best != unreachable) seeds_.emplace_back(static_cast<std::uint16_t>(best + 1), x);
+    }
+    std::ranges::sort(seeds_);
+    queue_.clear();
+    std::size_t seed = 0;
+    std::size_t head = 0;
+    while (seed < seeds_.size() || head < queue_.size()) {
+        std::size_t x = 0;
+        if (head < queue_.size() &&
+            (seed == seeds_.size() || dist_[queue_[head]] < seeds_[seed].first)) {
+            x = queue_[head++];
+        } else {
+            const auto [d, s] = seeds_[seed++];
+            if (dist_[s] <= d) continue;
+            set(s, d);
+            x = s;
+        }
+        const auto next = static_cast<std::uint16_t>(dist_[x] + 1);
+        for (const Direction dir : directions) {
+            const std::size_t p = predecessor(x, dir);
+            if (p == none || dist_[p] <= next) continue;
+            set(p, next);
+            queue_.push_back(p);
+        }
+    }
+}
+
+std::optional<Direction> DistanceField::next_move(sf::Vector2i c) const {
+    if (!in_bounds(c)) return std::nullopt;
+    std::optional<Direction> best;
+    std::uint16_t best_distance = unreachable;
+    for (const Direction dir : directions) {
+        const std::size_t n = successor(index(c), dir);
+        if (n != none && dist_[n] < best_distance) {
+            best = dir;
+            best_distance = dist_[n];
+        }
+    }
+    return best;
+}
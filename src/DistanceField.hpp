@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Direction.hpp"
+#include "Level.hpp"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+class Snake;
+
+// Shortest-path distances from every cell to one target (the food), around walls and the snake's
+// body and through portals. Snake moves are applied incrementally: freeing the tail only lowers
+// distances, spreading out from that cell, and blocking the new head only raises the distances of
+// cells whose every shortest path ran through it, which are found and re-settled locally. A new
+// target, or a blocked head that cuts off a large share of the board, is a full BFS instead.
+//
+// All scratch space is sized in the constructor, so updates do not allocate.
+class DistanceField {
+public:
+    static constexpr std::uint16_t unreachable = std::numeric_limits<std::uint16_t>::max();
+
+    // The level's views are kept, not copied, so its pack must outlive the field
+    explicit DistanceField(const Level& level);
+
+    // Full recompute towards target, with the snake's body as obstacles
+    void reset(sf::Vector2i target, const Snake& snake);
+    // Incremental updates after Snake::update(): the freed tail cell first, then the new head.
+    // Cells off the board are ignored.
+    void unblock(sf::Vector2i cell);
+    void block(sf::Vector2i cell);
+
+    [[nodiscard]] sf::Vector2i target() const { return target_; }
+    // Moves from cell to the target; unreachable for walls, the body and cut-off cells. O(1).
+    [[nodiscard]] std::uint16_t distance(sf::Vector2i cell) const {
+        return in_bounds(cell) ? dist_[index(cell)] : unreachable;
+    }
+    // First move of a shortest path from cell, which may itself be blocked (the head). O(1).
+    [[nodiscard]] std::optional<Direction> next_move(sf::Vector2i cell) const;
+    // Free cells from which the target can be reached
+    [[nodiscard]] int reachable_count() const { return reachable_; }
+    // Full BFS passes so far, counting those an incremental update fell back to
+    [[nodiscard]] std::uint32_t full_recomputes() const { return full_recomputes_; }
+
+private:
+    static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+    [[nodiscard]] bool in_bounds(sf::Vector2i p) const {
+        return p.x >= 0 && p.x < level_.width && p.y >= 0 && p.y < level_.height;
+    }
+    [[nodiscard]] std::size_t index(sf::Vector2i p) const {
+        return static_cast<std::size_t>(p.y * level_.width + p.x);
+    }
+    [[nodiscard]] sf::Vector2i cell(std::size_t i) const {
+        const auto w = static_cast<std::size_t>(level_.width);
+        return {static_cast<int>(i % w), static_cast<int>(i / w)};
+    }
+    // The free cell the head lands on moving dir from i, or none
+    [[nodiscard]] std::size_t successor(std::size_t i, Direction dir) const;
+    // The free cell that lands on i by moving dir, or none
+    [[nodiscard]] std::size_t predecessor(std::size_t i, Direction dir) const;
+
+    void set(std::size_t i, std::uint16_t distance);
+    void recompute();
+
+    Level level_;
+    sf::Vector2i target_;
+    std::vector<std::uint16_t> dist_;
+    std::vector<std::uint8_t> blocked_; // see the Blocked values in DistanceField.cpp
+    int reachable_ = 0;
+    std::uint32_t full_recomputes_ = 0;
+
+    // Scratch for updates
+    std::vector<std::size_t> queue_;
+    std::vector<std::pair<std::uint16_t, std::size_t>> seeds_;
+    std::vector<std::uint32_t> visited_; // == epoch_ once queued during the current update
+    std::uint32_t epoch_ = 0;
+};
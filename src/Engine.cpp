@@ -0,0 +1,366 @@
+#include "Engine.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ; // NOLINT(readability-redundant-declaration)
+
+namespace {
+
+constexpr int protocol_version = 1;
+constexpr auto exit_grace = std::chrono::milliseconds{100};
+
+constexpr std::array<char, 4> direction_chars = {'U', 'D', 'L', 'R'}; // Direction order
+
+std::optional<Direction> parse_direction(char c) {
+    const auto* it = std::ranges::find(direction_chars, c);
+    if (it == direction_chars.end()) return std::nullopt;
+    return static_cast<Direction>(it - direction_chars.begin());
+}
+
+std::string system_error(const char* what) {
+    return std::format("Engine: {} failed: {}", what, std::strerror(errno));
+}
+
+void set_flag(int fd, int get, int set, int flag) {
+    ::fcntl(fd, set, ::fcntl(fd, get) | flag); // NOLINT(cppcoreguidelines-pro-type-vararg)
+}
+
+double microseconds(std::chrono::nanoseconds ns) {
+    return std::chrono::duration<double, std::micro>(ns).count();
+}
+
+} // namespace
+
+void LatencyStats::record(std::chrono::nanoseconds latency) {
+    const auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(latency.count(), 1));
+    std::size_t index = ns;
+    if (ns >= steps) {
+        // Octave from the top bit, step from the three bits below it
+        const auto octave = static_cast<std::size_t>(std::bit_width(ns)) - 1;
+        const auto step = static_cast<std::size_t>(ns >> (octave - 3)) - steps;
+        index = (octave - 2) * steps + step;
+    }
+    ++buckets_[index];
+    ++count_;
+    sum_ += latency;
+    min_ = std::min(min_, latency);
+    max_ = std::max(max_, latency);
+}
+
+std::chrono::nanoseconds LatencyStats::mean() const {
+    return count_ == 0 ? std::chrono::nanoseconds{0}
+                       : sum_ / static_cast<std::int64_t>(count_);
+}
+
+std::chrono::nanoseconds LatencyStats::percentile(double p) const {
+    if (count_ == 0) return std::chrono::nanoseconds{0};
+    const auto target = std::clamp<std::uint64_t>(
+        static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(count_))), 1, count_);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucket_count; ++i) {
+        seen += buckets_[i];
+        if (seen < target) continue;
+        std::uint64_t upper = i;
+        if (i >= steps) {
+            const std::size_t octave = i / steps + 2;
+            upper = ((steps + i % steps + 1) << (octave - 3)) - 1;
+        }
+        return std::min(std::chrono::nanoseconds{static_cast<std::int64_t>(upper)}, max_);
+    }
+    return max_;
+}
+
+std::string EngineStats::summary() const {
+    return std::format("{} moves, latency p50 {:.1f} us, p99 {:.1f} us, max {:.1f} us, "
+                       "{} stale, {} timeouts, {} skipped",
+                       replies, microseconds(latency.percentile(0.5)),
+                       microseconds(latency.percentile(0.99)), microseconds(latency.max()),
+                       stale, timeouts, skipped);
+}
+
+struct Engine::Process {
+    pid_t pid = -1;
+    int to_engine = -1;   // the engine's stdin, non-blocking
+    int from_engine = -1; // its stdout, non-blocking
+    bool alive = true;
+    std::string name;
+    EngineStats stats;
+
+    std::string out;          // lines being written; keeps its capacity
+    std::size_t out_sent = 0; // bytes of out already in the pipe
+    std::string in;           // bytes read but not yet parsed
+
+    std::uint64_t latest = 0; // id of the newest request
+    bool answered = true;
+    Clock::time_point sent;
+
+    // The board last described by a level line
+    int level_w = 0;
+    int level_h = 0;
+    const void* level_walls = nullptr;
+    const void* level_portals = nullptr;
+
+    ~Process() {
+        if (to_engine >= 0) {
+            // After any state still going out; an engine that does not read sees its stdin close
+            out += "quit\n";
+            flush();
+            ::close(to_engine);
+        }
+        if (from_engine >= 0) ::close(from_engine);
+        if (pid <= 0) return;
+        const auto give_up = Clock::now() + exit_grace;
+        while (::waitpid(pid, nullptr, WNOHANG) == 0) {
+            if (Clock::now() >= give_up) {
+                ::kill(-pid, SIGKILL); // the shell and anything it started
+                ::waitpid(pid, nullptr, 0);
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+
+    // Writes as much of out as the pipe takes without blocking
+    bool flush() {
+        while (alive && out_sent < out.size()) {
+            const ssize_t written =
+                ::write(to_engine, out.data() + out_sent, out.size() - out_sent);
+            if (written > 0) {
+                out_sent += static_cast<std::size_t>(written);
+            } else if (written < 0 && errno == EINTR) {
+                continue;
+            } else {
+                if (written == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) alive = false;
+                break;
+            }
+        }
+        if (out_sent == out.size()) {
+            out.clear();
+            out_sent = 0;
+        }
+        return alive;
+    }
+
+    // Appends whatever the engine has written so far without blocking
+    void fill() {
+        std::array<char, 4096> buf;
+        while (alive) {
+            const ssize_t got = ::read(from_engine, buf.data(), buf.size());
+            if (got > 0) {
+                in.append(buf.data(), static_cast<std::size_t>(got));
+            } else if (got < 0 && errno == EINTR) {
+                continue;
+            } else {
+                if (got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) alive = false;
+                return;
+            }
+        }
+    }
+
+    // Blocks until the engine's output is readable, or its input writable while out is not all
+    // sent, or deadline passes
+    bool wait_ready(Clock::time_point deadline) const {
+        const auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+        if (left.count() <= 0) return false;
+        std::array<pollfd, 2> fds{{{from_engine, POLLIN, 0}, {to_engine, POLLOUT, 0}}};
+        const nfds_t count = out.empty() ? 1 : 2;
+        return ::poll(fds.data(), count, static_cast<int>(left.count())) > 0;
+    }
+
+    // Consumes every complete line, returning the move for the latest request if among them
+    std::optional<Direction> take_move() {
+        std::optional<Direction> move;
+        std::size_t begin = 0;
+        for (std::size_t end = in.find('\n'); end != std::string::npos;
+             begin = end + 1, end = in.find('\n', begin)) {
+            std::string_view line(in.data() + begin, end - begin);
+            if (!line.starts_with("move ")) continue;
+            line.remove_prefix(5);
+            std::uint64_t id = 0;
+            const auto [rest, ec] = std::from_chars(line.data(), line.data() + line.size(), id);
+            if (ec != std::errc{} || rest + 2 > line.data() + line.size() || *rest != ' ') {
+                continue;
+            }
+            const auto dir = parse_direction(rest[1]);
+            if (!dir) continue;
+            if (id == latest && !answered) {
+                answered = true;
+                stats.latency.record(Clock::now() - sent);
+                ++stats.replies;
+                move = dir;
+            } else if (id < latest) {
+                ++stats.stale;
+            }
+        }
+        in.erase(0, begin);
+        return move;
+    }
+
+    // The next full line, waiting until deadline for it
+    std::optional<std::string> read_line(Clock::time_point deadline) {
+        for (;;) {
+            if (const auto end = in.find('\n'); end != std::string::npos) {
+                std::string line = in.substr(0, end);
+                in.erase(0, end + 1);
+                return line;
+            }
+            if (!alive || !wait_ready(deadline)) return std::nullopt;
+            flush();
+            fill();
+        }
+    }
+};
+
+std::expected<Engine, std::string> Engine::start(const std::string& command,
+                                                 std::chrono::milliseconds handshake_timeout) {
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::array<int, 2> stdin_pipe{-1, -1};
+    std::array<int, 2> stdout_pipe{-1, -1};
+    if (::pipe(stdin_pipe.data()) != 0) return std::unexpected(system_error("pipe"));
+    if (::pipe(stdout_pipe.data()) != 0) {
+        const std::string error = system_error("pipe");
+        for (const int fd : stdin_pipe) ::close(fd);
+        return std::unexpected(error);
+    }
+    auto process = std::make_unique<Process>();
+    process->to_engine = stdin_pipe[1];
+    process->from_engine = stdout_pipe[0];
+    // The engine gets its ends as stdin and stdout; nothing spawned later inherits any of them
+    for (const int fd : {stdin_pipe[0], stdin_pipe[1], stdout_pipe[0], stdout_pipe[1]}) {
+        set_flag(fd, F_GETFD, F_SETFD, FD_CLOEXEC);
+    }
+    set_flag(process->to_engine, F_GETFL, F_SETFL, O_NONBLOCK);
+    set_flag(process->from_engine, F_GETFL, F_SETFL, O_NONBLOCK);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, stdin_pipe[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, stdout_pipe[1], STDOUT_FILENO);
+    // In a process group of its own, so a hung engine can be killed along with its shell
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attributes, 0);
+    std::string script = command;
+    std::array<char*, 4> argv = {const_cast<char*>("sh"), // NOLINT(*-const-cast)
+                                 const_cast<char*>("-c"), // NOLINT(*-const-cast)
+                                 script.data(), nullptr};
+    const int spawned =
+        ::posix_spawn(&process->pid, "/bin/sh", &actions, &attributes, argv.data(), environ);
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&actions);
+    ::close(stdin_pipe[0]);
+    ::close(stdout_pipe[1]);
+    if (spawned != 0) {
+        process->pid = -1;
+        errno = spawned;
+        return std::unexpected(system_error("posix_spawn"));
+    }
+
+    process->out = std::format("snake {}\n", protocol_version);
+    process->flush();
+    const auto reply = process->read_line(Clock::now() + handshake_timeout);
+    if (!reply || !reply->starts_with("ready")) {
+        return std::unexpected(std::format("Engine '{}' did not answer the handshake", command));
+    }
+    process->name = reply->size() > 6 ? reply->substr(6) : command;
+    return Engine(std::move(process));
+}
+
+Engine::Engine(std::unique_ptr<Process> process) : process_(std::move(process)) {}
+Engine::Engine(Engine&&) noexcept = default;
+Engine& Engine::operator=(Engine&&) noexcept = default;
+Engine::~Engine() = default;
+
+bool Engine::request(const Simulation& sim, std::chrono::microseconds budget) {
+    Process& p = *process_;
+    if (!p.flush()) return false;
+    std::string& out = p.out;
+    if (!out.empty()) {
+        // The engine has not read the last state: this one must wait behind it if part of it is
+        // in the pipe, and otherwise replaces it, resending its level line if it had one
+        ++p.stats.skipped;
+        if (p.out_sent != 0) return true;
+        if (out.starts_with("level")) p.level_w = 0;
+        out.clear();
+    }
+    auto it = std::back_inserter(out);
+
+    const Board& board = sim.board();
+    const Level& level = board.level();
+    if (level.width != p.level_w || level.height != p.level_h ||
+        level.walls.data() != p.level_walls || level.portals.data() != p.level_portals) {
+        p.level_w = level.width;
+        p.level_h = level.height;
+        p.level_walls = level.walls.data();
+        p.level_portals = level.portals.data();
+        std::format_to(it, "level {} {} {}", level.width, level.height, level.wall_count());
+        for (int y = 0; y < level.height; ++y) {
+            for (int x = 0; x < level.width; ++x) {
+                if (level.is_wall({x, y})) std::format_to(it, " {}", y * level.width + x);
+            }
+        }
+        std::format_to(it, " {}", level.portals.size());
+        for (const Portal& portal : level.portals) {
+            std::format_to(it, " {} {} {} {}", portal.ax, portal.ay, portal.bx, portal.by);
+        }
+        out += '\n';
+    }
+
+    const Snake& snake = sim.snake();
+    const sf::Vector2i food = board.food_position();
+    const sf::Vector2i bonus = board.bonus_position().value_or(sf::Vector2i{-1, -1});
+    std::format_to(it, "state {} {} {} {} {} {} {} {} {} {}", p.latest + 1, budget.count(),
+                   sim.tick(), sim.score(),
+                   direction_chars[static_cast<std::size_t>(snake.direction())], food.x, food.y,
+                   bonus.x, bonus.y, snake.body().size());
+    for (const sf::Vector2i cell : snake.body()) std::format_to(it, " {} {}", cell.x, cell.y);
+    out += '\n';
+
+    ++p.latest;
+    p.answered = false;
+    ++p.stats.requests;
+    p.sent = Clock::now();
+    return p.flush();
+}
+
+std::optional<Direction> Engine::poll() {
+    process_->flush();
+    process_->fill();
+    return process_->take_move();
+}
+
+std::optional<Direction> Engine::wait(Clock::time_point deadline) {
+    Process& p = *process_;
+    for (;;) {
+        if (const auto move = poll()) return move;
+        if (p.answered || !p.alive) return std::nullopt;
+        if (!p.wait_ready(deadline)) {
+            if (Clock::now() < deadline) continue; // woken early, e.g. by a signal
+            ++p.stats.timeouts;
+            return std::nullopt;
+        }
+    }
+}
+
+const std::string& Engine::name() const { return process_->name; }
+const EngineStats& Engine::stats() const { return process_->stats; }
+bool Engine::alive() const { return process_->alive; }
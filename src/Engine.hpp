@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Direction.hpp"
+#include "Simulation.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <string>
+
+// Bots as separate processes, attached like chess engines: the game writes state lines to the
+// engine's stdin and reads moves from its stdout. One line per message, space-separated:
+//
+//   game -> engine
+//     snake 1                        handshake; protocol version
+//     level W H N i... P ax ay bx by...
+//                                    before the first state on a board: N wall cells as
+//                                    indices y * W + x, then P portals
+//     state ID BUDGET_US TICK SCORE DIR FX FY BX BY LEN x y...
+//                                    DIR is U, D, L or R; BX BY are -1 -1 without a bonus;
+//                                    LEN body cells from the head
+//     quit
+//   engine -> game
+//     ready NAME                     answers the handshake
+//     move ID DIR                    answers state ID; anything else is ignored
+//
+// States are pipelined: the game sends one as soon as a tick ends and picks the move up when
+// the next tick falls due, so the engine thinks while the frame loop runs. A move that misses
+// its tick is dropped and the snake keeps its heading. Writes never block: while the engine has
+// not read the last state, a newer one replaces it if none of it is in the pipe yet and is
+// skipped otherwise.
+
+// Reply latency distribution: log2 buckets of nanoseconds split into eight linear steps, so
+// percentiles are within 12.5% at any scale and recording never allocates
+class LatencyStats {
+public:
+    void record(std::chrono::nanoseconds latency);
+
+    [[nodiscard]] std::uint64_t count() const { return count_; }
+    [[nodiscard]] std::chrono::nanoseconds min() const { return min_; }
+    [[nodiscard]] std::chrono::nanoseconds max() const { return max_; }
+    [[nodiscard]] std::chrono::nanoseconds mean() const;
+    // Upper edge of the bucket holding the p-quantile, p in 0-1
+    [[nodiscard]] std::chrono::nanoseconds percentile(double p) const;
+
+private:
+    static constexpr std::size_t steps = 8;
+    static constexpr std::size_t bucket_count = 64 * steps;
+
+    std::array<std::uint64_t, bucket_count> buckets_{};
+    std::uint64_t count_ = 0;
+    std::chrono::nanoseconds sum_{0};
+    std::chrono::nanoseconds min_{std::chrono::nanoseconds::max()};
+    std::chrono::nanoseconds max_{0};
+};
+
+struct EngineStats {
+    std::uint64_t requests = 0;
+    std::uint64_t replies = 0;  // to the latest request, in time to be used
+    std::uint64_t stale = 0;    // to a request that a newer one had already replaced
+    std::uint64_t timeouts = 0; // wait() deadlines passed without a reply
+    std::uint64_t skipped = 0;  // states not sent as the engine had not read the one before
+    LatencyStats latency;       // of every reply, from the state's write to the move's read
+
+    // One line: moves, latency percentiles in microseconds, stale replies, timeouts and skipped
+    // states
+    [[nodiscard]] std::string summary() const;
+};
+
+class Engine {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Runs command through /bin/sh and waits up to handshake_timeout for its ready line. SIGPIPE
+    // is ignored from then on, so an engine that exits shows up as a failed write, not a signal.
+    static std::expected<Engine, std::string> start(const std::string& command,
+                                                    std::chrono::milliseconds handshake_timeout);
+
+    Engine(Engine&&) noexcept;
+    Engine& operator=(Engine&&) noexcept;
+    // Sends quit if the pipe has room and gives the engine a moment to exit before killing it
+    ~Engine();
+
+    // Sends sim's state with a thinking budget, and its level first when that changed, as far as
+    // the pipe takes it without blocking. Replaces any outstanding request. False once the
+    // engine has gone.
+    bool request(const Simulation& sim, std::chrono::microseconds budget);
+    // The move for the latest request if it has arrived; never blocks
+    std::optional<Direction> poll();
+    // The move for the latest request, waiting until deadline at the latest
+    std::optional<Direction> wait(Clock::time_point deadline);
+
+    [[nodiscard]] const std::string& name() const;
+    [[nodiscard]] const EngineStats& stats() const;
+    [[nodiscard]] bool alive() const;
+
+private:
+    struct Process;
+    explicit Engine(std::unique_ptr<Process> process);
+
+    std::unique_ptr<Process> process_;
+};
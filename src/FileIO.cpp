@@ -0,0 +1,135 @@
+#include "FileIO.hpp"
+
+#include "Log.hpp"
+#include "Trace.hpp"
+
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+std::optional<Bytes> read_file(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) return std::nullopt;
+
+    Bytes contents;
+    if (std::fseek(file, 0, SEEK_END) == 0) {
+        const long size = std::ftell(file);
+        if (size > 0) contents.resize(static_cast<std::size_t>(size));
+        std::rewind(file);
+    }
+    const auto got = std::fread(contents.data(), 1, contents.size(), file);
+    std::fclose(file);
+    if (got != contents.size()) return std::nullopt;
+    return contents;
+}
+
+std::optional<MappedFile> MappedFile::open(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return std::nullopt;
+
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    const auto size = static_cast<std::size_t>(info.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file alive
+    if (data == MAP_FAILED) return std::nullopt;
+    return MappedFile{static_cast<const std::uint8_t*>(data), size};
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    if (data_ != nullptr) ::munmap(const_cast<std::uint8_t*>(data_), size_);
+}
+
+bool write_file_atomically(const std::string& path, std::span<const std::uint8_t> contents) {
+    SNAKE_TRACE_ZONE("write_file_atomically");
+    const std::string tmp = path + ".tmp";
+    std::FILE* file = std::fopen(tmp.c_str(), "wb");
+    if (file == nullptr) return false;
+
+    bool ok = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    ok = std::fflush(file) == 0 && ok;
+    ok = ::fsync(::fileno(file)) == 0 && ok;
+    ok = std::fclose(file) == 0 && ok;
+
+    std::error_code ec;
+    if (ok) std::filesystem::rename(tmp, path, ec);
+    if (!ok || ec) {
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+struct AsyncFileWriter::Worker {
+    std::mutex mutex;
+    std::condition_variable_any wake;
+    std::condition_variable_any idle;
+    std::map<std::string, Bytes> pending;
+    bool busy = false;
+    std::jthread thread{[this](const std::stop_token& stop) { run(stop); }};
+
+    void run(const std::stop_token& stop) {
+        std::unique_lock lock(mutex);
+        for (;;) {
+            wake.wait(lock, stop, [this] { return !pending.empty(); });
+            if (pending.empty()) return; // stop requested with nothing left to write
+
+            auto batch = std::move(pending);
+            pending.clear();
+            busy = true;
+            lock.unlock();
+            for (const auto& [path, contents] : batch) {
+                if (!write_file_atomically(path, contents)) {
+                    Log::error("Failed to write {}", path);
+                }
+            }
+            lock.lock();
+            busy = false;
+            idle.notify_all();
+        }
+    }
+};
+
+AsyncFileWriter::AsyncFileWriter() : worker_(std::make_unique<Worker>()) {}
+
+// The worker's jthread stops only once the queue is empty, so pending writes finish here
+AsyncFileWriter::~AsyncFileWriter() = default;
+AsyncFileWriter::AsyncFileWriter(AsyncFileWriter&&) noexcept = default;
+AsyncFileWriter& AsyncFileWriter::operator=(AsyncFileWriter&&) noexcept = default;
+
+void AsyncFileWriter::write(std::string path, Bytes contents) {
+    {
+        const std::scoped_lock lock(worker_->mutex);
+        worker_->pending.insert_or_assign(std::move(path), std::move(contents));
+    }
+    worker_->wake.notify_one();
+}
+
+void AsyncFileWriter::flush() {
+    std::unique_lock lock(worker_->mutex);
+    worker_->idle.wait(lock, [this] { return worker_->pending.empty() && !worker_->busy; });
+}
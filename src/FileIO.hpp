@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+using Bytes = std::vector<std::uint8_t>;
+
+// Fixed little-endian encoding, so the binary files (replays, leaderboard) move between machines
+template <typename T>
+void put_le(Bytes& out, T value) {
+    auto v = static_cast<std::uint64_t>(value);
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<std::uint8_t>(v & 0xFF));
+        v >>= 8;
+    }
+}
+
+class ByteReader {
+public:
+    explicit ByteReader(std::span<const std::uint8_t> data) : data_(data) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (data_.size() - pos_ < sizeof(T)) return false;
+        std::uint64_t v = 0;
+        for (std::size_t i = sizeof(T); i-- > 0;) {
+            v = (v << 8) | data_[pos_ + i];
+        }
+        pos_ += sizeof(T);
+        value = static_cast<T>(v);
+        return true;
+    }
+
+    template <std::size_t N>
+    bool get(std::array<char, N>& bytes) {
+        if (data_.size() - pos_ < N) return false;
+        std::memcpy(bytes.data(), data_.data() + pos_, N);
+        pos_ += N;
+        return true;
+    }
+
+    [[nodiscard]] std::size_t remaining() const { return data_.size() - pos_; }
+
+private:
+    std::span<const std::uint8_t> data_;
+    std::size_t pos_ = 0;
+};
+
+// Whole file in one read; nullopt when it cannot be opened
+std::optional<Bytes> read_file(const std::string& path);
+
+// Read-only memory mapping of a whole file, unmapped on destruction. Pages are loaded on first
+// touch, so opening costs a system call regardless of size.
+class MappedFile {
+public:
+    static std::optional<MappedFile> open(const std::string& path);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    [[nodiscard]] std::span<const std::uint8_t> bytes() const { return {data_, size_}; }
+
+private:
+    MappedFile(const std::uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// Writes path.tmp, flushes it to disk and renames it over path, so a crash at any point leaves
+// either the previous file or the new one, never a torn mix
+bool write_file_atomically(const std::string& path, std::span<const std::uint8_t> contents);
+
+// Runs write_file_atomically on a background thread so callers on the game thread never wait
+// on disk. Writes to a path that is still queued replace the queued contents.
+class AsyncFileWriter {
+public:
+    AsyncFileWriter();
+    ~AsyncFileWriter();
+    AsyncFileWriter(AsyncFileWriter&&) noexcept;
+    AsyncFileWriter& operator=(AsyncFileWriter&&) noexcept;
+
+    void write(std::string path, Bytes contents);
+    // Blocks until everything queued so far is on disk
+    void flush();
+
+private:
+    struct Worker;
+    std::unique_ptr<Worker> worker_;
+};
@@ -1,12 +1,33 @@
 #include "Game.hpp"
 
+#include "Log.hpp"
+#include "Metrics.hpp"
+#include "Policy.hpp"
+#include "Trace.hpp"
+
 #include <SFML/Window/Event.hpp>
 
 #include <algorithm>
 #include <array>
-#include <print>
+#include <fstream>
+
+namespace {
+
+const Level* find_level(const std::optional<LevelPack>& levels, const std::string& name) {
+    if (!levels || name.empty()) return nullptr;
+    const auto index = levels->find(name);
+    return index ? &levels->level(*index) : nullptr;
+}
+
+// Window and view edge in pixels; non-square levels sit in the top-left of a square view
+int window_size(const Settings& settings, const Level* level) {
+    const int cells = level ? std::max(level->width, level->height) : settings.grid_size;
+    return cells * Config::cell_size;
+}
 
-std::expected<Game, std::string> Game::create() {
+} // namespace
+
+std::expected<Game, std::string> Game::create(Clock::time_point launched) {
     auto renderer = Renderer::create();
     if (!renderer) {
         return std::unexpected(renderer.error());
@@ -15,24 +36,34 @@ std::expected<Game, std::string> Game::create() {
     Settings settings;
     settings.load();
 
-    const int win_size = settings.window_size();
+    std::optional<LevelPack> levels;
+    if (auto pack = LevelPack::open(Config::level_pack_path)) {
+        Log::info("Loaded {} levels from {}", pack->size(), Config::level_pack_path);
+        levels = std::move(*pack);
+    } else {
+        Log::warning("{}; only the open grid is available", pack.error());
+    }
+
+    const int win_size = window_size(settings, find_level(levels, settings.level));
     sf::RenderWindow window(
         sf::VideoMode({static_cast<unsigned>(win_size), static_cast<unsigned>(win_size)}),
         Config::window_title, sf::Style::Default);
     window.setFramerateLimit(60);
 
-    std::print("[snake] Window created ({}x{})\n", win_size, win_size);
+    Log::info("Window created ({}x{})", win_size, win_size);
 
     Game game{std::move(window), std::move(*renderer)};
     game.settings_ = settings;
-    game.board_ = Board(settings.grid_size, settings.grid_size);
-    game.board_.spawn_food(game.snake_);
+    game.levels_ = std::move(levels);
+    game.sim_ = game.new_simulation();
+    game.heatmap_ = Heatmap(game.sim_.board().width(), game.sim_.board().height());
 
-    game.high_score_.load();
+    game.load_leaderboard();
 
     auto view_size = static_cast<float>(win_size);
     game.game_view_ = sf::View(sf::FloatRect({0.f, 0.f}, {view_size, view_size}));
     game.game_start_time_ = Clock::now();
+    game.launched_ = launched;
 
     return game;
 }
@@ -40,31 +71,46 @@ std::expected<Game, std::string> Game::create() {
 Game::Game(sf::RenderWindow window, // NOLINT(performance-unnecessary-value-param)
            Renderer renderer)
     : window_(std::move(window)), renderer_(std::move(renderer)),
-      board_(Config::grid_width, Config::grid_height), last_tick_(Clock::now()),
-      last_frame_time_(Clock::now()), game_start_time_(Clock::now()) {}
+      sim_(Config::grid_width, Config::grid_height, Config::initial_tick, Rng::random_seed()),
+      rewind_(static_cast<std::size_t>(Config::rewind_seconds * 1000 / Config::min_tick.count()),
+              Config::rewind_buffer_bytes),
+      last_tick_(Clock::now()), last_frame_time_(Clock::now()), game_start_time_(Clock::now()) {}
 
 void Game::run() {
-    std::print("[snake] Game running\n");
+    Log::info("Game running");
+    Trace::set_thread_name("game");
 
     while (window_.isOpen()) {
+        SNAKE_TRACE_ZONE("frame");
         auto now = Clock::now();
         const float dt = std::chrono::duration<float>(now - last_frame_time_).count();
+        Metrics::frames.add();
+        Metrics::frame_time.observe(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(now - last_frame_time_).count()));
         last_frame_time_ = now;
 
         handle_events();
 
         if (state_ == GameState::Playing) {
-            if (now - last_tick_ >= tick_interval()) {
+            if (rewinding_) {
+                rewind();
                 last_tick_ = now;
-                update();
+            } else {
+                if (const auto late = now - last_tick_ - tick_interval();
+                    late >= Clock::duration::zero()) {
+                    Metrics::tick_lag.observe(static_cast<std::uint64_t>(
+                        std::chrono::duration_cast<std::chrono::microseconds>(late).count()));
+                    last_tick_ = now;
+                    update();
+                }
+                update_bots(now);
             }
-            board_.update_bonus(dt);
         }
 
-        if (shake_timer_ > 0.f) {
-            shake_timer_ -= dt;
-            shake_timer_ = std::max(shake_timer_, 0.f);
-        }
+        const auto since_launch =
+            std::chrono::duration_cast<std::chrono::milliseconds>(now - launched_).count();
+        effects_.advance(static_cast<std::uint64_t>(since_launch), [](Effect) {});
+        if (state_ != GameState::Paused) particles_.update(dt);
 
         float alpha = 0.f;
         if (state_ == GameState::Playing) {
@@ -76,33 +122,66 @@ void Game::run() {
         }
 
         sf::Vector2f shake_offset{0.f, 0.f};
-        if (shake_timer_ > 0.f) {
-            const float intensity =
-                Config::shake_intensity * (shake_timer_ / Config::shake_duration);
+        if (const auto shake_end = effects_.deadline(shake_)) {
+            const auto left = static_cast<float>(*shake_end - effects_.now());
+            const float intensity = Config::shake_intensity * left /
+                                    static_cast<float>(Config::shake_duration.count());
             std::uniform_real_distribution<float> dist(-intensity, intensity);
             shake_offset = {dist(shake_rng_), dist(shake_rng_)};
         }
 
         const float elapsed_time = std::chrono::duration<float>(now - game_start_time_).count();
 
+        tiles_.clear();
+        if (!bots_.empty()) {
+            tiles_.push_back({.snake = sim_.snake(),
+                              .board = sim_.board(),
+                              .alpha = alpha,
+                              .bonus_time_remaining = sim_.bonus_time_remaining(),
+                              .score = sim_.score(),
+                              .name = autopilot_ ? "AI" : "You"});
+            for (const Bot& bot : bots_) {
+                float bot_alpha = 1.f;
+                if (state_ == GameState::Playing) {
+                    bot_alpha = std::clamp(
+                        std::chrono::duration<float>(now - bot.last_tick) / bot.sim.tick_interval(),
+                        0.f, 1.f);
+                }
+                tiles_.push_back({.snake = bot.sim.snake(),
+                                  .board = bot.sim.board(),
+                                  .alpha = bot_alpha,
+                                  .bonus_time_remaining = bot.sim.bonus_time_remaining(),
+                                  .score = bot.sim.score(),
+                                  .name = bot.pathing ? "Pathing" : "Greedy"});
+            }
+        }
+
         const RenderContext ctx{
-            .snake = snake_,
-            .board = board_,
+            .snake = sim_.snake(),
+            .board = sim_.board(),
+            .particles = particles_,
+            .heatmap = show_heatmap_ ? &heatmap_ : nullptr,
+            .tiles = tiles_,
             .state = state_,
-            .score = score_,
-            .high_score = high_score_.value(),
+            .score = sim_.score(),
+            .high_score = leaderboard_.best(board_key(), settings_.starting_speed),
             .is_new_high_score = is_new_high_score_,
+            .autopilot = autopilot_,
             .alpha = alpha,
             .cell_size = Config::cell_size,
-            .grid_w = settings_.grid_size,
-            .grid_h = settings_.grid_size,
+            .grid_w = sim_.board().width(),
+            .grid_h = sim_.board().height(),
             .elapsed_time = elapsed_time,
+            .bonus_time_remaining = sim_.bonus_time_remaining(),
             .shake_offset = shake_offset,
             .game_view = game_view_,
             .settings_cursor = settings_cursor_,
             .settings_binding_mode = settings_binding_mode_,
             .settings_grid_size = settings_.grid_size,
             .settings_speed_label = speed_label(),
+            .settings_ai_rollouts = settings_.ai_rollouts,
+            .settings_level = selected_level() ? settings_.level : "Open",
+            .settings_split_games = settings_.split_games,
             .settings_key_up = Settings::key_to_name(settings_.keys.up),
             .settings_key_down = Settings::key_to_name(settings_.keys.down),
             .settings_key_left = Settings::key_to_name(settings_.keys.left),
@@ -111,15 +190,29 @@ void Game::run() {
         };
 
         renderer_.draw(window_, ctx);
+        SNAKE_TRACE_ZONE("display");
+        window_.display();
+
+        if (!presented_first_frame_) {
+            presented_first_frame_ = true;
+            const std::chrono::duration<double, std::milli> startup = Clock::now() - launched_;
+            Log::info("First frame presented {:.1f} ms after launch", startup.count());
+        }
     }
+
+    if (engine_) Log::info("Engine {}: {}", engine_->name(), engine_->stats().summary());
+    if constexpr (tracing_enabled) write_trace();
 }
 
 void Game::handle_events() {
+    SNAKE_TRACE_ZONE("Game::handle_events");
     while (auto event = window_.pollEvent()) {
         if (event->is<sf::Event::Closed>()) {
             window_.close();
         } else if (const auto* key = event->getIf<sf::Event::KeyPressed>()) {
             handle_key(key->code);
+        } else if (const auto* released = event->getIf<sf::Event::KeyReleased>()) {
+            if (released->code == sf::Keyboard::Key::R) rewinding_ = false;
         } else if (const auto* resized = event->getIf<sf::Event::Resized>()) {
             const float window_ratio =
                 static_cast<float>(resized->size.x) / static_cast<float>(resized->size.y);
@@ -141,11 +234,22 @@ void Game::handle_events() {
 void Game::handle_key(sf::Keyboard::Key key) {
     using K = sf::Keyboard::Key;
 
+    if (tracing_enabled && key == K::F9) {
+        write_trace();
+        return;
+    }
+
     if (state_ == GameState::Settings) {
         handle_settings_key(key);
         return;
     }
 
+    // Only while H is not bound to a control, which takes precedence
+    if (key == K::H && !settings_.keys.binds(key)) {
+        show_heatmap_ = !show_heatmap_;
+        return;
+    }
+
     switch (state_) {
     case GameState::Menu:
         if (key == K::Enter) {
@@ -160,24 +264,31 @@ void Game::handle_key(sf::Keyboard::Key key) {
         break;
 
     case GameState::Playing:
-        if (key == settings_.keys.up || key == K::W)
-            snake_.set_direction(Direction::Up); // NOLINT(bugprone-branch-clone)
-        else if (key == settings_.keys.down || key == K::S)
-            snake_.set_direction(Direction::Down);
-        else if (key == settings_.keys.left || key == K::A)
-            snake_.set_direction(Direction::Left);
-        else if (key == settings_.keys.right || key == K::D)
-            snake_.set_direction(Direction::Right);
-        else if (key == settings_.keys.pause)
+        if (key == settings_.keys.up || key == K::W) {
+            sim_.set_direction(Direction::Up); // NOLINT(bugprone-branch-clone)
+        } else if (key == settings_.keys.down || key == K::S) {
+            sim_.set_direction(Direction::Down);
+        } else if (key == settings_.keys.left || key == K::A) {
+            sim_.set_direction(Direction::Left);
+        } else if (key == settings_.keys.right || key == K::D) {
+            sim_.set_direction(Direction::Right);
+        } else if (key == settings_.keys.pause) {
             state_ = GameState::Paused;
-        else if (key == K::Escape)
+        } else if (key == K::R) {
+            rewinding_ = true;
+        } else if (key == K::M) {
+            autopilot_ = !autopilot_;
+            if (autopilot_) think();
+        } else if (key == K::Escape) {
             window_.close();
+        }
         break;
 
     case GameState::Paused:
         if (key == settings_.keys.pause) {
             state_ = GameState::Playing;
             last_tick_ = Clock::now();
+            for (Bot& bot : bots_) bot.last_tick = last_tick_;
         } else if (key == K::Escape) {
             window_.close();
         }
@@ -186,6 +297,9 @@ void Game::handle_key(sf::Keyboard::Key key) {
     case GameState::GameOver:
         if (key == K::Enter) {
             start_game();
+        } else if (key == K::R && rewind_.frames() > 0) {
+            state_ = GameState::Playing;
+            rewinding_ = true;
         } else if (key == K::Escape) {
             window_.close();
         }
@@ -221,17 +335,29 @@ void Game::handle_settings_key(sf::Keyboard::Key key) {
             cycle_grid_size(-1);
         else if (settings_cursor_ == 1)
             cycle_speed(-1);
+        else if (settings_cursor_ == 7)
+            cycle_ai_rollouts(-1);
+        else if (settings_cursor_ == 8)
+            cycle_level(-1);
+        else if (settings_cursor_ == 9)
+            cycle_split_games(-1);
         break;
     case K::Right:
         if (settings_cursor_ == 0)
             cycle_grid_size(1);
         else if (settings_cursor_ == 1)
             cycle_speed(1);
+        else if (settings_cursor_ == 7)
+            cycle_ai_rollouts(1);
+        else if (settings_cursor_ == 8)
+            cycle_level(1);
+        else if (settings_cursor_ == 9)
+            cycle_split_games(1);
         break;
     case K::Enter:
         if (settings_cursor_ >= 2 && settings_cursor_ <= 6) {
             settings_binding_mode_ = true;
-        } else if (settings_cursor_ == 7) {
+        } else if (settings_cursor_ == 10) {
             settings_.save();
             apply_settings_changes();
             state_ = GameState::Menu;
@@ -247,51 +373,207 @@ void Game::handle_settings_key(sf::Keyboard::Key key) {
 }
 
 void Game::update() {
-    snake_.update();
+    SNAKE_TRACE_ZONE("Game::update");
+    if (engine_) {
+        // Only a reply to the state sent after the last tick counts; older ones are stale
+        if (const auto move = engine_->poll(); move && autopilot_) sim_.set_direction(*move);
+    } else if (ai_move_.valid()) {
+        const Direction move = ai_move_.get();
+        if (autopilot_ && ai_move_tick_ == sim_.tick()) sim_.set_direction(move);
+    }
+
+    Snapshot snapshot;
+    sim_.snapshot(snapshot);
+    rewind_.push(snapshot);
 
-    if (snake_.is_out_of_bounds(settings_.grid_size, settings_.grid_size) ||
-        snake_.has_self_collision()) {
+    recorder_.before_step(sim_);
+    const TickEvents events = sim_.step();
+    Metrics::ticks.add();
+    recorder_.after_step(sim_);
+    heatmap_.record(sim_, events);
+    publish_state();
+
+    if (events.died) {
         state_ = GameState::GameOver;
-        is_new_high_score_ = high_score_.try_update(score_);
-        shake_timer_ = Config::shake_duration;
-        std::print("[snake] Game over! Final score: {}\n", score_);
+        rewinding_ = false;
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        const LeaderboardEntry entry{
+            sim_.score(), std::chrono::duration_cast<std::chrono::seconds>(now).count()};
+        // A game rewound from its end and lost again updates its entry rather than adding one
+        if (!submitted_) {
+            Metrics::games.add();
+            Metrics::score.observe(static_cast<std::uint64_t>(sim_.score()));
+        }
+        const bool changed = !submitted_ || submitted_->score != entry.score;
+        if (changed) {
+            const auto rank =
+                submitted_ ? leaderboard_.replace(board_key(), settings_.starting_speed,
+                                                  *submitted_, entry.score, entry.time)
+                           : leaderboard_.submit(board_key(), settings_.starting_speed,
+                                                 entry.score, entry.time);
+            // Ties rank below, so first place beats every other game
+            is_new_high_score_ = rank == 0 && entry.score > 0;
+            submitted_ = entry;
+        }
+        effects_.cancel(shake_);
+        shake_ = effects_.schedule(static_cast<std::uint64_t>(Config::shake_duration.count()),
+                                   Effect::Shake);
+        for (const sf::Vector2i cell : sim_.snake().body()) {
+            burst(cell, Config::death_burst_per_cell, Config::snake_body);
+        }
+        if (changed) writer_.write(Config::leaderboard_path, leaderboard_.serialize());
+        writer_.write(Config::replay_path, recorder_.replay().serialize());
+        Log::info("Game over! Final score: {} (hash {:016x})", sim_.score(), sim_.hash());
         return;
     }
 
-    if (snake_.head() == board_.food_position()) {
-        snake_.grow();
-        ++score_;
-        board_.spawn_food(snake_);
-        std::print("[snake] Score: {}\n", score_);
+    if (events.ate_food) {
+        burst(sim_.snake().head(), Config::food_burst, Config::food_color);
+        Log::info("Score: {}", sim_.score());
+    }
 
-        std::uniform_real_distribution<float> chance(0.f, 1.f);
-        if (!board_.bonus_position() && chance(shake_rng_) < Config::bonus_spawn_chance) {
-            board_.spawn_bonus(snake_);
+    if (events.ate_bonus) {
+        burst(sim_.snake().head(), Config::bonus_burst, Config::bonus_food_color);
+        Log::info("Bonus! Score: {}", sim_.score());
+    }
+
+    if (autopilot_) think();
+}
+
+void Game::think() {
+    const auto budget = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<float, std::milli>(sim_.tick_interval()) *
+        Config::mcts_think_fraction);
+    if (engine_) {
+        if (engine_->request(sim_, std::chrono::duration_cast<std::chrono::microseconds>(budget))) {
+            return;
+        }
+        Log::warning("Engine {} has exited; the autopilot falls back to search", engine_->name());
+        Log::info("Engine {}: {}", engine_->name(), engine_->stats().summary());
+        engine_.reset();
+    }
+    // update() collects every search before the tick, so one still running is for this tick:
+    // it shares mcts_ and its arenas, so a second must not start beside it
+    if (ai_move_.valid()) return;
+    const auto deadline = Clock::now() + budget;
+    ai_move_tick_ = sim_.tick();
+    ai_move_ = std::async(std::launch::async,
+                          [this, sim = sim_, deadline, rollouts = settings_.ai_rollouts] {
+                              Trace::set_thread_name("autopilot");
+                              return mcts_.search(sim, rollouts, deadline);
+                          });
+}
+
+void Game::update_bots(Clock::time_point now) {
+    SNAKE_TRACE_ZONE("Game::update_bots");
+    for (Bot& bot : bots_) {
+        if (now - bot.last_tick < bot.sim.tick_interval()) continue;
+        bot.last_tick = now;
+        bot.sim.set_direction(heuristic_move(bot.sim, bot.rng));
+        if (bot.sim.step().died) {
+            bot.sim = new_simulation();
+            if (bot.pathing) bot.sim.enable_distance_field();
         }
     }
+}
 
-    if (board_.bonus_position() && snake_.head() == *board_.bonus_position()) {
-        score_ += Config::bonus_points;
-        board_.clear_bonus();
-        std::print("[snake] Bonus! Score: {}\n", score_);
+void Game::rewind() {
+    SNAKE_TRACE_ZONE("Game::rewind");
+    Snapshot snapshot;
+    if (!rewind_.pop(snapshot)) {
+        rewinding_ = false;
+        return;
     }
+    sim_.restore(snapshot);
+    recorder_.rewind_to(sim_);
+    publish_state();
+}
+
+void Game::publish_state() {
+    if (!spectator_) return;
+    Snapshot snapshot;
+    sim_.snapshot(snapshot);
+    spectator_->publish(snapshot);
+}
+
+void Game::burst(sf::Vector2i cell, std::size_t count, sf::Color color) {
+    const auto half = static_cast<float>(Config::cell_size) / 2.f;
+    const sf::Vector2f center =
+        Board::grid_to_pixel(cell, Config::cell_size) + sf::Vector2f{half, half};
+    particles_.burst(center, count, color, Config::particle_speed, Config::particle_lifetime);
 }
 
 void Game::start_game() {
-    snake_.reset(settings_.grid_size, settings_.grid_size);
-    board_ = Board(settings_.grid_size, settings_.grid_size);
-    board_.spawn_food(snake_);
-    score_ = 0;
+    sim_ = new_simulation();
+    rewind_.clear();
+    rewinding_ = false;
+    submitted_.reset();
+    particles_.clear();
+    recorder_.begin(sim_);
+    heatmap_.record_start(sim_);
+    publish_state();
     is_new_high_score_ = false;
     state_ = GameState::Playing;
     last_tick_ = Clock::now();
-    std::print("[snake] New game started\n");
+    start_bots();
+    Log::info("New game started");
+}
+
+void Game::start_bots() {
+    bots_.clear();
+    for (int i = 1; i < settings_.split_games; ++i) {
+        // Alternate the two heuristics so their boards can be compared side by side
+        Bot bot{.sim = new_simulation(),
+                .rng = Rng(Rng::random_seed()),
+                .pathing = i % 2 == 0,
+                .last_tick = last_tick_};
+        if (bot.pathing) bot.sim.enable_distance_field();
+        bots_.push_back(std::move(bot));
+    }
+}
+
+void Game::load_leaderboard() {
+    if (leaderboard_.load(Config::leaderboard_path)) return;
+
+    // First run after the leaderboard replaced highscore.txt: keep the old best under the
+    // default configuration, which was the only one before settings existed
+    std::ifstream legacy(Config::legacy_highscore_path);
+    int score = 0;
+    if (legacy >> score && score > 0) {
+        leaderboard_.submit(LeaderboardKey::open_board(Config::grid_width), Config::initial_tick,
+                            score, 0);
+        writer_.write(Config::leaderboard_path, leaderboard_.serialize());
+        Log::info("Imported high score {} from {}", score, Config::legacy_highscore_path);
+    }
+}
+
+void Game::write_trace() {
+    if (Trace::flush(Config::trace_path)) {
+        Log::info("Trace written to {}", Config::trace_path);
+    } else {
+        Log::error("Failed to write trace to {}", Config::trace_path);
+    }
 }
 
 std::chrono::milliseconds Game::tick_interval() const {
-    const int speedups = score_ / Config::speed_increment_score;
-    auto ms = settings_.starting_speed - std::chrono::milliseconds(speedups * 10);
-    return std::max(ms, Config::min_tick);
+    return sim_.tick_interval();
+}
+
+const Level* Game::selected_level() const {
+    return find_level(levels_, settings_.level);
+}
+
+Simulation Game::new_simulation() const {
+    if (const Level* level = selected_level()) {
+        return Simulation(*level, settings_.starting_speed, Rng::random_seed());
+    }
+    return Simulation(settings_.grid_size, settings_.grid_size, settings_.starting_speed,
+                      Rng::random_seed());
+}
+
+LeaderboardKey Game::board_key() const {
+    if (const Level* level = selected_level()) return LeaderboardKey::for_level(level->name);
+    return LeaderboardKey::open_board(settings_.grid_size);
 }
 
 void Game::cycle_grid_size(int dir) {
@@ -322,6 +604,44 @@ void Game::cycle_speed(int dir) {
     settings_.starting_speed = std::chrono::milliseconds(speeds[idx]);
 }
 
+void Game::cycle_ai_rollouts(int dir) {
+    static constexpr std::array budgets = {Settings::ai_rollouts_low, Settings::ai_rollouts_medium,
+                                           Settings::ai_rollouts_high};
+    int idx = 0;
+    for (int i = 0; i < 3; ++i) {
+        if (budgets[i] == settings_.ai_rollouts) {
+            idx = i;
+            break;
+        }
+    }
+    idx = (idx + dir + 3) % 3;
+    settings_.ai_rollouts = budgets[idx];
+}
+
+void Game::cycle_level(int dir) {
+    // The open grid first, then the pack in order
+    const int count = levels_ ? static_cast<int>(levels_->size()) + 1 : 1;
+    int idx = 0;
+    if (levels_) {
+        if (const auto found = levels_->find(settings_.level)) idx = static_cast<int>(*found) + 1;
+    }
+    idx = (idx + dir + count) % count;
+    settings_.level = idx == 0 ? "" : std::string(levels_->level(idx - 1).name);
+}
+
+void Game::cycle_split_games(int dir) {
+    static constexpr std::array counts = {1, 4, 9, 16};
+    int idx = 0;
+    for (int i = 0; i < 4; ++i) {
+        if (counts[i] == settings_.split_games) {
+            idx = i;
+            break;
+        }
+    }
+    idx = (idx + dir + 4) % 4;
+    settings_.split_games = counts[idx];
+}
+
 std::string Game::speed_label() const {
     const int ms = static_cast<int>(settings_.starting_speed.count());
     if (ms == Settings::speed_slow) return "Slow";
@@ -331,16 +651,19 @@ std::string Game::speed_label() const {
 }
 
 void Game::apply_settings_changes() {
-    const int win_size = settings_.window_size();
+    const int win_size = window_size(settings_, selected_level());
     window_.setSize({static_cast<unsigned>(win_size), static_cast<unsigned>(win_size)});
     auto view_size = static_cast<float>(win_size);
     game_view_ = sf::View(sf::FloatRect({0.f, 0.f}, {view_size, view_size}));
     game_view_.setViewport(sf::FloatRect({0.f, 0.f}, {1.f, 1.f}));
 
-    board_ = Board(settings_.grid_size, settings_.grid_size);
-    snake_.reset(settings_.grid_size, settings_.grid_size);
-    board_.spawn_food(snake_);
+    sim_ = new_simulation();
+    rewind_.clear();
+    bots_.clear(); // the menu shows one board until the next game starts
+    // Counts from another board or level would not line up with this one
+    heatmap_ = Heatmap(sim_.board().width(), sim_.board().height());
 
-    std::print("[snake] Settings applied: grid={}, speed={}ms\n", settings_.grid_size,
-               settings_.starting_speed.count());
+    Log::info("Settings applied: grid={}, level={}, speed={}ms, games={}", settings_.grid_size,
+              selected_level() ? settings_.level : "open", settings_.starting_speed.count(),
+              settings_.split_games);
 }
@@ -1,24 +1,47 @@
 #pragma once
 
 #include "Board.hpp"
-#include "HighScore.hpp"
+#include "Engine.hpp"
+#include "FileIO.hpp"
+#include "Heatmap.hpp"
+#include "Leaderboard.hpp"
+#include "Level.hpp"
+#include "Mcts.hpp"
+#include "Particles.hpp"
 #include "Renderer.hpp"
+#include "Rng.hpp"
+#include "Replay.hpp"
 #include "Settings.hpp"
-#include "Snake.hpp"
+#include "Simulation.hpp"
+#include "Snapshot.hpp"
+#include "Spectator.hpp"
+#include "TimerWheel.hpp"
 
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/View.hpp>
 
 #include <chrono>
+#include <cstdint>
 #include <expected>
+#include <future>
+#include <optional>
 #include <random>
 #include <string>
+#include <utility>
+#include <vector>
 
 enum class GameState { Menu, Playing, Paused, GameOver, Settings };
 
 class Game {
 public:
-    static std::expected<Game, std::string> create();
+    using Clock = std::chrono::steady_clock;
+
+    // launched: when main() started, for reporting the time to the first presented frame
+    static std::expected<Game, std::string> create(Clock::time_point launched);
+    // Publishes the player's state to feed after every change from now on
+    void set_spectator(SpectatorFeed feed) { spectator_ = std::move(feed); }
+    // Drives the autopilot (M) with an external engine instead of the built-in search
+    void set_engine(Engine engine) { engine_ = std::move(engine); }
     void run();
 
 private:
@@ -28,42 +51,94 @@ private:
     void handle_key(sf::Keyboard::Key key);
     void handle_settings_key(sf::Keyboard::Key key);
     void update();
+    void rewind();
+    void think();
+    void publish_state();
     void start_game();
+    void start_bots();
+    void update_bots(Clock::time_point now);
     void apply_settings_changes();
+    void write_trace();
+    void load_leaderboard();
+    void burst(sf::Vector2i cell, std::size_t count, sf::Color color);
 
     [[nodiscard]] std::chrono::milliseconds tick_interval() const;
 
+    // The pack level named in settings_, or nullptr for the open grid
+    [[nodiscard]] const Level* selected_level() const;
+    [[nodiscard]] Simulation new_simulation() const;
+    // Leaderboard table key: the grid size, or the level's name
+    [[nodiscard]] LeaderboardKey board_key() const;
+
     // Settings screen helpers
     void cycle_grid_size(int dir);
     void cycle_speed(int dir);
+    void cycle_ai_rollouts(int dir);
+    void cycle_level(int dir);
+    void cycle_split_games(int dir);
     [[nodiscard]] std::string speed_label() const;
 
     sf::RenderWindow window_;
     Renderer renderer_;
-    Snake snake_;
-    Board board_;
+    Simulation sim_;
     Settings settings_;
-    HighScore high_score_;
+    Leaderboard leaderboard_;
+    std::optional<LevelPack> levels_; // mapped for the whole run; sim_ points into it
+    AsyncFileWriter writer_;
 
     GameState state_ = GameState::Menu;
-    int score_ = 0;
     bool is_new_high_score_ = false;
+    std::optional<LeaderboardEntry> submitted_; // this game's entry, once it has ended
+
+    // Rewind: one snapshot per tick, popped once per frame while the key is held
+    RewindBuffer rewind_;
+    bool rewinding_ = false;
+    ReplayRecorder recorder_;
+    std::optional<SpectatorFeed> spectator_;
+
+    // Autopilot: the next move is searched in the background during the current tick
+    Mcts mcts_;
+    std::future<Direction> ai_move_;
+    std::uint32_t ai_move_tick_ = 0;
+    bool autopilot_ = false;
+    std::optional<Engine> engine_; // sent each state as the tick ends, polled when the next is due
+
+    // Split screen: bots on their own boards beside sim_, each ticking at its own speed and
+    // restarting when it dies
+    struct Bot {
+        Simulation sim;
+        Rng rng;
+        bool pathing; // steers by the board's distance field, not straight-line distance
+        Clock::time_point last_tick;
+    };
+    std::vector<Bot> bots_;
+    std::vector<GameTile> tiles_; // rebuilt every frame; keeps its capacity
 
     // Timing
-    using Clock = std::chrono::steady_clock;
+    Clock::time_point launched_;
+    bool presented_first_frame_ = false;
     Clock::time_point last_tick_;
     Clock::time_point last_frame_time_;
     Clock::time_point game_start_time_;
 
-    // Screen shake
-    float shake_timer_ = 0.f;
+    // Frame-time effects on a wheel clocked in milliseconds since launch
+    enum class Effect : std::uint8_t { Shake };
+    TimerWheel<Effect> effects_;
+    TimerWheel<Effect>::Handle shake_;
     std::mt19937 shake_rng_{std::random_device{}()};
 
+    // Bursts on eating and death, in board pixels
+    ParticleSystem particles_{Config::max_particles, Rng::random_seed()};
+
+    // Where the snake has been across every game this session, shown with H
+    Heatmap heatmap_{Config::grid_width, Config::grid_height};
+    bool show_heatmap_ = false;
+
     // View for letterboxing
     sf::View game_view_;
 
     // Settings screen state
     int settings_cursor_ = 0;
     bool settings_binding_mode_ = false;
-    static constexpr int settings_item_count = 8;
+    static constexpr int settings_item_count = 11;
 };
@@ -0,0 +1,69 @@
+#include "Heatmap.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <iterator>
+
+Heatmap::Heatmap(int width, int height) : width_(width), height_(height) {
+    for (auto& counts : counts_) counts.assign(static_cast<std::size_t>(width * height), 0);
+}
+
+void Heatmap::record_start(const Simulation& sim) {
+    // The first food is placed by the constructor, not by a step
+    add(HeatCounter::Food, sim.board().food_position());
+}
+
+void Heatmap::merge(const Heatmap& other) {
+    for (std::size_t c = 0; c < heat_counter_count; ++c) {
+        auto& mine = counts_[c];
+        const auto& theirs = other.counts_[c];
+        const std::size_t n = std::min(mine.size(), theirs.size());
+        for (std::size_t i = 0; i < n; ++i) mine[i] += theirs[i];
+    }
+}
+
+void Heatmap::clear() {
+    for (auto& counts : counts_) std::ranges::fill(counts, 0);
+}
+
+std::uint64_t Heatmap::max(HeatCounter counter) const {
+    const auto values = counts(counter);
+    return values.empty() ? 0 : std::ranges::max(values);
+}
+
+std::string Heatmap::to_csv() const {
+    std::string out = "x,y,visits,deaths,food,bonus\n";
+    auto it = std::back_inserter(out);
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            const sf::Vector2i cell{x, y};
+            std::format_to(it, "{},{},{},{},{},{}\n", x, y, at(HeatCounter::Visits, cell),
+                           at(HeatCounter::Deaths, cell), at(HeatCounter::Food, cell),
+                           at(HeatCounter::Bonus, cell));
+        }
+    }
+    return out;
+}
+
+Bytes Heatmap::to_pgm(HeatCounter counter) const {
+    const std::string header = std::format("P5\n{} {}\n255\n", width_, height_);
+    Bytes out(header.begin(), header.end());
+    const auto peak = static_cast<double>(std::max<std::uint64_t>(max(counter), 1));
+    const double scale = 255.0 / std::log1p(peak);
+    for (const std::uint64_t count : counts(counter)) {
+        const double level = std::log1p(static_cast<double>(count)) * scale;
+        out.push_back(static_cast<std::uint8_t>(std::lround(std::min(level, 255.0))));
+    }
+    return out;
+}
+
+const char* Heatmap::name(HeatCounter counter) {
+    switch (counter) {
+    case HeatCounter::Visits: return "visits";
+    case HeatCounter::Deaths: return "deaths";
+    case HeatCounter::Food: return "food";
+    case HeatCounter::Bonus: return "bonus";
+    }
+    return "";
+}
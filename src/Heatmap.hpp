@@ -0,0 +1,72 @@
+#pragma once
+
+#include "FileIO.hpp"
+#include "Simulation.hpp"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+enum class HeatCounter { Visits, Deaths, Food, Bonus };
+inline constexpr std::size_t heat_counter_count = 4;
+
+// Per-cell counters accumulated over many games: cells the head entered, where games ended,
+// where food appeared and where bonuses were eaten. Each counter is its own row-major array and
+// recording a tick is one increment, so bulk runs give every thread its own Heatmap and merge()
+// them when the batch is done.
+class Heatmap {
+public:
+    Heatmap(int width, int height);
+
+    // Call once per game before the first step, then after every step
+    void record_start(const Simulation& sim);
+    // Inline so bulk runs pay an increment and a few predictable branches per tick
+    void record(const Simulation& sim, const TickEvents& events) {
+        const sf::Vector2i head = sim.snake().head();
+        add(HeatCounter::Visits, head);
+        if (events.died) add(HeatCounter::Deaths, head);
+        if (events.ate_food) add(HeatCounter::Food, sim.board().food_position());
+        if (events.ate_bonus) add(HeatCounter::Bonus, head);
+    }
+
+    // Adds other's counts; the dimensions must match
+    void merge(const Heatmap& other);
+    void clear();
+
+    [[nodiscard]] int width() const { return width_; }
+    [[nodiscard]] int height() const { return height_; }
+    [[nodiscard]] std::span<const std::uint64_t> counts(HeatCounter counter) const {
+        return counts_[static_cast<std::size_t>(counter)];
+    }
+    [[nodiscard]] std::uint64_t at(HeatCounter counter, sf::Vector2i cell) const {
+        return counts(counter)[index(cell)];
+    }
+    [[nodiscard]] std::uint64_t max(HeatCounter counter) const;
+
+    // One row per cell: x,y,visits,deaths,food,bonus
+    [[nodiscard]] std::string to_csv() const;
+    // Binary 8-bit greyscale, one pixel per cell, log-scaled so rare cells stay visible
+    [[nodiscard]] Bytes to_pgm(HeatCounter counter) const;
+
+    static const char* name(HeatCounter counter);
+
+private:
+    // Cells off the board (a head that left it) count against the nearest edge cell
+    [[nodiscard]] std::size_t index(sf::Vector2i p) const {
+        const int x = p.x < 0 ? 0 : (p.x >= width_ ? width_ - 1 : p.x);
+        const int y = p.y < 0 ? 0 : (p.y >= height_ ? height_ - 1 : p.y);
+        return static_cast<std::size_t>(y * width_ + x);
+    }
+    void add(HeatCounter counter, sf::Vector2i cell) {
+        ++counts_[static_cast<std::size_t>(counter)][index(cell)];
+    }
+
+    int width_;
+    int height_;
+    std::array<std::vector<std::uint64_t>, heat_counter_count> counts_;
+};
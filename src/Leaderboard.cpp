@@ -0,0 +1,142 @@
+#include "Leaderboard.hpp"
+
+#include "Config.hpp"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iterator>
+
+namespace {
+
+constexpr std::array<char, 4> magic = {'S', 'N', 'K', 'L'};
+// 2 keyed level tables by name rather than by 100 + the level's index in its pack
+constexpr std::uint16_t format_version = 2;
+
+} // namespace
+
+bool Leaderboard::load(const std::string& path) {
+    tables_.clear();
+    const auto contents = read_file(path);
+    return contents && parse(*contents);
+}
+
+// "SNKL", u16 version, u16 table count, then per table: u8 grid size (0 for a level),
+// u8 level name length and its bytes (0 for an open board), u8 entry count, u16 speed in ms,
+// and per entry: i32 score, i64 time. Version 1 had no name.
+Bytes Leaderboard::serialize() const {
+    Bytes out(magic.begin(), magic.end());
+    put_le(out, format_version);
+    put_le(out, static_cast<std::uint16_t>(tables_.size()));
+    for (const auto& table : tables_) {
+        // Pack names are far shorter; a longer one is cut rather than corrupting the file
+        const std::size_t name = std::min<std::size_t>(table.level.size(), 255);
+        put_le(out, static_cast<std::uint8_t>(table.grid_size));
+        put_le(out, static_cast<std::uint8_t>(name));
+        out.insert(out.end(), table.level.begin(),
+                   table.level.begin() + static_cast<std::ptrdiff_t>(name));
+        put_le(out, static_cast<std::uint8_t>(table.entries.size()));
+        put_le(out, static_cast<std::uint16_t>(table.speed_ms));
+        for (const auto& entry : table.entries) {
+            put_le(out, static_cast<std::int32_t>(entry.score));
+            put_le(out, entry.time);
+        }
+    }
+    return out;
+}
+
+bool Leaderboard::parse(std::span<const std::uint8_t> bytes) {
+    tables_.clear();
+    ByteReader in(bytes);
+    std::array<char, 4> header{};
+    std::uint16_t version = 0;
+    std::uint16_t table_count = 0;
+    if (!in.get(header) || header != magic || !in.get(version) || version < 1 ||
+        version > format_version || !in.get(table_count)) {
+        return false;
+    }
+
+    std::vector<Table> tables(table_count);
+    for (auto& table : tables) {
+        std::uint8_t grid = 0;
+        std::uint8_t count = 0;
+        std::uint16_t speed = 0;
+        if (!in.get(grid)) return false;
+        table.grid_size = grid;
+        if (version >= 2) {
+            std::uint8_t length = 0;
+            if (!in.get(length) || length > in.remaining()) return false;
+            table.level.resize(length);
+            for (char& c : table.level) {
+                if (!in.get(c)) return false;
+            }
+        }
+        if (!in.get(count) || !in.get(speed) || count > max_entries) return false;
+        table.speed_ms = speed;
+        table.entries.resize(count);
+        for (auto& entry : table.entries) {
+            std::int32_t score = 0;
+            if (!in.get(score) || !in.get(entry.time)) return false;
+            entry.score = score;
+        }
+    }
+    // Version 1 keyed a level's table by 100 + its index in whichever pack was open, which
+    // names no level reliably, so those scores are dropped
+    std::erase_if(tables, [](const Table& t) { return t.grid_size > Config::max_grid_size; });
+    tables_ = std::move(tables);
+    return true;
+}
+
+std::optional<std::size_t> Leaderboard::submit(const LeaderboardKey& board,
+                                               std::chrono::milliseconds speed, int score,
+                                               std::int64_t time) {
+    auto it = std::ranges::find_if(tables_, [&](const Table& t) { return t.is(board, speed); });
+    if (it == tables_.end()) {
+        tables_.push_back(
+            {board.grid_size, std::string(board.level), static_cast<int>(speed.count()), {}});
+        it = std::prev(tables_.end());
+    }
+
+    auto& entries = it->entries;
+    const auto pos = std::ranges::upper_bound(entries, score, std::greater<>{},
+                                              &LeaderboardEntry::score);
+    const auto rank = static_cast<std::size_t>(pos - entries.begin());
+    if (rank >= max_entries) return std::nullopt;
+
+    entries.insert(pos, {score, time});
+    if (entries.size() > max_entries) entries.pop_back();
+    return rank;
+}
+
+std::optional<std::size_t> Leaderboard::replace(const LeaderboardKey& board,
+                                                std::chrono::milliseconds speed,
+                                                const LeaderboardEntry& previous, int score,
+                                                std::int64_t time) {
+    for (Table& table : tables_) {
+        if (!table.is(board, speed)) continue;
+        // Gone already if later scores pushed it off the table
+        if (const auto it = std::ranges::find(table.entries, previous); it != table.entries.end()) {
+            table.entries.erase(it);
+        }
+    }
+    return submit(board, speed, score, time);
+}
+
+int Leaderboard::best(const LeaderboardKey& board, std::chrono::milliseconds speed) const {
+    const Table* table = find(board, speed);
+    return table != nullptr && !table->entries.empty() ? table->entries.front().score : 0;
+}
+
+std::span<const LeaderboardEntry> Leaderboard::entries(const LeaderboardKey& board,
+                                                       std::chrono::milliseconds speed) const {
+    const Table* table = find(board, speed);
+    if (table == nullptr) return {};
+    return table->entries;
+}
+
+const Leaderboard::Table* Leaderboard::find(const LeaderboardKey& board,
+                                            std::chrono::milliseconds speed) const {
+    const auto it =
+        std::ranges::find_if(tables_, [&](const Table& t) { return t.is(board, speed); });
+    return it == tables_.end() ? nullptr : &*it;
+}
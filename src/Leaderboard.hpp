@@ -0,0 +1,74 @@
+#pragma once
+
+#include "FileIO.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct LeaderboardEntry {
+    int score = 0;
+    std::int64_t time = 0; // seconds since the Unix epoch
+
+    friend bool operator==(const LeaderboardEntry&, const LeaderboardEntry&) = default;
+};
+
+// Which board a table is for: an open board by its size, or a level by its name, so a level
+// keeps its scores whatever pack it is loaded from and wherever the pack lists it
+struct LeaderboardKey {
+    int grid_size = 0;      // 0 for a level
+    std::string_view level; // LevelPack name; empty for an open board
+
+    static LeaderboardKey open_board(int grid_size) { return {grid_size, {}}; }
+    static LeaderboardKey for_level(std::string_view name) { return {0, name}; }
+};
+
+// Top scores per (board, starting speed) configuration, best first. Pure in-memory state
+// with a compact binary encoding; Game persists it through an AsyncFileWriter.
+class Leaderboard {
+public:
+    static constexpr std::size_t max_entries = 10;
+
+    // Replaces the contents with the file's; false (leaving it empty) when missing or corrupt
+    bool load(const std::string& path);
+    [[nodiscard]] Bytes serialize() const;
+    bool parse(std::span<const std::uint8_t> bytes);
+
+    // Inserts the score if it makes the table, returning its 0-based rank. Equal scores rank
+    // below the ones already there.
+    std::optional<std::size_t> submit(const LeaderboardKey& board, std::chrono::milliseconds speed,
+                                      int score, std::int64_t time);
+    // Removes previous, an entry submit() added, then submits score in its place; for a game
+    // that ends again after being rewound
+    std::optional<std::size_t> replace(const LeaderboardKey& board, std::chrono::milliseconds speed,
+                                       const LeaderboardEntry& previous, int score,
+                                       std::int64_t time);
+
+    // Best score for the configuration, 0 when it has none
+    [[nodiscard]] int best(const LeaderboardKey& board, std::chrono::milliseconds speed) const;
+    [[nodiscard]] std::span<const LeaderboardEntry> entries(const LeaderboardKey& board,
+                                                            std::chrono::milliseconds speed) const;
+
+private:
+    struct Table {
+        int grid_size;
+        std::string level;
+        int speed_ms;
+
+        [[nodiscard]] bool is(const LeaderboardKey& board, std::chrono::milliseconds speed) const {
+            return grid_size == board.grid_size && level == board.level &&
+                   speed_ms == speed.count();
+        }
+        std::vector<LeaderboardEntry> entries;
+    };
+
+    [[nodiscard]] const Table* find(const LeaderboardKey& board,
+                                    std::chrono::milliseconds speed) const;
+
+    std::vector<Table> tables_; // a handful of configurations, searched linearly
+};
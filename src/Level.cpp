@@ -0,0 +1,320 @@
+#include "Level.hpp"
+
+#include "Config.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <utility>
+
+static_assert(std::endian::native == std::endian::little,
+              "level packs are mapped in place and stored little-endian");
+
+namespace {
+
+constexpr std::array<char, 4> magic = {'S', 'N', 'K', 'P'};
+constexpr std::uint16_t format_version = 1;
+constexpr std::size_t header_size = 16;
+constexpr std::size_t name_size = LevelPack::max_name_length + 1;
+constexpr std::size_t record_size = 48;
+constexpr int min_level_size = 5;
+
+std::size_t word_count(int width, int height) {
+    return (static_cast<std::size_t>(width * height) + 63) / 64;
+}
+
+bool test_bit(std::span<const std::uint64_t> words, std::size_t i) {
+    return ((words[i / 64] >> (i % 64)) & 1U) != 0;
+}
+
+std::optional<Direction> spawn_marker(char c) {
+    switch (c) {
+    case '^': return Direction::Up;
+    case 'v': return Direction::Down;
+    case '<': return Direction::Left;
+    case '>': return Direction::Right;
+    default: return std::nullopt;
+    }
+}
+
+void align(Bytes& out, std::size_t alignment) {
+    out.resize((out.size() + alignment - 1) / alignment * alignment);
+}
+
+// Typed view of a block inside the mapping, whose base is page-aligned; callers check that
+// offset is aligned for T and the block lies within the file
+template <typename T>
+std::span<const T> view(std::span<const std::uint8_t> bytes, std::size_t offset,
+                        std::size_t count) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return {reinterpret_cast<const T*>(bytes.data() + offset), count};
+}
+
+} // namespace
+
+Level Level::open_board(int width, int height) {
+    Level level;
+    level.width = width;
+    level.height = height;
+    level.spawn = {width / 2, height / 2};
+    return level;
+}
+
+std::expected<LevelSpec, std::string> parse_level(std::string name, std::string_view text) {
+    if (name.empty() || name.size() > LevelPack::max_name_length) {
+        return std::unexpected(std::format("Level name '{}' must be 1-{} characters", name,
+                                           LevelPack::max_name_length));
+    }
+
+    std::vector<std::string_view> rows;
+    while (!text.empty()) {
+        const auto eol = text.find('\n');
+        std::string_view line = text.substr(0, eol);
+        text = eol == std::string_view::npos ? std::string_view{} : text.substr(eol + 1);
+        if (line.ends_with('\r')) line.remove_suffix(1);
+        if (!line.empty() && !line.starts_with(';')) rows.push_back(line);
+    }
+
+    LevelSpec spec;
+    spec.name = std::move(name);
+    spec.height = static_cast<int>(rows.size());
+    spec.width = rows.empty() ? 0 : static_cast<int>(rows.front().size());
+    if (spec.width < min_level_size || spec.height < min_level_size ||
+        spec.width > Config::max_grid_size || spec.height > Config::max_grid_size) {
+        return std::unexpected(std::format("{}: size {}x{} is outside {}-{}", spec.name,
+                                           spec.width, spec.height, min_level_size,
+                                           Config::max_grid_size));
+    }
+    spec.walls.assign(word_count(spec.width, spec.height), 0);
+
+    std::array<std::optional<sf::Vector2i>, 26> portal_ends{};
+    int spawns = 0;
+    for (int y = 0; y < spec.height; ++y) {
+        const std::string_view row = rows[static_cast<std::size_t>(y)];
+        if (std::cmp_not_equal(row.size(), spec.width)) {
+            return std::unexpected(std::format("{}: row {} has {} cells, expected {}", spec.name,
+                                               y + 1, row.size(), spec.width));
+        }
+        for (int x = 0; x < spec.width; ++x) {
+            const char c = row[static_cast<std::size_t>(x)];
+            const auto i = static_cast<std::size_t>(y * spec.width + x);
+            if (const auto direction = spawn_marker(c)) {
+                spec.spawn = {x, y};
+                spec.spawn_direction = *direction;
+                ++spawns;
+                continue;
+            }
+            switch (c) {
+            case '#': spec.walls[i / 64] |= std::uint64_t{1} << (i % 64); break;
+            case '.': break;
+            default: {
+                if (c < 'A' || c > 'Z') {
+                    return std::unexpected(std::format("{}: unexpected '{}' at row {} column {}",
+                                                       spec.name, c, y + 1, x + 1));
+                }
+                auto& first = portal_ends[static_cast<std::size_t>(c - 'A')];
+                if (!first) {
+                    first = sf::Vector2i{x, y};
+                    break;
+                }
+                if (first->x < 0) {
+                    return std::unexpected(
+                        std::format("{}: portal {} has more than two ends", spec.name, c));
+                }
+                spec.portals.push_back(
+                    {static_cast<std::uint8_t>(first->x), static_cast<std::uint8_t>(first->y),
+                     static_cast<std::uint8_t>(x), static_cast<std::uint8_t>(y)});
+                first = sf::Vector2i{-1, -1}; // paired
+                break;
+            }
+            }
+        }
+    }
+
+    if (spawns != 1) {
+        return std::unexpected(std::format("{}: expected one spawn, found {}", spec.name, spawns));
+    }
+    for (std::size_t letter = 0; letter < portal_ends.size(); ++letter) {
+        if (portal_ends[letter] && portal_ends[letter]->x >= 0) {
+            return std::unexpected(std::format("{}: portal {} has only one end", spec.name,
+                                               static_cast<char>('A' + letter)));
+        }
+    }
+    // The starting body occupies the two cells behind the spawn
+    for (int k = 1; k <= 2; ++k) {
+        const sf::Vector2i cell = spec.spawn - direction_delta(spec.spawn_direction) * k;
+        const bool inside =
+            cell.x >= 0 && cell.x < spec.width && cell.y >= 0 && cell.y < spec.height;
+        const auto i = static_cast<std::size_t>(cell.y * spec.width + cell.x);
+        if (!inside || test_bit(spec.walls, i)) {
+            return std::unexpected(
+                std::format("{}: the starting body behind the spawn is blocked", spec.name));
+        }
+    }
+    return spec;
+}
+
+Bytes LevelPack::build(std::span<const LevelSpec> levels) {
+    // Data blocks first, so the records can point at them
+    const std::size_t data_start = header_size + record_size * levels.size();
+    Bytes data;
+    Bytes records;
+    for (const LevelSpec& level : levels) {
+        align(data, 8);
+        const auto walls_offset = static_cast<std::uint32_t>(data_start + data.size());
+        for (const std::uint64_t word : level.walls) {
+            put_le(data, word);
+        }
+
+        align(data, 8);
+        const auto free_offset = static_cast<std::uint32_t>(data_start + data.size());
+        std::uint16_t free_count = 0;
+        for (int i = 0; i < level.width * level.height; ++i) {
+            if (test_bit(level.walls, static_cast<std::size_t>(i))) continue;
+            put_le(data, static_cast<std::uint16_t>(i));
+            ++free_count;
+        }
+
+        align(data, 8);
+        const auto portals_offset = static_cast<std::uint32_t>(data_start + data.size());
+        for (const Portal& portal : level.portals) {
+            for (const std::uint8_t v : {portal.ax, portal.ay, portal.bx, portal.by}) {
+                put_le(data, v);
+            }
+        }
+
+        std::array<char, name_size> name{};
+        std::memcpy(name.data(), level.name.data(), std::min(level.name.size(), name_size - 1));
+        records.insert(records.end(), name.begin(), name.end());
+        put_le(records, static_cast<std::uint8_t>(level.width));
+        put_le(records, static_cast<std::uint8_t>(level.height));
+        put_le(records, static_cast<std::uint8_t>(level.spawn.x));
+        put_le(records, static_cast<std::uint8_t>(level.spawn.y));
+        put_le(records, static_cast<std::uint8_t>(level.spawn_direction));
+        put_le(records, static_cast<std::uint8_t>(level.portals.size()));
+        put_le(records, free_count);
+        put_le(records, walls_offset);
+        put_le(records, free_offset);
+        put_le(records, portals_offset);
+        put_le(records, std::uint32_t{0});
+    }
+    align(data, 8);
+
+    Bytes out(magic.begin(), magic.end());
+    put_le(out, format_version);
+    put_le(out, static_cast<std::uint16_t>(levels.size()));
+    put_le(out, static_cast<std::uint32_t>(data_start + data.size()));
+    put_le(out, std::uint32_t{0});
+    out.insert(out.end(), records.begin(), records.end());
+    out.insert(out.end(), data.begin(), data.end());
+    return out;
+}
+
+std::expected<LevelPack, std::string> LevelPack::open(const std::string& path) {
+    SNAKE_TRACE_ZONE("LevelPack::open");
+    auto file = MappedFile::open(path);
+    if (!file) return std::unexpected("Cannot open level pack " + path);
+    const auto bytes = file->bytes(); // stays valid when file moves into the pack
+
+    ByteReader in(bytes);
+    std::array<char, 4> header{};
+    std::uint16_t version = 0;
+    std::uint16_t count = 0;
+    std::uint32_t file_size = 0;
+    std::uint32_t reserved = 0;
+    if (!in.get(header) || header != magic || !in.get(version) || version != format_version ||
+        !in.get(count) || !in.get(file_size) || file_size != bytes.size() || !in.get(reserved) ||
+        in.remaining() < record_size * count) {
+        return std::unexpected("Invalid level pack " + path);
+    }
+
+    LevelPack pack(std::move(*file));
+    pack.levels_.reserve(count);
+    for (std::size_t r = 0; r < count; ++r) {
+        const std::size_t record = header_size + r * record_size;
+        std::array<char, name_size> name{};
+        std::uint8_t w = 0;
+        std::uint8_t h = 0;
+        std::uint8_t sx = 0;
+        std::uint8_t sy = 0;
+        std::uint8_t dir = 0;
+        std::uint8_t portal_count = 0;
+        std::uint16_t free_count = 0;
+        std::uint32_t walls_offset = 0;
+        std::uint32_t free_offset = 0;
+        std::uint32_t portals_offset = 0;
+        in.get(name);
+        in.get(w);
+        in.get(h);
+        in.get(sx);
+        in.get(sy);
+        in.get(dir);
+        in.get(portal_count);
+        in.get(free_count);
+        in.get(walls_offset);
+        in.get(free_offset);
+        in.get(portals_offset);
+        in.get(reserved);
+
+        const auto error = [&](std::string_view what) {
+            return std::unexpected(
+                std::format("Invalid level pack {}: level {} {}", path, r, what));
+        };
+        const std::size_t words = word_count(w, h);
+        const int cells = w * h;
+        if (w < min_level_size || h < min_level_size || w > Config::max_grid_size ||
+            h > Config::max_grid_size || sx >= w || sy >= h || dir > 3 || free_count > cells ||
+            name.back() != '\0') {
+            return error("has an invalid header");
+        }
+        if (walls_offset % 8 != 0 || free_offset % 2 != 0 || walls_offset > bytes.size() ||
+            free_offset > bytes.size() || portals_offset > bytes.size() ||
+            (bytes.size() - walls_offset) / 8 < words ||
+            (bytes.size() - free_offset) / 2 < free_count ||
+            (bytes.size() - portals_offset) / sizeof(Portal) < portal_count) {
+            return error("points outside the file");
+        }
+
+        Level level;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto* name_ptr = reinterpret_cast<const char*>(bytes.data() + record);
+        level.name = std::string_view(name_ptr, std::strlen(name_ptr));
+        level.width = w;
+        level.height = h;
+        level.spawn = {sx, sy};
+        level.spawn_direction = static_cast<Direction>(dir);
+        level.walls = view<std::uint64_t>(bytes, walls_offset, words);
+        level.free_cells = view<std::uint16_t>(bytes, free_offset, free_count);
+        level.portals = view<Portal>(bytes, portals_offset, portal_count);
+
+        // Checked once here so the game can index with them unchecked
+        for (const std::uint16_t cell : level.free_cells) {
+            if (cell >= cells || level.is_wall({cell % w, cell / w})) {
+                return error("lists a blocked free cell");
+            }
+        }
+        int walls = 0;
+        for (const std::uint64_t word : level.walls) {
+            walls += std::popcount(word);
+        }
+        // Stray bits past the last cell would also break Occupancy::nth_free's masking
+        if (walls + free_count != cells) return error("has inconsistent walls and free cells");
+        for (const Portal& portal : level.portals) {
+            if (portal.ax >= w || portal.bx >= w || portal.ay >= h || portal.by >= h) {
+                return error("has a portal outside the board");
+            }
+        }
+        pack.levels_.push_back(level);
+    }
+    return pack;
+}
+
+std::optional<std::size_t> LevelPack::find(std::string_view name) const {
+    for (std::size_t i = 0; i < levels_.size(); ++i) {
+        if (levels_[i].name == name) return i;
+    }
+    return std::nullopt;
+}
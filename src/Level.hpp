@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Direction.hpp"
+#include "FileIO.hpp"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A pair of linked cells: moving onto one puts the head on the other. Stored as-is in packs.
+struct Portal {
+    std::uint8_t ax;
+    std::uint8_t ay;
+    std::uint8_t bx;
+    std::uint8_t by;
+
+    [[nodiscard]] sf::Vector2i a() const { return {ax, ay}; }
+    [[nodiscard]] sf::Vector2i b() const { return {bx, by}; }
+};
+
+// Board geometry as views into a LevelPack's mapping, or an open board with no walls or portals.
+// Copying one copies pointers only, so the pack must outlive every Level taken from it.
+struct Level {
+    std::string_view name; // empty for an open board
+    int width = 0;
+    int height = 0;
+    sf::Vector2i spawn;    // head cell; the starting body extends behind it
+    Direction spawn_direction = Direction::Left;
+    std::span<const std::uint64_t> walls;      // Occupancy's word layout; empty when none
+    std::span<const std::uint16_t> free_cells; // row-major indices of every non-wall cell
+    std::span<const Portal> portals;
+
+    // Same start as a plain Snake::reset: centred, heading left
+    static Level open_board(int width, int height);
+
+    [[nodiscard]] int wall_count() const {
+        return walls.empty() ? 0 : width * height - static_cast<int>(free_cells.size());
+    }
+    // p must be in bounds
+    [[nodiscard]] bool is_wall(sf::Vector2i p) const {
+        if (walls.empty()) return false;
+        const auto i = static_cast<std::size_t>(p.y * width + p.x);
+        return ((walls[i / 64] >> (i % 64)) & 1U) != 0;
+    }
+    // Where the head lands when it moves onto cell: the linked cell for a portal, else cell
+    [[nodiscard]] sf::Vector2i portal_exit(sf::Vector2i cell) const {
+        for (const Portal& portal : portals) { // a handful at most
+            if (cell == portal.a()) return portal.b();
+            if (cell == portal.b()) return portal.a();
+        }
+        return cell;
+    }
+};
+
+// A level before packing, parsed from the text layout used in levels/*.txt:
+//   '#' wall, '.' floor, one of '^' 'v' '<' '>' for the spawn (head and heading),
+//   and each letter A-Z exactly twice for the two ends of a portal.
+// Rows must have equal length; lines starting with ';' are comments.
+struct LevelSpec {
+    std::string name;
+    int width = 0;
+    int height = 0;
+    sf::Vector2i spawn;
+    Direction spawn_direction = Direction::Left;
+    std::vector<std::uint64_t> walls;
+    std::vector<Portal> portals;
+};
+
+std::expected<LevelSpec, std::string> parse_level(std::string name, std::string_view text);
+
+// Read-only level collection memory-mapped from a pack file. Everything is validated in open(),
+// so level() is pointer arithmetic.
+//
+// Layout, little-endian with every array naturally aligned:
+//   header: "SNKP", u16 version, u16 level count, u32 file size, u32 reserved
+//   records: per level 24-byte NUL-padded name, u8 width, u8 height, u8 spawn x, u8 spawn y,
+//            u8 spawn direction, u8 portal count, u16 free cell count, u32 offsets of the wall
+//            words, free cell list and portals, u32 reserved
+//   data: u64 wall words, u16 free cells, 4-byte portals, each block 8-byte aligned
+class LevelPack {
+public:
+    static constexpr std::size_t max_name_length = 23;
+
+    static std::expected<LevelPack, std::string> open(const std::string& path);
+    [[nodiscard]] static Bytes build(std::span<const LevelSpec> levels);
+
+    [[nodiscard]] std::size_t size() const { return levels_.size(); }
+    [[nodiscard]] const Level& level(std::size_t i) const { return levels_[i]; }
+    [[nodiscard]] std::optional<std::size_t> find(std::string_view name) const;
+
+private:
+    explicit LevelPack(MappedFile file) : file_(std::move(file)) {}
+
+    MappedFile file_;
+    std::vector<Level> levels_; // views into file_
+};
@@ -0,0 +1,172 @@
+#include "Log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+
+LogQueue::LogQueue(std::size_t capacity)
+    : slots_(std::make_unique<Slot[]>(capacity)), mask_(capacity - 1) {
+    for (std::size_t i = 0; i < capacity; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool LogQueue::try_push(LogLevel level, std::string_view message) {
+    auto pos = enqueue_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &slots_[pos & mask_];
+        const auto seq = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::int64_t>(seq - pos);
+        if (diff == 0) {
+            if (enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false; // full
+        } else {
+            pos = enqueue_.load(std::memory_order_relaxed);
+        }
+    }
+
+    const auto size = std::min(message.size(), max_message);
+    slot->record.level = level;
+    slot->record.size = static_cast<std::uint16_t>(size);
+    std::memcpy(slot->record.text.data(), message.data(), size);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogQueue::try_pop(Record& out) {
+    auto pos = dequeue_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &slots_[pos & mask_];
+        const auto seq = slot->sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::int64_t>(seq - (pos + 1));
+        if (diff == 0) {
+            if (dequeue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false; // empty
+        } else {
+            pos = dequeue_.load(std::memory_order_relaxed);
+        }
+    }
+
+    out.level = slot->record.level;
+    out.size = slot->record.size;
+    std::memcpy(out.text.data(), slot->record.text.data(), out.size);
+    slot->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+}
+
+namespace {
+
+constexpr std::size_t queue_capacity = 1024;
+constexpr auto writer_interval = std::chrono::milliseconds{5};
+
+class Logger {
+public:
+    Logger() : writer_([this](const std::stop_token& stop) { run(stop); }) {}
+
+    void push(LogLevel level, std::string_view message) {
+        if (queue_.try_push(level, message)) {
+            pushed_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void set_output(std::FILE* info, std::FILE* errors) {
+        if (info != nullptr) info_.store(info, std::memory_order_relaxed);
+        if (errors != nullptr) errors_.store(errors, std::memory_order_relaxed);
+    }
+
+    void flush() {
+        const auto target = pushed_.load(std::memory_order_relaxed);
+        while (written_.load(std::memory_order_acquire) < target) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+
+    [[nodiscard]] std::uint64_t dropped() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void run(const std::stop_token& stop) {
+        std::string out;
+        std::string err;
+        std::uint64_t reported_drops = 0;
+        for (;;) {
+            const bool stopping = stop.stop_requested();
+            std::uint64_t count = 0;
+            LogQueue::Record record;
+            while (queue_.try_pop(record)) {
+                append(record.level >= LogLevel::Warning ? err : out, record);
+                ++count;
+            }
+
+            const auto drops = dropped_.load(std::memory_order_relaxed);
+            if (drops != reported_drops) {
+                err += std::format("[snake] Warning: log queue full, dropped {} message(s)\n",
+                                   drops - reported_drops);
+                reported_drops = drops;
+            }
+
+            write(info_.load(std::memory_order_relaxed), out);
+            write(errors_.load(std::memory_order_relaxed), err);
+            written_.fetch_add(count, std::memory_order_release);
+
+            if (stopping) break;
+            if (count == 0) std::this_thread::sleep_for(writer_interval);
+        }
+    }
+
+    static void append(std::string& batch, const LogQueue::Record& record) {
+        batch += "[snake] ";
+        if (record.level == LogLevel::Warning) batch += "Warning: ";
+        if (record.level == LogLevel::Error) batch += "Error: ";
+        batch.append(record.text.data(), record.size);
+        batch += '\n';
+    }
+
+    static void write(std::FILE* file, std::string& batch) {
+        if (batch.empty()) return;
+        std::fwrite(batch.data(), 1, batch.size(), file);
+        std::fflush(file);
+        batch.clear();
+    }
+
+    LogQueue queue_{queue_capacity};
+    std::atomic<std::uint64_t> pushed_{0};
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::FILE*> info_{stdout};
+    std::atomic<std::FILE*> errors_{stderr};
+    // Last, so it starts after the members it uses; joining it at exit drains the queue
+    std::jthread writer_;
+};
+
+Logger& logger() {
+    static Logger instance;
+    return instance;
+}
+
+} // namespace
+
+void Log::push(LogLevel level, std::string_view message) {
+    logger().push(level, message);
+}
+
+void Log::set_output(std::FILE* info, std::FILE* errors) {
+    logger().set_output(info, errors);
+}
+
+void Log::flush() {
+    logger().flush();
+}
+
+std::uint64_t Log::dropped() {
+    return logger().dropped();
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+enum class LogLevel : std::uint8_t { Debug, Info, Warning, Error };
+
+// Bounded multi-producer queue of fixed-size log records (Vyukov's array queue): producers
+// claim a slot with one CAS and never wait; a full queue rejects the record instead.
+class LogQueue {
+public:
+    static constexpr std::size_t max_message = 240;
+
+    struct Record {
+        LogLevel level = LogLevel::Info;
+        std::uint16_t size = 0;
+        std::array<char, max_message> text{};
+    };
+
+    // capacity must be a power of two
+    explicit LogQueue(std::size_t capacity);
+
+    bool try_push(LogLevel level, std::string_view message);
+    bool try_pop(Record& out);
+
+    [[nodiscard]] std::size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> sequence;
+        Record record;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t mask_;
+    alignas(64) std::atomic<std::uint64_t> enqueue_{0};
+    alignas(64) std::atomic<std::uint64_t> dequeue_{0};
+};
+
+// Process-wide logger. Callers format into a stack buffer and enqueue; a background thread
+// writes batches to stdout (Debug, Info) and stderr (Warning, Error) every few milliseconds.
+// Logging never blocks: when the queue is full the record is dropped and counted, and the
+// writer reports the count once it catches up.
+class Log {
+public:
+    template <typename... Args>
+    static void write(LogLevel level, std::format_string<Args...> fmt, Args&&... args) {
+        if (level < min_level_.load(std::memory_order_relaxed)) return;
+        std::array<char, LogQueue::max_message> buf;
+        const auto result =
+            std::format_to_n(buf.data(), buf.size(), fmt, std::forward<Args>(args)...);
+        const auto size = std::min(static_cast<std::size_t>(result.size), buf.size());
+        push(level, std::string_view(buf.data(), size));
+    }
+
+    template <typename... Args>
+    static void debug(std::format_string<Args...> fmt, Args&&... args) {
+        write(LogLevel::Debug, fmt, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    static void info(std::format_string<Args...> fmt, Args&&... args) {
+        write(LogLevel::Info, fmt, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    static void warning(std::format_string<Args...> fmt, Args&&... args) {
+        write(LogLevel::Warning, fmt, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+    static void error(std::format_string<Args...> fmt, Args&&... args) {
+        write(LogLevel::Error, fmt, std::forward<Args>(args)...);
+    }
+
+    static void set_level(LogLevel level) { min_level_.store(level, std::memory_order_relaxed); }
+    // Redirects output, e.g. to a file when stdout is a slow pipe; null keeps the current stream
+    static void set_output(std::FILE* info, std::FILE* errors);
+
+    // Blocks until every record queued before the call has been written
+    static void flush();
+
+    [[nodiscard]] static std::uint64_t dropped();
+
+private:
+    static void push(LogLevel level, std::string_view message);
+
+    static inline std::atomic<LogLevel> min_level_{LogLevel::Info};
+};
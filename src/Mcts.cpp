@@ -0,0 +1,178 @@
+#include "Mcts.hpp"
+
+#include "Config.hpp"
+#include "Policy.hpp"
+#include "Rng.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+constexpr double value_scale = 1'000'000.0;
+
+std::size_t index_of(Direction dir) {
+    return static_cast<std::size_t>(dir);
+}
+
+// Survival dominates; food eaten within the horizon breaks ties between surviving lines
+double reward(const Simulation& sim, int start_score, int ticks, int horizon) {
+    const int gained = sim.score() - start_score;
+    const double food = 1.0 - std::exp(-0.5 * gained);
+    const double alive = sim.is_over() ? 0.5 * ticks / horizon : 1.0;
+    return 0.5 * alive + 0.5 * food;
+}
+
+} // namespace
+
+void Mcts::Node::reset() {
+    visits.store(0, std::memory_order_relaxed);
+    value.store(0, std::memory_order_relaxed);
+    for (auto& child : children) {
+        child.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+Mcts::Node* Mcts::Arena::allocate() {
+    const std::size_t block = used_ / block_nodes;
+    if (block == blocks_.size()) {
+        blocks_.push_back(std::make_unique<Node[]>(block_nodes));
+    }
+    Node* node = &blocks_[block][used_ % block_nodes];
+    ++used_;
+    node->reset();
+    return node;
+}
+
+Mcts::Mcts(int threads) : arenas_(static_cast<std::size_t>(std::max(threads, 1))) {}
+
+int Mcts::default_threads() {
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+}
+
+Direction Mcts::search(const Simulation& root, int rollouts, Clock::time_point deadline) {
+    SNAKE_TRACE_ZONE("Mcts::search");
+    for (auto& arena : arenas_) {
+        arena.reset();
+    }
+
+    Node* root_node = arenas_[0].allocate();
+    std::atomic<int> started{0};
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(arenas_.size() - 1);
+        for (std::size_t i = 1; i < arenas_.size(); ++i) {
+            workers.emplace_back([&, i] {
+                Trace::set_thread_name("mcts");
+                worker(i, root, root_node, rollouts, deadline, started);
+            });
+        }
+        worker(0, root, root_node, rollouts, deadline, started);
+    }
+
+    last_rollouts_ = static_cast<int>(root_node->visits.load(std::memory_order_relaxed));
+
+    Direction best = root.snake().direction();
+    std::uint32_t best_visits = 0;
+    for (const Direction dir : all_directions) {
+        const Node* child = root_node->children[index_of(dir)].load(std::memory_order_acquire);
+        if (!child) continue;
+        const std::uint32_t visits = child->visits.load(std::memory_order_relaxed);
+        if (visits > best_visits) {
+            best = dir;
+            best_visits = visits;
+        }
+    }
+    return best;
+}
+
+void Mcts::worker(std::size_t index, const Simulation& root, Node* root_node, int rollouts,
+                  Clock::time_point deadline, std::atomic<int>& started) {
+    SNAKE_TRACE_ZONE("Mcts::worker");
+    Arena& arena = arenas_[index];
+    Rng rng(Rng::mix(root.board().rng_state() ^ (index + 1)));
+    Simulation sim = root;
+    std::vector<Node*> path;
+
+    while (Clock::now() < deadline &&
+           started.fetch_add(1, std::memory_order_relaxed) < rollouts) {
+        // Copy-assignment reuses sim's storage, so it costs a copy of the runs, the occupancy
+        // words and the distance field, if any, where restore() rebuilds them cell by cell
+        sim = root;
+        const int start_score = sim.score();
+        int ticks = 0;
+
+        path.clear();
+        Node* node = root_node;
+        node->visits.fetch_add(1, std::memory_order_relaxed);
+        path.push_back(node);
+
+        // Selection and expansion: descend by UCT until a new child is created
+        while (!sim.is_over()) {
+            const double parent_visits =
+                std::max<double>(1.0, node->visits.load(std::memory_order_relaxed));
+            const std::size_t offset = rng.below(4);
+            Direction chosen = sim.snake().direction();
+            Node* next = nullptr;
+            bool expanded = false;
+            double best_score = -1.0;
+
+            for (std::size_t k = 0; k < all_directions.size(); ++k) {
+                const Direction dir = all_directions[(k + offset) % all_directions.size()];
+                if (is_opposite(dir, sim.snake().direction())) continue;
+
+                auto& slot = node->children[index_of(dir)];
+                Node* child = slot.load(std::memory_order_acquire);
+                if (!child) {
+                    Node* fresh = arena.allocate();
+                    if (slot.compare_exchange_strong(child, fresh, std::memory_order_acq_rel)) {
+                        child = fresh;
+                    }
+                    chosen = dir;
+                    next = child;
+                    expanded = true;
+                    break;
+                }
+
+                const double visits = child->visits.load(std::memory_order_relaxed);
+                double score = 2.0; // children just created by another worker go first
+                if (visits > 0.0) {
+                    const double value = static_cast<double>(
+                        child->value.load(std::memory_order_relaxed));
+                    score = value / value_scale / visits +
+                            Config::mcts_exploration * std::sqrt(std::log(parent_visits) / visits);
+                }
+                if (score > best_score) {
+                    best_score = score;
+                    chosen = dir;
+                    next = child;
+                }
+            }
+
+            sim.set_direction(chosen);
+            sim.step();
+            ++ticks;
+            next->visits.fetch_add(1, std::memory_order_relaxed);
+            path.push_back(next);
+            node = next;
+            if (expanded) break;
+        }
+
+        // Playout with the heuristic policy
+        const int horizon = ticks + Config::mcts_rollout_depth;
+        while (!sim.is_over() && ticks < horizon) {
+            sim.set_direction(heuristic_move(sim, rng));
+            sim.step();
+            ++ticks;
+        }
+
+        const auto value =
+            static_cast<std::uint64_t>(reward(sim, start_score, ticks, horizon) * value_scale);
+        for (Node* visited : path) {
+            visited->value.fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Simulation.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Tree-parallel Monte Carlo tree search over Simulation. Workers share one tree: statistics are
+// lock-free atomics (visits double as virtual loss), children are published with a CAS, and each
+// worker allocates nodes from its own arena so there is no allocator contention.
+class Mcts {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit Mcts(int threads = default_threads());
+
+    // All hardware threads but one, which is left to the frame loop
+    static int default_threads();
+
+    // Best move for root, stopping after `rollouts` playouts or at `deadline`, whichever is first
+    Direction search(const Simulation& root, int rollouts, Clock::time_point deadline);
+
+    [[nodiscard]] int last_rollouts() const { return last_rollouts_; }
+    [[nodiscard]] int threads() const { return static_cast<int>(arenas_.size()); }
+
+private:
+    struct Node {
+        std::atomic<std::uint32_t> visits{0};
+        std::atomic<std::uint64_t> value{0}; // sum of rewards in fixed point
+        std::array<std::atomic<Node*>, 4> children{};
+
+        void reset();
+    };
+
+    // Bump allocator over fixed-size blocks; reset() recycles every node at once
+    class Arena {
+    public:
+        Node* allocate();
+        void reset() { used_ = 0; }
+
+    private:
+        static constexpr std::size_t block_nodes = 4096;
+        std::vector<std::unique_ptr<Node[]>> blocks_;
+        std::size_t used_ = 0;
+    };
+
+    // Each rollout starts from a copy of root
+    void worker(std::size_t index, const Simulation& root, Node* root_node, int rollouts,
+                Clock::time_point deadline, std::atomic<int>& started);
+
+    std::vector<Arena> arenas_;
+    int last_rollouts_ = 0;
+};
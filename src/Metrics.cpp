@@ -0,0 +1,201 @@
+#include "Metrics.hpp"
+
+#include "Log.hpp"
+#include "Trace.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t max_request = 4096;
+constexpr timeval client_timeout{.tv_sec = 1, .tv_usec = 0};
+
+std::atomic<std::size_t> next_shard{0};
+
+void render_counter(std::string& out, const char* name, const char* help, std::uint64_t value) {
+    std::format_to(std::back_inserter(out), "# HELP {} {}\n# TYPE {} counter\n{} {}\n", name, help,
+                   name, name, value);
+}
+
+std::string system_error(const char* what) {
+    return std::format("Metrics server: {} failed: {}", what, std::strerror(errno));
+}
+
+void send_all(int client, std::string_view data) {
+#ifdef MSG_NOSIGNAL
+    constexpr int flags = MSG_NOSIGNAL;
+#else
+    constexpr int flags = 0; // SO_NOSIGPIPE is set on the socket instead
+#endif
+    while (!data.empty()) {
+        const ssize_t sent = ::send(client, data.data(), data.size(), flags);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return;
+        data.remove_prefix(static_cast<std::size_t>(sent));
+    }
+}
+
+// Reads one request and answers it; anything but GET /metrics gets a 404. A client that stalls
+// only delays later scrapes, never the game.
+void respond(int client) {
+    ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &client_timeout, sizeof(client_timeout));
+    ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &client_timeout, sizeof(client_timeout));
+#ifdef SO_NOSIGPIPE
+    const int one = 1;
+    ::setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+    std::string request;
+    std::array<char, 1024> buf;
+    while (request.size() < max_request && request.find("\r\n\r\n") == std::string::npos) {
+        const ssize_t got = ::recv(client, buf.data(), buf.size(), 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        request.append(buf.data(), static_cast<std::size_t>(got));
+    }
+
+    if (!request.starts_with("GET /metrics ") && !request.starts_with("GET /metrics?")) {
+        send_all(client, "HTTP/1.0 404 Not Found\r\n"
+                         "Content-Length: 0\r\nConnection: close\r\n\r\n");
+        return;
+    }
+    const std::string body = Metrics::render();
+    send_all(client, std::format("HTTP/1.0 200 OK\r\n"
+                                 "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                                 "Content-Length: {}\r\nConnection: close\r\n\r\n",
+                                 body.size()));
+    send_all(client, body);
+}
+
+} // namespace
+
+std::size_t ShardedCounter::shard_index() {
+    thread_local const std::size_t index =
+        next_shard.fetch_add(1, std::memory_order_relaxed) % shard_count;
+    return index;
+}
+
+std::uint64_t ShardedCounter::value() const {
+    std::uint64_t total = 0;
+    for (const Shard& shard : shards_) total += shard.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+void Histogram::render(std::string& out, const char* name, const char* help,
+                       double scale) const {
+    auto it = std::back_inserter(out);
+    std::format_to(it, "# HELP {} {}\n# TYPE {} histogram\n", name, help, name);
+    // Prometheus buckets are cumulative; the count is the +Inf bucket, so they always agree
+    std::uint64_t cumulative = 0;
+    for (std::size_t i = 0; i < bound_count_; ++i) {
+        cumulative += buckets_[i].load(std::memory_order_relaxed);
+        std::format_to(it, "{}_bucket{{le=\"{}\"}} {}\n", name,
+                       static_cast<double>(bounds_[i]) * scale, cumulative);
+    }
+    cumulative += buckets_[bound_count_].load(std::memory_order_relaxed);
+    std::format_to(it, "{}_bucket{{le=\"+Inf\"}} {}\n", name, cumulative);
+    std::format_to(it, "{}_sum {}\n{}_count {}\n", name,
+                   static_cast<double>(sum_.load(std::memory_order_relaxed)) * scale, name,
+                   cumulative);
+}
+
+std::string Metrics::render() {
+    std::string out;
+    render_counter(out, "snake_ticks_total", "Simulation ticks run by the game", ticks.value());
+    render_counter(out, "snake_frames_total", "Frames presented", frames.value());
+    render_counter(out, "snake_games_total", "Games played to game over", games.value());
+    render_counter(out, "snake_allocations_total", "Calls to operator new",
+                   allocations.value());
+    render_counter(out, "snake_log_dropped_total", "Log records dropped on a full queue",
+                   Log::dropped());
+    frame_time.render(out, "snake_frame_seconds", "Time between frames", 1e-6);
+    tick_lag.render(out, "snake_tick_lag_seconds", "How late ticks ran after falling due", 1e-6);
+    score.render(out, "snake_score", "Final score of each game", 1.0);
+    return out;
+}
+
+struct MetricsServer::Worker {
+    int listener = -1;
+    std::array<int, 2> wake{-1, -1}; // written on shutdown to end the poll
+    std::uint16_t port = 0;
+    std::jthread thread;
+
+    ~Worker() {
+        if (thread.joinable()) {
+            thread.request_stop();
+            const char byte = 0;
+            static_cast<void>(::write(wake[1], &byte, 1));
+            thread.join();
+        }
+        for (const int fd : {listener, wake[0], wake[1]}) {
+            if (fd >= 0) ::close(fd);
+        }
+    }
+
+    void run(const std::stop_token& stop) const {
+        Trace::set_thread_name("metrics");
+        std::array<pollfd, 2> fds{{{listener, POLLIN, 0}, {wake[0], POLLIN, 0}}};
+        while (!stop.stop_requested()) {
+            if (::poll(fds.data(), fds.size(), -1) < 0) {
+                if (errno == EINTR) continue;
+                Log::error("{}", system_error("poll"));
+                return;
+            }
+            if ((fds[1].revents & POLLIN) != 0) return;
+            if ((fds[0].revents & POLLIN) == 0) continue;
+            const int client = ::accept(listener, nullptr, nullptr);
+            if (client < 0) continue;
+            respond(client);
+            ::close(client);
+        }
+    }
+};
+
+std::expected<MetricsServer, std::string> MetricsServer::start(std::uint16_t port) {
+    auto worker = std::make_unique<Worker>();
+    worker->listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (worker->listener < 0) return std::unexpected(system_error("socket"));
+    const int one = 1;
+    ::setsockopt(worker->listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (::bind(worker->listener, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        return std::unexpected(system_error("bind"));
+    }
+    if (::listen(worker->listener, 8) != 0) return std::unexpected(system_error("listen"));
+    socklen_t length = sizeof(addr);
+    if (::getsockname(worker->listener, reinterpret_cast<sockaddr*>(&addr), &length) != 0) {
+        return std::unexpected(system_error("getsockname"));
+    }
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    worker->port = ntohs(addr.sin_port);
+    if (::pipe(worker->wake.data()) != 0) return std::unexpected(system_error("pipe"));
+
+    worker->thread =
+        std::jthread([w = worker.get()](const std::stop_token& stop) { w->run(stop); });
+    return MetricsServer(std::move(worker));
+}
+
+MetricsServer::MetricsServer(std::unique_ptr<Worker> worker) : worker_(std::move(worker)) {}
+MetricsServer::MetricsServer(MetricsServer&&) noexcept = default;
+MetricsServer& MetricsServer::operator=(MetricsServer&&) noexcept = default;
+MetricsServer::~MetricsServer() = default;
+
+std::uint16_t MetricsServer::port() const { return worker_->port; }
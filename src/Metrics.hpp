@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <initializer_list>
+#include <memory>
+#include <string>
+
+// Monotonic count for events raised on one thread. With a single writer a relaxed load and
+// store suffice, which avoids a locked read-modify-write on the game thread.
+class Counter {
+public:
+    void add(std::uint64_t n = 1) {
+        value_.store(value_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    [[nodiscard]] std::uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> value_{0};
+};
+
+// Counter split over cache-line-sized shards, each thread bumping its own, for events raised on
+// many threads at once (allocations); value() sums the shards. Constant-initialised, so it is
+// safe to use from operator new during static initialisation.
+class ShardedCounter {
+public:
+    void add(std::uint64_t n = 1) {
+        shards_[shard_index()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+    [[nodiscard]] std::uint64_t value() const;
+
+private:
+    static constexpr std::size_t shard_count = 16;
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> value{0};
+    };
+    static std::size_t shard_index();
+
+    std::array<Shard, shard_count> shards_{};
+};
+
+// Cumulative histogram over fixed upper bounds in integer units (microseconds, points), written
+// by one thread like Counter. observe() is a short scan and two relaxed stores; a reader may see
+// a sample in the sum before its bucket, which Prometheus tolerates.
+class Histogram {
+public:
+    static constexpr std::size_t max_bounds = 16;
+
+    // Ascending upper bounds; values above the last land in the +Inf bucket
+    constexpr Histogram(std::initializer_list<std::uint64_t> bounds) {
+        for (const std::uint64_t bound : bounds) {
+            if (bound_count_ < max_bounds) bounds_[bound_count_++] = bound;
+        }
+    }
+
+    void observe(std::uint64_t value) {
+        std::size_t i = 0;
+        while (i < bound_count_ && value > bounds_[i]) ++i;
+        bump(buckets_[i], 1);
+        bump(sum_, value);
+    }
+
+    // Appends the histogram in Prometheus text format, scaling bounds and sum by `scale` (1e-6
+    // turns microseconds into the conventional seconds)
+    void render(std::string& out, const char* name, const char* help, double scale) const;
+
+private:
+    static void bump(std::atomic<std::uint64_t>& a, std::uint64_t n) {
+        a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::array<std::uint64_t, max_bounds> bounds_{};
+    std::size_t bound_count_ = 0;
+    std::array<std::atomic<std::uint64_t>, max_bounds + 1> buckets_{};
+    std::atomic<std::uint64_t> sum_{0};
+};
+
+// Process-wide health metrics. Writers only touch relaxed atomics, so the game thread never
+// takes a lock or waits on a scrape.
+struct Metrics {
+    static constinit inline Counter ticks;
+    static constinit inline Counter frames;
+    static constinit inline Counter games;
+    // Microseconds between frames
+    static constinit inline Histogram frame_time{1'000,  4'000,  8'000,   12'000,  17'000,
+                                                 25'000, 34'000, 50'000, 100'000, 250'000};
+    // Microseconds each tick ran after it fell due
+    static constinit inline Histogram tick_lag{100,   500,    1'000,  2'000,  4'000,
+                                               8'000, 17'000, 34'000, 100'000};
+    static constinit inline Histogram score{0, 1, 2, 5, 10, 20, 50, 100, 200, 400};
+    // Counted only in binaries that link src/Allocations.cpp (the game)
+    static constinit inline ShardedCounter allocations;
+
+    // Every metric, plus the log queue's drop count, in Prometheus text exposition format
+    static std::string render();
+};
+
+// Serves Metrics::render() to `GET /metrics` on 127.0.0.1 from a background thread. The thread
+// only reads the metric atomics, so a scrape costs the game thread nothing.
+class MetricsServer {
+public:
+    // Port 0 picks a free port, see port()
+    static std::expected<MetricsServer, std::string> start(std::uint16_t port);
+
+    MetricsServer(MetricsServer&&) noexcept;
+    MetricsServer& operator=(MetricsServer&&) noexcept;
+    ~MetricsServer();
+
+    [[nodiscard]] std::uint16_t port() const;
+
+private:
+    struct Worker;
+    explicit MetricsServer(std::unique_ptr<Worker> worker);
+
+    std::unique_ptr<Worker> worker_;
+};
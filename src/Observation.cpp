@@ -0,0 +1,117 @@
+#include "Observation.hpp"
+
+#include "Policy.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <type_traits>
+
+namespace {
+
+template <typename T>
+T encode(float value) {
+    if constexpr (std::is_same_v<T, float>) {
+        return value;
+    } else {
+        return static_cast<T>(std::ceil(value * 255.f));
+    }
+}
+
+template <typename T>
+void encode_one(const Simulation& sim, const ObservationLayout& layout, T* out) {
+    const int w = layout.width;
+    const int h = layout.height;
+    const Board& board = sim.board();
+    const Snake& snake = sim.snake();
+    const T one = encode<T>(1.f);
+    const auto index = [w](sf::Vector2i p) { return static_cast<std::size_t>(p.y * w + p.x); };
+    const auto inside = [&](sf::Vector2i p) {
+        return p.x >= 0 && p.x < board.width() && p.y >= 0 && p.y < board.height();
+    };
+    const auto plane = [&](ObservationPlane p) { return out + layout.plane_offset(p); };
+
+    // Planes are mostly zero: clear them in one contiguous pass, then scatter the set cells
+    std::fill_n(out, layout.scalar_offset(), T{0});
+
+    T* walls = plane(ObservationPlane::Wall);
+    for (int y = 0; y < h; ++y) {
+        const int from = y < board.height() ? board.width() : 0;
+        std::fill(walls + y * w + from, walls + (y + 1) * w, one);
+    }
+    // Only the set bits of the level's wall bitmap, which is empty on an open board
+    const Level& level = board.level();
+    for (std::size_t i = 0; i < level.walls.size(); ++i) {
+        for (std::uint64_t word = level.walls[i]; word != 0; word &= word - 1) {
+            const auto cell = static_cast<int>(i * 64) + std::countr_zero(word);
+            walls[index({cell % level.width, cell / level.width})] = one;
+        }
+    }
+
+    // The body by runs: each is a constant stride through the plane, one store per cell. Only
+    // the head can be off the board, after a fatal move.
+    const RunLengthBody& body = snake.body();
+    const float step = 1.f / static_cast<float>(body.size());
+    T* cells = plane(ObservationPlane::Body);
+    int age = 0;
+    for (const RunLengthBody::Run& run : body.runs()) {
+        const sf::Vector2i back = -direction_delta(run.dir);
+        const std::ptrdiff_t stride = back.y * w + back.x;
+        const int first = age == 0 && !inside(run.start) ? 1 : 0;
+        if (first < run.length) {
+            T* cell = cells + index(run.start + back * first);
+            for (int k = first; k < run.length; ++k) {
+                cell[(k - first) * stride] = encode<T>(1.f - static_cast<float>(age + k) * step);
+            }
+        }
+        age += run.length;
+    }
+
+    const sf::Vector2i head = snake.head();
+    if (inside(head)) plane(ObservationPlane::Head)[index(head)] = one;
+    const sf::Vector2i food = board.food_position();
+    plane(ObservationPlane::Food)[index(food)] = one;
+    if (const auto bonus = board.bonus_position()) {
+        const float left = sim.bonus_time_remaining() / Config::bonus_duration;
+        plane(ObservationPlane::Bonus)[index(*bonus)] = encode<T>(std::clamp(left, 0.f, 1.f));
+    }
+
+    T* scalars = out + layout.scalar_offset();
+    for (std::size_t d = 0; d < all_directions.size(); ++d) {
+        scalars[d] = snake.direction() == all_directions[d] ? one : T{0};
+        scalars[4 + d] = is_safe_move(sim, all_directions[d]) ? one : T{0};
+    }
+    const sf::Vector2i offset = food - head;
+    const auto fw = static_cast<float>(w);
+    const auto fh = static_cast<float>(h);
+    scalars[8] = encode<T>(0.5f + static_cast<float>(offset.x) / (2.f * fw));
+    scalars[9] = encode<T>(0.5f + static_cast<float>(offset.y) / (2.f * fh));
+    scalars[10] = encode<T>(static_cast<float>(std::abs(offset.x) + std::abs(offset.y)) /
+                            (fw + fh));
+    scalars[11] = encode<T>(static_cast<float>(body.size()) /
+                            static_cast<float>(layout.plane_size()));
+}
+
+template <typename T>
+void encode_batch(std::span<const Simulation> games, const ObservationLayout& layout,
+                  std::span<T> out) {
+    SNAKE_TRACE_ZONE("encode_observations");
+    const std::size_t stride = layout.stride();
+    for (std::size_t i = 0; i < games.size(); ++i) {
+        encode_one(games[i], layout, out.data() + i * stride);
+    }
+}
+
+} // namespace
+
+void encode_observations(std::span<const Simulation> games, const ObservationLayout& layout,
+                         std::span<float> out) {
+    encode_batch(games, layout, out);
+}
+
+void encode_observations(std::span<const Simulation> games, const ObservationLayout& layout,
+                         std::span<std::uint8_t> out) {
+    encode_batch(games, layout, out);
+}
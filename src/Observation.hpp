@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Config.hpp"
+#include "Simulation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Numeric game state for learning agents, written straight into caller-owned buffers.
+//
+// Each observation is layout.stride() values: plane_count planes of width * height row-major
+// cells, in ObservationPlane order, followed by observation_scalar_count scalars. A batch is
+// observations back to back, so game i starts at i * stride(). Every value lies in 0-1; the uint8
+// encoding scales that to 0-255, rounding up so a non-zero value never becomes 0.
+//
+// Planes:
+//   Head   1 on the head
+//   Body   the body including the head, 1 at the head falling linearly to 1/length at the tail
+//   Food   1 on the food
+//   Bonus  time left / Config::bonus_duration on the bonus, if any
+//   Wall   1 on walls and on layout cells past the edge of a smaller board
+//
+// Scalars:
+//   0-3   heading one-hot, in Direction order (Up, Down, Left, Right)
+//   4-7   1 when moving that way next tick is safe (see is_safe_move), same order
+//   8-9   food offset from the head, x then y: 0.5 + offset / (2 * layout width or height)
+//   10    Manhattan distance to the food / (layout width + height)
+//   11    body length / layout cells
+enum class ObservationPlane { Head, Body, Food, Bonus, Wall };
+inline constexpr std::size_t observation_plane_count = 5;
+inline constexpr std::size_t observation_scalar_count = 12;
+
+// Cells per plane; boards in a batch may differ but must each fit within it
+struct ObservationLayout {
+    int width = Config::grid_width;
+    int height = Config::grid_height;
+
+    [[nodiscard]] std::size_t plane_size() const {
+        return static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+    }
+    [[nodiscard]] std::size_t plane_offset(ObservationPlane plane) const {
+        return static_cast<std::size_t>(plane) * plane_size();
+    }
+    [[nodiscard]] std::size_t scalar_offset() const {
+        return observation_plane_count * plane_size();
+    }
+    [[nodiscard]] std::size_t stride() const {
+        return scalar_offset() + observation_scalar_count;
+    }
+};
+
+// Encodes games[i] into out[i * layout.stride(), (i + 1) * layout.stride()); out must hold
+// games.size() * layout.stride() values. Nothing is allocated.
+void encode_observations(std::span<const Simulation> games, const ObservationLayout& layout,
+                         std::span<float> out);
+void encode_observations(std::span<const Simulation> games, const ObservationLayout& layout,
+                         std::span<std::uint8_t> out);
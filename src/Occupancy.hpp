@@ -0,0 +1,144 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+inline constexpr int dynamic_extent = 0;
+
+// One bit per grid cell, row-major, packed into 64-bit words. The preset grid sizes are
+// instantiated with constexpr dimensions and std::array storage (30x30 is 15 words), so the loops
+// below have constant trip counts and strides; Occupancy<dynamic_extent, dynamic_extent> keeps
+// the dimensions at runtime for every other size.
+template <int W, int H>
+class Occupancy {
+    static constexpr bool is_dynamic = (W == dynamic_extent);
+
+    struct Extent {
+        int w = 0;
+        int h = 0;
+    };
+    struct NoExtent {};
+
+    using Storage = std::conditional_t<is_dynamic, std::vector<std::uint64_t>,
+                                       std::array<std::uint64_t, (W * H + 63) / 64>>;
+
+public:
+    Occupancy()
+        requires(!is_dynamic)
+    = default;
+
+    Occupancy(int w, int h)
+        requires(is_dynamic)
+        : extent_{w, h}, bits_((static_cast<std::size_t>(w * h) + 63) / 64) {}
+
+    [[nodiscard]] constexpr int width() const {
+        if constexpr (is_dynamic) return extent_.w;
+        else return W;
+    }
+    [[nodiscard]] constexpr int height() const {
+        if constexpr (is_dynamic) return extent_.h;
+        else return H;
+    }
+    [[nodiscard]] constexpr int cells() const { return width() * height(); }
+    [[nodiscard]] constexpr std::size_t word_count() const { return bits_.size(); }
+    [[nodiscard]] const std::uint64_t* words() const { return bits_.data(); }
+
+    [[nodiscard]] constexpr bool in_bounds(sf::Vector2i p) const {
+        return p.x >= 0 && p.x < width() && p.y >= 0 && p.y < height();
+    }
+
+    // p must be in bounds
+    [[nodiscard]] bool test(sf::Vector2i p) const {
+        const auto i = index(p);
+        return ((bits_[i / 64] >> (i % 64)) & 1U) != 0;
+    }
+    void set(sf::Vector2i p) {
+        const auto i = index(p);
+        bits_[i / 64] |= std::uint64_t{1} << (i % 64);
+    }
+    void reset(sf::Vector2i p) {
+        const auto i = index(p);
+        bits_[i / 64] &= ~(std::uint64_t{1} << (i % 64));
+    }
+    void clear() {
+        for (auto& w : bits_) {
+            w = 0;
+        }
+    }
+
+    [[nodiscard]] int count() const {
+        int n = 0;
+        for (std::size_t i = 0; i < word_count(); ++i) {
+            n += std::popcount(bits_[i]);
+        }
+        return n;
+    }
+
+    // The n-th unoccupied cell in row-major order, treating `exclude` and the set bits of
+    // `blocked` (same word layout, e.g. a level's walls) as occupied too
+    [[nodiscard]] std::optional<sf::Vector2i>
+    nth_free(int n, std::optional<sf::Vector2i> exclude,
+             const std::uint64_t* blocked = nullptr) const {
+        const std::size_t skip = exclude && in_bounds(*exclude) ? index(*exclude) : ~std::size_t{0};
+        for (std::size_t i = 0; i < word_count(); ++i) {
+            std::uint64_t free = ~bits_[i] & valid_mask(i);
+            if (blocked != nullptr) free &= ~blocked[i];
+            if (skip / 64 == i) free &= ~(std::uint64_t{1} << (skip % 64));
+
+            const int available = std::popcount(free);
+            if (n >= available) {
+                n -= available;
+                continue;
+            }
+            for (; n > 0; --n) {
+                free &= free - 1; // drop lowest set bit
+            }
+            const auto cell = static_cast<int>(i * 64) + std::countr_zero(free);
+            return sf::Vector2i{cell % width(), cell / width()};
+        }
+        return std::nullopt;
+    }
+
+private:
+    [[nodiscard]] constexpr std::size_t index(sf::Vector2i p) const {
+        return static_cast<std::size_t>(p.y * width() + p.x);
+    }
+
+    // Bits of word i that map to real cells (the last word may be partial)
+    [[nodiscard]] constexpr std::uint64_t valid_mask(std::size_t i) const {
+        const auto end = static_cast<std::size_t>(cells());
+        if ((i + 1) * 64 <= end) return ~std::uint64_t{0};
+        return (std::uint64_t{1} << (end - i * 64)) - 1;
+    }
+
+    [[no_unique_address]] std::conditional_t<is_dynamic, Extent, NoExtent> extent_;
+    Storage bits_{};
+};
+
+using DynamicOccupancy = Occupancy<dynamic_extent, dynamic_extent>;
+
+// The preset grid sizes (see Game::cycle_grid_size and Settings::load)
+using AnyOccupancy = std::variant<Occupancy<15, 15>, Occupancy<20, 20>, Occupancy<25, 25>,
+                                  Occupancy<30, 30>, DynamicOccupancy>;
+
+// Picks the specialised instantiation for the grid once, at reset time
+inline AnyOccupancy make_occupancy(int w, int h) {
+    if (w == h) {
+        switch (w) {
+        case 15: return Occupancy<15, 15>{};
+        case 20: return Occupancy<20, 20>{};
+        case 25: return Occupancy<25, 25>{};
+        case 30: return Occupancy<30, 30>{};
+        default: break;
+        }
+    }
+    return DynamicOccupancy{w, h};
+}
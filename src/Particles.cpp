@@ -0,0 +1,72 @@
+#include "Particles.hpp"
+
+#include "Config.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+ParticleSystem::ParticleSystem(std::size_t capacity, std::uint64_t seed)
+    : x_(capacity), y_(capacity), vx_(capacity), vy_(capacity), life_(capacity),
+      inv_lifetime_(capacity), color_(capacity), rng_(seed) {}
+
+std::size_t ParticleSystem::burst(sf::Vector2f position, std::size_t count, sf::Color color,
+                                  float speed, float lifetime) {
+    const std::size_t emitted = std::min(count, capacity() - size_);
+    for (std::size_t i = size_; i < size_ + emitted; ++i) {
+        const float angle = rng_.unit() * 2.f * std::numbers::pi_v<float>;
+        // Bias towards the full speed so bursts read as a ring rather than a blob
+        const float v = speed * (0.3f + 0.7f * std::sqrt(rng_.unit()));
+        // Jitter lifetimes so a burst thins out instead of vanishing at once
+        const float life = lifetime * (0.6f + 0.4f * rng_.unit());
+        x_[i] = position.x;
+        y_[i] = position.y;
+        vx_[i] = v * std::cos(angle);
+        vy_[i] = v * std::sin(angle);
+        life_[i] = life;
+        inv_lifetime_[i] = 1.f / life;
+        color_[i] = color;
+    }
+    size_ += emitted;
+    return emitted;
+}
+
+void ParticleSystem::update(float dt) {
+    SNAKE_TRACE_ZONE("ParticleSystem::update");
+    const float damping = std::exp(-Config::particle_drag * dt);
+    const float fall = Config::particle_gravity * dt;
+
+    // Separate local pointers per field keep this loop free of branches and calls, so it
+    // vectorizes
+    float* x = x_.data();
+    float* y = y_.data();
+    float* vx = vx_.data();
+    float* vy = vy_.data();
+    float* life = life_.data();
+    for (std::size_t i = 0; i < size_; ++i) {
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        vx[i] *= damping;
+        vy[i] = vy[i] * damping + fall;
+        life[i] -= dt;
+    }
+
+    // Swap-remove: the last live particle fills each hole, so nothing shifts
+    std::size_t n = size_;
+    for (std::size_t i = 0; i < n;) {
+        if (life[i] > 0.f) {
+            ++i;
+            continue;
+        }
+        --n;
+        x[i] = x[n];
+        y[i] = y[n];
+        vx[i] = vx[n];
+        vy[i] = vy[n];
+        life[i] = life[n];
+        inv_lifetime_[i] = inv_lifetime_[n];
+        color_[i] = color_[n];
+    }
+    size_ = n;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Rng.hpp"
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Short-lived sparks for eat and death effects. Storage is structure-of-arrays with a fixed
+// capacity allocated up front: update() streams each field through a branch-free loop the
+// compiler vectorizes, then expired particles are removed by swapping in the last live one, so
+// live particles always occupy [0, size()).
+class ParticleSystem {
+public:
+    explicit ParticleSystem(std::size_t capacity, std::uint64_t seed = 0);
+
+    // Emits up to count particles from position in random directions at up to speed px/s, living
+    // lifetime seconds. Returns how many fitted; the rest are dropped once capacity is reached.
+    std::size_t burst(sf::Vector2f position, std::size_t count, sf::Color color, float speed,
+                      float lifetime);
+    // Advances by dt seconds: drag, gravity, ageing, then compaction
+    void update(float dt);
+    void clear() { size_ = 0; }
+
+    [[nodiscard]] std::size_t size() const { return size_; }
+    [[nodiscard]] std::size_t capacity() const { return x_.size(); }
+
+    [[nodiscard]] std::span<const float> x() const { return {x_.data(), size_}; }
+    [[nodiscard]] std::span<const float> y() const { return {y_.data(), size_}; }
+    // Remaining life as a fraction of the lifetime, 1 at emission and falling to 0
+    [[nodiscard]] float fade(std::size_t i) const { return life_[i] * inv_lifetime_[i]; }
+    [[nodiscard]] std::span<const sf::Color> colors() const { return {color_.data(), size_}; }
+
+private:
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> vx_;
+    std::vector<float> vy_;
+    std::vector<float> life_; // seconds left
+    std::vector<float> inv_lifetime_;
+    std::vector<sf::Color> color_;
+    std::size_t size_ = 0;
+    Rng rng_;
+};
@@ -0,0 +1,107 @@
+#include "Policy.hpp"
+
+#include "Bitboard.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+namespace {
+
+// Probability of taking the greedy move instead of a random safe one
+constexpr float greedy_bias = 0.75f;
+
+} // namespace
+
+bool is_safe_move(const Simulation& sim, Direction dir) {
+    const Snake& snake = sim.snake();
+    if (is_opposite(dir, snake.direction())) return false;
+
+    const Board& board = sim.board();
+    const sf::Vector2i next = board.level().portal_exit(snake.head() + direction_delta(dir));
+    if (board.is_blocked(next)) return false;
+    // The tail cell is vacated this tick unless the snake is growing
+    if (!snake.is_growing() && next == snake.body().back()) return true;
+    return !snake.occupies(next);
+}
+
+Direction heuristic_move(const Simulation& sim, Rng& rng) {
+    std::array<Direction, 4> safe{};
+    std::size_t count = 0;
+    Direction best = sim.snake().direction();
+    int best_distance = -1;
+
+    const sf::Vector2i food = sim.board().food_position();
+    // Path lengths around walls and the body when the board tracks them, else straight-line
+    const DistanceField* field = sim.board().distance_field();
+    for (const Direction dir : all_directions) {
+        if (!is_safe_move(sim, dir)) continue;
+        safe[count++] = dir;
+
+        const sf::Vector2i next = sim.snake().head() + direction_delta(dir);
+        const int distance =
+            field ? field->distance(sim.board().level().portal_exit(next))
+                  : std::abs(next.x - food.x) + std::abs(next.y - food.y);
+        if (best_distance < 0 || distance < best_distance) {
+            best = dir;
+            best_distance = distance;
+        }
+    }
+
+    if (count == 0 || rng.unit() < greedy_bias) return best;
+    return safe[rng.below(static_cast<std::uint32_t>(count))];
+}
+
+std::array<double, PolicyWeights::count> PolicyWeights::to_array() const {
+    return {food, space, tail, straight};
+}
+
+PolicyWeights PolicyWeights::from(std::span<const double, count> values) {
+    return {.food = static_cast<float>(values[0]),
+            .space = static_cast<float>(values[1]),
+            .tail = static_cast<float>(values[2]),
+            .straight = static_cast<float>(values[3])};
+}
+
+Direction weighted_move(const Simulation& sim, const PolicyWeights& weights) {
+    const BitboardState state = BitboardState::from(sim);
+    const std::uint8_t legal = state.legal_moves();
+    if (legal == 0) return state.direction;
+
+    const sf::Vector2i food = sim.board().food_position();
+    const DistanceField* field = sim.board().distance_field();
+    const Bitboard open = state.open();
+    const float span = static_cast<float>(state.level.width + state.level.height);
+    const float free_cells = static_cast<float>(std::max(1, open.count()));
+
+    Direction best = state.direction;
+    float best_score = 0.0f;
+    bool found = false;
+    for (const Direction dir : all_directions) {
+        if ((legal & (1U << std::to_underlying(dir))) == 0) continue;
+        const sf::Vector2i next = state.level.portal_exit(state.head + direction_delta(dir));
+
+        int distance = field ? field->distance(next)
+                             : std::abs(next.x - food.x) + std::abs(next.y - food.y);
+        if (distance == DistanceField::unreachable) distance = static_cast<int>(span);
+
+        Bitboard cells = open;
+        cells.reset(next);
+        Bitboard start(state.level.width, state.level.height);
+        start.set(next);
+        const Bitboard reached = flood_fill(start, cells, state.level.portals);
+        // Next to the tail counts: it moves on as the snake does
+        const bool tail = reached.expand(state.board).test(state.tail);
+
+        const float score = -weights.food * static_cast<float>(distance) / span +
+                            weights.space * static_cast<float>(reached.count()) / free_cells +
+                            (tail ? weights.tail : 0.0f) +
+                            (dir == state.direction ? weights.straight : 0.0f);
+        if (!found || score > best_score) {
+            best = dir;
+            best_score = score;
+            found = true;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Rng.hpp"
+#include "Simulation.hpp"
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+inline constexpr std::array all_directions = {Direction::Up, Direction::Down, Direction::Left,
+                                              Direction::Right};
+
+// True when moving in dir next tick does not immediately end the game
+[[nodiscard]] bool is_safe_move(const Simulation& sim, Direction dir);
+
+// Cheap rollout policy: usually the safe move closest to the food, otherwise a random safe move
+[[nodiscard]] Direction heuristic_move(const Simulation& sim, Rng& rng);
+
+// Terms of weighted_move's score for a safe move; snake_tune searches for good values
+struct PolicyWeights {
+    static constexpr std::size_t count = 4;
+
+    float food = 1.0f;     // times the distance to the food, as a fraction of width + height
+    float space = 0.0f;    // times the share of free cells the head can still reach
+    float tail = 0.0f;     // when the tail is still reachable, so the snake can follow it out
+    float straight = 0.0f; // when keeping the heading
+
+    [[nodiscard]] std::array<double, count> to_array() const;
+    static PolicyWeights from(std::span<const double, count> values);
+};
+
+// Deterministic autopilot: the safe move with the highest weighted score. Slower than
+// heuristic_move, as it flood-fills the board once per safe move.
+[[nodiscard]] Direction weighted_move(const Simulation& sim, const PolicyWeights& weights);
@@ -1,56 +1,165 @@
 #include "Renderer.hpp"
 
+#include "Assets.hpp"
 #include "Game.hpp"
+#include "Trace.hpp"
 
-#include <SFML/Graphics/CircleShape.hpp>
 #include <SFML/Graphics/RectangleShape.hpp>
 #include <SFML/Graphics/Text.hpp>
-#include <SFML/Graphics/VertexArray.hpp>
 
+#include <algorithm>
+#include <bit>
 #include <cmath>
+#include <cstdint>
+#include <string>
+
+namespace {
+
+// Character sizes of every sf::Text drawn below
+constexpr unsigned hud_text_size = 20;
+constexpr unsigned overlay_title_size = 48;
+constexpr unsigned overlay_subtitle_size = 20;
+constexpr unsigned overlay_extra_size = 24;
+constexpr unsigned settings_title_size = 36;
+constexpr unsigned settings_item_size = 22;
+// Split screen labels, rasterised once at this size and scaled with the layout
+constexpr unsigned split_label_size = 32;
+
+// SFML rasterises glyphs into the font's page texture on first use, which stalls the first
+// frame that shows a new size or character. Baking printable ASCII at every size up front moves
+// that work to startup; all UI text is ASCII.
+void prewarm_glyphs(const sf::Font& font) {
+    SNAKE_TRACE_ZONE("prewarm_glyphs");
+    for (const unsigned size : {hud_text_size, overlay_title_size, overlay_subtitle_size,
+                                overlay_extra_size, settings_title_size, settings_item_size,
+                                split_label_size}) {
+        for (char32_t c = U' '; c <= U'~'; ++c) {
+            static_cast<void>(font.getGlyph(c, size, false));
+        }
+    }
+}
 
-std::expected<Renderer, std::string> Renderer::create() {
-    sf::Font font; // NOLINT(misc-const-correctness)
-    if (!font.openFromFile(Config::font_path)) {
-        return std::unexpected("Failed to load font: " + std::string(Config::font_path));
+// Clockwise quarter turns that make a right-facing sprite face dir
+int quarter_turns(Direction dir) {
+    switch (dir) {
+    case Direction::Right: return 0;
+    case Direction::Down: return 1;
+    case Direction::Left: return 2;
+    case Direction::Up: return 3;
     }
-    return Renderer{std::move(font)};
+    return 0;
 }
 
-Renderer::Renderer(sf::Font font) : font_(std::move(font)) {}
+// Quarter turns of the corner sprite, which joins the left and bottom edges of its cell, so that
+// it joins the edge the body enters through (moving in) and the one it leaves through (out)
+int corner_turns(Direction in, Direction out) {
+    const sf::Vector2i entry = -direction_delta(in);
+    const sf::Vector2i exit = direction_delta(out);
+    sf::Vector2i a{-1, 0};
+    sf::Vector2i b{0, 1};
+    for (int turns = 0; turns < 4; ++turns) {
+        if ((a == entry && b == exit) || (a == exit && b == entry)) return turns;
+        a = {-a.y, a.x};
+        b = {-b.y, b.x};
+    }
+    return 0;
+}
+
+// Tiles in rows of up to ceil(sqrt(n)) in one world space, each board with a label row above it
+// and a one-cell gap around it
+struct SplitLayout {
+    SplitLayout(std::size_t tiles, int grid_w, int grid_h, int cell_size)
+        : board(static_cast<float>(grid_w * cell_size), static_cast<float>(grid_h * cell_size)),
+          label(board.x / 12.f), gap(static_cast<float>(cell_size)),
+          tile(board.x + gap, board.y + label + gap) {
+        while (static_cast<std::size_t>(cols * cols) < tiles) ++cols;
+        const auto rows = static_cast<int>((tiles + static_cast<std::size_t>(cols) - 1) /
+                                           static_cast<std::size_t>(cols));
+        size = {gap + static_cast<float>(cols) * tile.x, gap + static_cast<float>(rows) * tile.y};
+    }
 
-void Renderer::draw(sf::RenderWindow& window, const RenderContext& ctx) {
-    window.clear(Config::background);
+    // Top-left of board i
+    [[nodiscard]] sf::Vector2f origin(std::size_t i) const {
+        const auto c = static_cast<int>(i) % cols;
+        const auto r = static_cast<int>(i) / cols;
+        return {gap + static_cast<float>(c) * tile.x,
+                gap + label + static_cast<float>(r) * tile.y};
+    }
 
-    sf::View shaken_view = ctx.game_view;
-    shaken_view.setCenter(shaken_view.getCenter() + ctx.shake_offset);
-    window.setView(shaken_view);
+    sf::Vector2f board;
+    float label;
+    float gap;
+    sf::Vector2f tile;
+    int cols = 1;
+    sf::Vector2f size;
+};
 
-    draw_grid(window, ctx.grid_w, ctx.grid_h, ctx.cell_size);
-    draw_food(window, ctx.board.food_position(), ctx.cell_size);
+} // namespace
 
-    if (auto bonus = ctx.board.bonus_position()) {
-        draw_bonus_food(window, *bonus, ctx.cell_size, ctx.elapsed_time,
-                        ctx.board.bonus_time_remaining());
+std::expected<Renderer, std::string> Renderer::create() {
+    SNAKE_TRACE_ZONE("Renderer::create");
+    sf::Font font; // NOLINT(misc-const-correctness)
+    if (const auto embedded = embedded_font(); !embedded.empty()) {
+        // The font reads from this memory for its whole lifetime; it is static data
+        if (!font.openFromMemory(embedded.data(), embedded.size())) {
+            return std::unexpected("Failed to load embedded font");
+        }
+    } else if (!font.openFromFile(Config::font_path)) {
+        return std::unexpected("Failed to load font: " + std::string(Config::font_path));
     }
+    prewarm_glyphs(font);
+
+    auto atlas = SpriteAtlas::create(static_cast<unsigned>(Config::cell_size));
+    if (!atlas) return std::unexpected(atlas.error());
+    return Renderer{std::move(font), std::move(*atlas)};
+}
+
+Renderer::Renderer(sf::Font font, SpriteAtlas atlas)
+    : font_(std::move(font)), atlas_(std::move(atlas)), labels_(split_label_size) {}
+
+void Renderer::draw(sf::RenderTarget& target, const RenderContext& ctx) {
+    SNAKE_TRACE_ZONE("Renderer::draw");
+    target.clear(Config::background);
+
+    if (!ctx.tiles.empty()) {
+        draw_split(target, ctx);
+    } else {
+        sf::View shaken_view = ctx.game_view;
+        shaken_view.setCenter(shaken_view.getCenter() + ctx.shake_offset);
+        target.setView(shaken_view);
+
+        // The whole board is one textured vertex array drawn with a single atlas bind
+        batch_.clear();
+        batch_grid(batch_, ctx.grid_w, ctx.grid_h, ctx.cell_size);
+        if (ctx.heatmap) batch_heatmap(*ctx.heatmap, ctx.cell_size);
+        batch_level(batch_, ctx.board.level(), ctx.cell_size);
+        batch_food(ctx.board.food_position(), ctx.cell_size);
+
+        if (auto bonus = ctx.board.bonus_position()) {
+            batch_bonus_food(*bonus, ctx.cell_size, ctx.elapsed_time, ctx.bonus_time_remaining);
+        }
 
-    draw_snake(window, ctx.snake, ctx.alpha, ctx.cell_size);
+        batch_snake(ctx.snake, ctx.alpha, ctx.cell_size);
+        batch_particles(ctx.particles);
+        batch_.draw(target, atlas_);
+    }
 
-    window.setView(ctx.game_view);
+    target.setView(ctx.game_view);
 
     switch (ctx.state) {
     case GameState::Menu: {
         const std::string sub = "Press Enter to Start  |  S for Settings";
         const std::string extra = "High Score: " + std::to_string(ctx.high_score);
-        draw_overlay(window, ctx.game_view, "SNAKE", sub, extra);
+        draw_overlay(target, ctx.game_view, "SNAKE", sub, extra);
         break;
     }
     case GameState::Playing: // NOLINT(bugprone-branch-clone)
-        draw_hud(window, ctx.score, ctx.high_score);
+        // Split screen labels carry the scores
+        if (ctx.tiles.empty()) draw_hud(target, ctx.score, ctx.high_score, ctx.autopilot);
         break;
     case GameState::Paused:
-        draw_hud(window, ctx.score, ctx.high_score);
-        draw_overlay(window, ctx.game_view, "PAUSED", "Press P to Resume");
+        if (ctx.tiles.empty()) draw_hud(target, ctx.score, ctx.high_score, ctx.autopilot);
+        draw_overlay(target, ctx.game_view, "PAUSED", "Press P to Resume");
         break;
     case GameState::GameOver: {
         const std::string sub = "Score: " + std::to_string(ctx.score) +
@@ -63,164 +172,282 @@ void Renderer::draw(sf::RenderWindow& window, const RenderContext& ctx) {
                 extra = "NEW HIGH SCORE!";
             }
         }
-        draw_overlay(window, ctx.game_view, "GAME OVER", sub, extra);
+        draw_overlay(target, ctx.game_view, "GAME OVER", sub, extra);
         break;
     }
-    case GameState::Settings: draw_settings(window, ctx); break;
+    case GameState::Settings: draw_settings(target, ctx); break;
     }
-
-    window.display();
 }
 
-void Renderer::draw_grid(sf::RenderWindow& window, int grid_w, int grid_h, int cell_size) {
+void Renderer::batch_grid(SpriteBatch& batch, int grid_w, int grid_h, int cell_size) {
+    SNAKE_TRACE_ZONE("Renderer::batch_grid");
     auto w = static_cast<float>(grid_w * cell_size);
     auto h = static_cast<float>(grid_h * cell_size);
     const auto cs = static_cast<float>(cell_size);
 
-    sf::VertexArray lines(sf::PrimitiveType::Lines);
-
+    // One-pixel quads of the solid sprite, so the grid shares the board's draw call
     for (int i = 1; i < grid_w; ++i) {
         float x = static_cast<float>(i) * cs;
-        lines.append(sf::Vertex{{x, 0.f}, Config::grid_line});
-        lines.append(sf::Vertex{{x, h}, Config::grid_line});
+        batch.add(atlas_, Sprite::Solid, {{x - 0.5f, 0.f}, {1.f, h}}, 0, Config::grid_line);
     }
     for (int i = 1; i < grid_h; ++i) {
         float y = static_cast<float>(i) * cs;
-        lines.append(sf::Vertex{{0.f, y}, Config::grid_line});
-        lines.append(sf::Vertex{{w, y}, Config::grid_line});
+        batch.add(atlas_, Sprite::Solid, {{0.f, y - 0.5f}, {w, 1.f}}, 0, Config::grid_line);
     }
-
-    window.draw(lines);
 }
 
-void Renderer::draw_snake(sf::RenderWindow& window, const Snake& snake, float alpha,
-                          int cell_size) {
+void Renderer::batch_heatmap(const Heatmap& heatmap, int cell_size) {
+    SNAKE_TRACE_ZONE("Renderer::batch_heatmap");
     const auto cs = static_cast<float>(cell_size);
-    const float padding = 1.f;
-
-    const auto& body = snake.body();
-    const auto& prev = snake.prev_body();
-
-    for (std::size_t i = 0; i < body.size(); ++i) {
-        const sf::Vector2f current = Board::grid_to_pixel(body[i], cell_size);
+    const auto counts = heatmap.counts(HeatCounter::Visits);
+    const std::uint64_t peak = heatmap.max(HeatCounter::Visits);
+    if (peak == 0) return;
+    // Log-scaled like Heatmap::to_pgm, so a few hot cells do not wash out the rest
+    const float scale = 200.f / std::log1p(static_cast<float>(peak));
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] == 0) continue;
+        const auto cell = static_cast<int>(i);
+        const sf::Vector2i pos{cell % heatmap.width(), cell / heatmap.width()};
+        sf::Color color = Config::heatmap_color;
+        color.a = static_cast<std::uint8_t>(std::log1p(static_cast<float>(counts[i])) * scale);
+        batch_.add(atlas_, Sprite::Solid, {Board::grid_to_pixel(pos, cell_size), {cs, cs}}, 0,
+                   color);
+    }
+}
 
-        sf::Vector2f pos;
-        if (i < prev.size()) {
-            const sf::Vector2f previous = Board::grid_to_pixel(prev[i], cell_size);
-            pos = previous + alpha * (current - previous);
-        } else {
-            pos = current;
+void Renderer::batch_level(SpriteBatch& batch, const Level& level, int cell_size) {
+    SNAKE_TRACE_ZONE("Renderer::batch_level");
+    const auto cs = static_cast<float>(cell_size);
+    // Walk the set bits of the wall bitmap rather than every cell
+    for (std::size_t i = 0; i < level.walls.size(); ++i) {
+        for (std::uint64_t word = level.walls[i]; word != 0; word &= word - 1) {
+            const auto cell = static_cast<int>(i * 64) + std::countr_zero(word);
+            const sf::Vector2i pos{cell % level.width, cell / level.width};
+            batch.add(atlas_, Sprite::Solid, {Board::grid_to_pixel(pos, cell_size), {cs, cs}}, 0,
+                      Config::wall_color);
+        }
+    }
+    for (const Portal& portal : level.portals) {
+        for (const sf::Vector2i end : {portal.a(), portal.b()}) {
+            batch.add(atlas_, Sprite::Portal, {Board::grid_to_pixel(end, cell_size), {cs, cs}}, 0,
+                      Config::portal_color);
         }
+    }
+}
 
-        sf::RectangleShape rect({cs - padding * 2.f, cs - padding * 2.f});
-        rect.setPosition(pos + sf::Vector2f{padding, padding});
+void Renderer::batch_snake(const Snake& snake, float alpha, int cell_size) {
+    SNAKE_TRACE_ZONE("Renderer::batch_snake");
+    const auto cs = static_cast<float>(cell_size);
+    const sf::Vector2f half{cs / 2.f, cs / 2.f};
+    auto center = [&](sf::Vector2i cell) { return Board::grid_to_pixel(cell, cell_size) + half; };
+    auto step = [&](Direction dir) { return sf::Vector2f(direction_delta(dir)) * cs; };
+
+    // Body stretched between two points on a run's centre line; nothing when they are reversed
+    auto add_band = [&](sf::Vector2f from, sf::Vector2f to, Direction dir) {
+        const sf::Vector2f delta(direction_delta(dir));
+        if ((to.x - from.x) * delta.x + (to.y - from.y) * delta.y <= 0.f) return;
+        const sf::Vector2f across{std::abs(delta.y) * half.x, std::abs(delta.x) * half.y};
+        const sf::Vector2f lo{std::min(from.x, to.x), std::min(from.y, to.y)};
+        const sf::Vector2f hi{std::max(from.x, to.x), std::max(from.y, to.y)};
+        batch_.add(atlas_, Sprite::Body, {lo - across, hi - lo + across * 2.f}, quarter_turns(dir));
+    };
 
-        const bool is_head = (i == 0);
-        rect.setFillColor(is_head ? Config::snake_head : Config::snake_body);
+    // Straight runs become single stretched quads and each turn one corner sprite, so cost
+    // scales with turns, not length. The head slides in from the previous cell; the tail points
+    // at the next cell towards the head and slides out when it moved that way. Consecutive runs
+    // only share a direction where a portal splits them; those end flush with no corner.
+    const auto& runs = snake.body().runs();
+    const std::size_t last = runs.size() - 1;
+    const sf::Vector2f head = center(runs.front().start) - (1.f - alpha) * step(runs.front().dir);
+
+    const auto& tail_run = runs[last];
+    const Direction tail_dir =
+        tail_run.length > 1 || last == 0 ? tail_run.dir : runs[last - 1].dir;
+    sf::Vector2f tail = center(tail_run.end());
+    if (snake.prev_tail() + direction_delta(tail_dir) == tail_run.end()) {
+        tail -= (1.f - alpha) * step(tail_dir);
+    }
 
-        if (is_head) {
-            rect.setOutlineThickness(-2.f);
-            rect.setOutlineColor(
-                sf::Color(Config::snake_head.r, Config::snake_head.g, Config::snake_head.b, 120));
+    for (std::size_t i = 0; i <= last; ++i) {
+        const auto& run = runs[i];
+        const sf::Vector2f edge = step(run.dir) / 2.f;
+        const bool straight = i > 0 && run.dir == runs[i - 1].dir;
+        // A turn cell is the head-most cell of the older run; the corner sprite covers it
+        const sf::Vector2f front =
+            i == 0 ? head - edge : center(run.start) + (straight ? edge : -edge);
+        const sf::Vector2f back = i == last ? tail + edge : center(run.end()) - edge;
+        add_band(back, front, run.dir);
+        if (i > 0 && !straight && (i < last || run.length > 1)) {
+            batch_.add(atlas_, Sprite::Corner, {center(run.start) - half, {cs, cs}},
+                       corner_turns(run.dir, runs[i - 1].dir));
         }
-
-        window.draw(rect);
     }
+    batch_.add(atlas_, Sprite::Tail, {tail - half, {cs, cs}}, quarter_turns(tail_dir));
+    batch_.add(atlas_, Sprite::Head, {head - half, {cs, cs}}, quarter_turns(runs.front().dir));
 }
 
-void Renderer::draw_food(sf::RenderWindow& window, sf::Vector2i food_pos, int cell_size) {
+void Renderer::batch_food(sf::Vector2i food_pos, int cell_size) {
+    SNAKE_TRACE_ZONE("Renderer::batch_food");
     const auto cs = static_cast<float>(cell_size);
-    const float radius = cs / 2.f - 2.f;
-
-    sf::CircleShape circle(radius);
-    auto pixel = Board::grid_to_pixel(food_pos, cell_size);
-    circle.setPosition(pixel + sf::Vector2f{cs / 2.f - radius, cs / 2.f - radius});
-    circle.setFillColor(Config::food_color);
-
-    window.draw(circle);
+    batch_.add(atlas_, Sprite::Food, {Board::grid_to_pixel(food_pos, cell_size), {cs, cs}});
 }
 
-void Renderer::draw_bonus_food(sf::RenderWindow& window, sf::Vector2i pos, int cell_size,
-                               float elapsed_time, float time_remaining) {
+void Renderer::batch_bonus_food(sf::Vector2i pos, int cell_size, float elapsed_time,
+                                float time_remaining) {
+    SNAKE_TRACE_ZONE("Renderer::batch_bonus_food");
     const auto cs = static_cast<float>(cell_size);
     const float pulse = 1.0f + 0.15f * std::sin(elapsed_time * 8.0f);
-    const float base_radius = cs / 2.f - 2.f;
-    const float radius = base_radius * pulse;
+    const float size = cs * pulse;
 
     const float alpha_val = (time_remaining < 1.0f) ? time_remaining : 1.0f;
 
-    sf::CircleShape circle(radius);
-    auto pixel = Board::grid_to_pixel(pos, cell_size);
-    circle.setPosition(pixel + sf::Vector2f{cs / 2.f - radius, cs / 2.f - radius});
-    circle.setFillColor(sf::Color(Config::bonus_food_color.r, Config::bonus_food_color.g,
-                                  Config::bonus_food_color.b,
-                                  static_cast<std::uint8_t>(255.f * alpha_val)));
+    const sf::Vector2f center = Board::grid_to_pixel(pos, cell_size) + sf::Vector2f{cs, cs} / 2.f;
+    batch_.add(atlas_, Sprite::Bonus, {center - sf::Vector2f{size, size} / 2.f, {size, size}}, 0,
+               sf::Color(255, 255, 255, static_cast<std::uint8_t>(255.f * alpha_val)));
+}
+
+void Renderer::batch_particles(const ParticleSystem& particles) {
+    SNAKE_TRACE_ZONE("Renderer::batch_particles");
+    const auto xs = particles.x();
+    const auto ys = particles.y();
+    const auto colors = particles.colors();
+    const sf::Vector2f size{Config::particle_size, Config::particle_size};
+    for (std::size_t i = 0; i < particles.size(); ++i) {
+        sf::Color color = colors[i];
+        color.a = static_cast<std::uint8_t>(static_cast<float>(color.a) * particles.fade(i));
+        batch_.add(atlas_, Sprite::Spark, {sf::Vector2f{xs[i], ys[i]} - size / 2.f, size}, 0,
+                   color);
+    }
+}
 
-    window.draw(circle);
+void Renderer::draw_split(sf::RenderTarget& target, const RenderContext& ctx) {
+    SNAKE_TRACE_ZONE("Renderer::draw_split");
+    const SplitLayout layout(ctx.tiles.size(), ctx.grid_w, ctx.grid_h, ctx.cell_size);
+    // The square game view's letterboxing, with the layout centred in it
+    const float side = std::max(layout.size.x, layout.size.y);
+    sf::View view(sf::FloatRect({0.f, 0.f}, {side, side}));
+    view.setCenter(layout.size / 2.f);
+    view.setViewport(ctx.game_view.getViewport());
+    target.setView(view);
+
+    // Every board shares its level, so the static layer only changes with the layout
+    const Level& level = ctx.tiles.front().board.level();
+    const TileGridKey key{.tiles = ctx.tiles.size(),
+                          .grid_w = ctx.grid_w,
+                          .grid_h = ctx.grid_h,
+                          .level = level.name.data()};
+    if (key != tile_grid_key_) {
+        tile_grid_key_ = key;
+        tile_grid_.clear();
+        const sf::Vector2f board = layout.board;
+        for (std::size_t i = 0; i < ctx.tiles.size(); ++i) {
+            tile_grid_.set_origin(layout.origin(i));
+            batch_grid(tile_grid_, ctx.grid_w, ctx.grid_h, ctx.cell_size);
+            // The outer edge too, which a single board leaves to the window
+            for (const sf::FloatRect edge :
+                 {sf::FloatRect{{-1.f, -1.f}, {board.x + 2.f, 1.f}},
+                  sf::FloatRect{{-1.f, board.y}, {board.x + 2.f, 1.f}},
+                  sf::FloatRect{{-1.f, 0.f}, {1.f, board.y}},
+                  sf::FloatRect{{board.x, 0.f}, {1.f, board.y}}}) {
+                tile_grid_.add(atlas_, Sprite::Solid, edge, 0, Config::grid_line);
+            }
+            batch_level(tile_grid_, level, ctx.cell_size);
+        }
+    }
+    tile_grid_.draw(target, atlas_);
+
+    batch_.clear();
+    for (std::size_t i = 0; i < ctx.tiles.size(); ++i) {
+        const GameTile& tile = ctx.tiles[i];
+        batch_.set_origin(layout.origin(i));
+        batch_food(tile.board.food_position(), ctx.cell_size);
+        if (auto bonus = tile.board.bonus_position()) {
+            batch_bonus_food(*bonus, ctx.cell_size, ctx.elapsed_time, tile.bonus_time_remaining);
+        }
+        batch_snake(tile.snake, tile.alpha, ctx.cell_size);
+    }
+    batch_.draw(target, atlas_);
+
+    labels_.clear();
+    const float scale = layout.label * 0.75f / static_cast<float>(split_label_size);
+    for (std::size_t i = 0; i < ctx.tiles.size(); ++i) {
+        const GameTile& tile = ctx.tiles[i];
+        std::string label(tile.name);
+        label += "  ";
+        label += std::to_string(tile.score);
+        labels_.add(font_, label, layout.origin(i) - sf::Vector2f{0.f, layout.label}, scale,
+                    i == 0 ? Config::snake_head : Config::text_color);
+    }
+    labels_.draw(target, font_);
 }
 
-void Renderer::draw_hud(sf::RenderWindow& window, int score, int high_score) {
-    sf::Text text(
-        font_, "Score: " + std::to_string(score) + "  |  Best: " + std::to_string(high_score), 20);
+void Renderer::draw_hud(sf::RenderTarget& target, int score, int high_score, bool autopilot) {
+    SNAKE_TRACE_ZONE("Renderer::draw_hud");
+    std::string hud =
+        "Score: " + std::to_string(score) + "  |  Best: " + std::to_string(high_score);
+    if (autopilot) hud += "  |  AI";
+    sf::Text text(font_, hud, hud_text_size);
     text.setFillColor(Config::text_color);
     text.setPosition({10.f, 5.f});
-    window.draw(text);
+    target.draw(text);
 }
 
-void Renderer::draw_overlay(sf::RenderWindow& window, const sf::View& view,
+void Renderer::draw_overlay(sf::RenderTarget& target, const sf::View& view,
                             const std::string& title, const std::string& subtitle,
                             const std::string& extra) {
+    SNAKE_TRACE_ZONE("Renderer::draw_overlay");
     const auto view_size = view.getSize();
     const float w = view_size.x;
     const float h = view_size.y;
 
     sf::RectangleShape overlay({w, h});
     overlay.setFillColor(Config::overlay_bg);
-    window.draw(overlay);
+    target.draw(overlay);
 
-    sf::Text title_text(font_, title, 48);
+    sf::Text title_text(font_, title, overlay_title_size);
     title_text.setFillColor(Config::text_color);
     auto title_bounds = title_text.getLocalBounds();
     title_text.setOrigin({title_bounds.position.x + title_bounds.size.x / 2.f,
                           title_bounds.position.y + title_bounds.size.y / 2.f});
     title_text.setPosition({w / 2.f, h / 2.f - 30.f});
-    window.draw(title_text);
+    target.draw(title_text);
 
-    sf::Text sub_text(font_, subtitle, 20);
+    sf::Text sub_text(font_, subtitle, overlay_subtitle_size);
     sub_text.setFillColor(
         sf::Color(Config::text_color.r, Config::text_color.g, Config::text_color.b, 180));
     auto sub_bounds = sub_text.getLocalBounds();
     sub_text.setOrigin({sub_bounds.position.x + sub_bounds.size.x / 2.f,
                         sub_bounds.position.y + sub_bounds.size.y / 2.f});
     sub_text.setPosition({w / 2.f, h / 2.f + 30.f});
-    window.draw(sub_text);
+    target.draw(sub_text);
 
     if (!extra.empty()) {
-        sf::Text extra_text(font_, extra, 24);
+        sf::Text extra_text(font_, extra, overlay_extra_size);
         extra_text.setFillColor(Config::bonus_food_color);
         auto extra_bounds = extra_text.getLocalBounds();
         extra_text.setOrigin({extra_bounds.position.x + extra_bounds.size.x / 2.f,
                               extra_bounds.position.y + extra_bounds.size.y / 2.f});
         extra_text.setPosition({w / 2.f, h / 2.f + 70.f});
-        window.draw(extra_text);
+        target.draw(extra_text);
     }
 }
 
-void Renderer::draw_settings(sf::RenderWindow& window, const RenderContext& ctx) {
+void Renderer::draw_settings(sf::RenderTarget& target, const RenderContext& ctx) {
+    SNAKE_TRACE_ZONE("Renderer::draw_settings");
     const auto view_size = ctx.game_view.getSize();
     const float w = view_size.x;
     const float h = view_size.y;
 
     sf::RectangleShape bg({w, h});
     bg.setFillColor(Config::background);
-    window.draw(bg);
+    target.draw(bg);
 
-    sf::Text title(font_, "SETTINGS", 36);
+    sf::Text title(font_, "SETTINGS", settings_title_size);
     title.setFillColor(Config::text_color);
     auto tb = title.getLocalBounds();
     title.setOrigin({tb.position.x + tb.size.x / 2.f, tb.position.y + tb.size.y / 2.f});
     title.setPosition({w / 2.f, 50.f});
-    window.draw(title);
+    target.draw(title);
 
     struct Item {
         std::string label;
@@ -235,11 +462,17 @@ void Renderer::draw_settings(sf::RenderWindow& window, const RenderContext& ctx)
         {"Left", "[" + ctx.settings_key_left + "]"},
         {"Right", "[" + ctx.settings_key_right + "]"},
         {"Pause", "[" + ctx.settings_key_pause + "]"},
+        {"AI Budget", "< " + std::to_string(ctx.settings_ai_rollouts) + " >"},
+        {"Level", "< " + ctx.settings_level + " >"},
+        {"Games", "< " + std::to_string(ctx.settings_split_games) + " >"},
         {"Back", ""},
     };
 
-    const float y_start = 110.f;
-    const float y_step = 40.f;
+    // Rows close up to fit the window between the title and a row's height from the bottom,
+    // e.g. 34 px apart on the 480 px window of a 15x15 board
+    const float y_start = 100.f;
+    const float y_end = h - 1.8f * static_cast<float>(settings_item_size);
+    const float y_step = std::min(36.f, (y_end - y_start) / static_cast<float>(items.size() - 1));
 
     for (int i = 0; i < static_cast<int>(items.size()); ++i) {
         const bool selected = (i == ctx.settings_cursor);
@@ -261,9 +494,9 @@ void Renderer::draw_settings(sf::RenderWindow& window, const RenderContext& ctx)
 
         const std::string prefix = selected ? "> " : "  ";
 
-        sf::Text text(font_, prefix + display, 22);
+        sf::Text text(font_, prefix + display, settings_item_size);
         text.setFillColor(color);
         text.setPosition({w * 0.2f, y_start + static_cast<float>(i) * y_step});
-        window.draw(text);
+        target.draw(text);
     }
 }
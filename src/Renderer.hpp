@@ -2,29 +2,52 @@
 
 #include "Board.hpp"
 #include "Config.hpp"
+#include "Heatmap.hpp"
+#include "Particles.hpp"
 #include "Snake.hpp"
+#include "SpriteAtlas.hpp"
 
 #include <SFML/Graphics/Font.hpp>
-#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/View.hpp>
 
+#include <cstddef>
 #include <expected>
+#include <span>
 #include <string>
+#include <string_view>
 
 enum class GameState;
 
+// One board of the split screen
+struct GameTile {
+    const Snake& snake;
+    const Board& board;
+    float alpha;
+    float bonus_time_remaining;
+    int score;
+    std::string_view name;
+};
+
 struct RenderContext {
     const Snake& snake;
     const Board& board;
+    const ParticleSystem& particles;
+    const Heatmap* heatmap; // visit overlay, nullptr when hidden
+    // Split screen: every game side by side, the player's first, drawn instead of snake and
+    // board. Empty for a single game; particles, the heatmap and shake are single-game only.
+    std::span<const GameTile> tiles;
     GameState state;
     int score;
     int high_score;
     bool is_new_high_score;
+    bool autopilot;
     float alpha; // interpolation factor 0–1
     int cell_size;
     int grid_w;
     int grid_h;
     float elapsed_time; // total elapsed time for animations
+    float bonus_time_remaining;
     sf::Vector2f shake_offset;
     sf::View game_view;
     // Settings screen
@@ -32,6 +55,9 @@ struct RenderContext {
     bool settings_binding_mode;
     int settings_grid_size;
     std::string settings_speed_label;
+    int settings_ai_rollouts;
+    std::string settings_level;
+    int settings_split_games;
     std::string settings_key_up;
     std::string settings_key_down;
     std::string settings_key_left;
@@ -43,20 +69,40 @@ class Renderer {
 public:
     static std::expected<Renderer, std::string> create();
 
-    void draw(sf::RenderWindow& window, const RenderContext& ctx);
+    void draw(sf::RenderTarget& target, const RenderContext& ctx);
 
 private:
-    explicit Renderer(sf::Font font);
-
-    void draw_grid(sf::RenderWindow& window, int grid_w, int grid_h, int cell_size);
-    void draw_snake(sf::RenderWindow& window, const Snake& snake, float alpha, int cell_size);
-    void draw_food(sf::RenderWindow& window, sf::Vector2i food_pos, int cell_size);
-    void draw_bonus_food(sf::RenderWindow& window, sf::Vector2i pos, int cell_size,
-                         float elapsed_time, float time_remaining);
-    void draw_hud(sf::RenderWindow& window, int score, int high_score);
-    void draw_overlay(sf::RenderWindow& window, const sf::View& view, const std::string& title,
+    Renderer(sf::Font font, SpriteAtlas atlas);
+
+    // Append board sprites to batch_, which draw() submits in one call
+    void batch_grid(SpriteBatch& batch, int grid_w, int grid_h, int cell_size);
+    void batch_heatmap(const Heatmap& heatmap, int cell_size);
+    void batch_level(SpriteBatch& batch, const Level& level, int cell_size);
+    void batch_snake(const Snake& snake, float alpha, int cell_size);
+    void batch_food(sf::Vector2i food_pos, int cell_size);
+    void batch_bonus_food(sf::Vector2i pos, int cell_size, float elapsed_time,
+                          float time_remaining);
+    void batch_particles(const ParticleSystem& particles);
+    // Every tile in one view: one draw each for the cached grids, the boards and the labels
+    void draw_split(sf::RenderTarget& target, const RenderContext& ctx);
+    void draw_hud(sf::RenderTarget& target, int score, int high_score, bool autopilot);
+    void draw_overlay(sf::RenderTarget& target, const sf::View& view, const std::string& title,
                       const std::string& subtitle, const std::string& extra = "");
-    void draw_settings(sf::RenderWindow& window, const RenderContext& ctx);
+    void draw_settings(sf::RenderTarget& target, const RenderContext& ctx);
 
     sf::Font font_;
+    SpriteAtlas atlas_;
+    SpriteBatch batch_;
+
+    // Split screen grids, walls and portals, rebuilt only when the tile layout changes
+    struct TileGridKey {
+        std::size_t tiles = 0;
+        int grid_w = 0;
+        int grid_h = 0;
+        const char* level = nullptr; // the level's name, which a pack keeps mapped
+        friend bool operator==(const TileGridKey&, const TileGridKey&) = default;
+    };
+    SpriteBatch tile_grid_;
+    TileGridKey tile_grid_key_;
+    TextBatch labels_;
 };
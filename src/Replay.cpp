@@ -0,0 +1,202 @@
+#include "Replay.hpp"
+
+#include "Config.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <print>
+
+namespace {
+
+constexpr std::array<char, 4> magic = {'S', 'N', 'K', 'R'};
+constexpr std::uint32_t format_version = 2; // 2 added the level name
+// Smallest board the tools accept; the largest is Config::max_grid_size
+constexpr std::uint16_t min_grid_size = 5;
+
+} // namespace
+
+Bytes Replay::serialize() const {
+    Bytes out(magic.begin(), magic.end());
+    put_le(out, format_version);
+    put_le(out, seed);
+    put_le(out, static_cast<std::uint16_t>(grid_w));
+    put_le(out, static_cast<std::uint16_t>(grid_h));
+    put_le(out, static_cast<std::uint32_t>(starting_speed.count()));
+    put_le(out, static_cast<std::uint8_t>(level.size()));
+    out.insert(out.end(), level.begin(), level.end());
+    put_le(out, static_cast<std::uint32_t>(inputs.size()));
+    for (const auto& input : inputs) {
+        put_le(out, input.tick);
+        put_le(out, static_cast<std::uint8_t>(input.direction));
+    }
+    put_le(out, static_cast<std::uint32_t>(hashes.size()));
+    for (const auto h : hashes) {
+        put_le(out, h);
+    }
+    put_le(out, final_tick);
+    put_le(out, static_cast<std::int32_t>(final_score));
+    put_le(out, final_hash);
+    return out;
+}
+
+bool Replay::save(const std::string& path) const {
+    SNAKE_TRACE_ZONE("Replay::save");
+    return write_file_atomically(path, serialize());
+}
+
+std::optional<Replay> Replay::load(const std::string& path) {
+    const auto contents = read_file(path);
+    if (!contents) return std::nullopt;
+    return parse(*contents);
+}
+
+std::optional<Replay> Replay::parse(std::span<const std::uint8_t> bytes) {
+    ByteReader in(bytes);
+    std::array<char, 4> header{};
+    if (!in.get(header) || header != magic) return std::nullopt;
+
+    Replay r;
+    std::uint32_t version = 0;
+    std::uint16_t w = 0;
+    std::uint16_t h = 0;
+    std::uint32_t speed = 0;
+    std::uint32_t count = 0;
+    if (!in.get(version) || version < 1 || version > format_version || !in.get(r.seed) ||
+        !in.get(w) || !in.get(h) || !in.get(speed)) {
+        return std::nullopt;
+    }
+    if (version >= 2) {
+        std::uint8_t length = 0;
+        if (!in.get(length) || length > in.remaining()) return std::nullopt;
+        r.level.resize(length);
+        for (char& c : r.level) {
+            if (!in.get(c)) return std::nullopt;
+        }
+    }
+    if (!in.get(count)) return std::nullopt;
+    // Anything else would have check_replay build a board it cannot index or allocate
+    const auto valid_size = [](std::uint16_t size) {
+        return size >= min_grid_size && size <= Config::max_grid_size;
+    };
+    if (!valid_size(w) || !valid_size(h) || speed == 0) return std::nullopt;
+    r.grid_w = w;
+    r.grid_h = h;
+    r.starting_speed = std::chrono::milliseconds(speed);
+
+    // Each input is 5 bytes; reject counts the file cannot hold before allocating
+    if (count > in.remaining() / 5) return std::nullopt;
+    r.inputs.resize(count);
+    for (auto& input : r.inputs) {
+        std::uint8_t dir = 0;
+        if (!in.get(input.tick) || !in.get(dir) || dir > 3) return std::nullopt;
+        input.direction = static_cast<Direction>(dir);
+    }
+
+    if (!in.get(count) || count > in.remaining() / 8) return std::nullopt;
+    r.hashes.resize(count);
+    for (auto& hash : r.hashes) {
+        if (!in.get(hash)) return std::nullopt;
+    }
+
+    std::int32_t score = 0;
+    if (!in.get(r.final_tick) || !in.get(score) || !in.get(r.final_hash)) {
+        return std::nullopt;
+    }
+    r.final_score = score;
+    return r;
+}
+
+void ReplayRecorder::begin(const Simulation& sim) {
+    replay_ = Replay{};
+    replay_.seed = sim.seed();
+    replay_.grid_w = sim.board().width();
+    replay_.grid_h = sim.board().height();
+    replay_.starting_speed = sim.starting_speed();
+    replay_.level = sim.board().level().name;
+    after_step(sim);
+}
+
+void ReplayRecorder::before_step(const Simulation& sim) {
+    const Snake& snake = sim.snake();
+    if (snake.pending_direction() != snake.direction()) {
+        replay_.inputs.push_back({sim.tick(), snake.pending_direction()});
+    }
+}
+
+void ReplayRecorder::after_step(const Simulation& sim) {
+    if (sim.tick() > 0 && sim.tick() % Replay::hash_interval == 0) {
+        replay_.hashes.push_back(sim.hash());
+    }
+    replay_.final_tick = sim.tick();
+    replay_.final_score = sim.score();
+    replay_.final_hash = sim.hash();
+}
+
+void ReplayRecorder::rewind_to(const Simulation& sim) {
+    while (!replay_.inputs.empty() && replay_.inputs.back().tick >= sim.tick()) {
+        replay_.inputs.pop_back();
+    }
+    replay_.hashes.resize(std::min<std::size_t>(replay_.hashes.size(),
+                                                sim.tick() / Replay::hash_interval));
+    replay_.final_tick = sim.tick();
+    replay_.final_score = sim.score();
+    replay_.final_hash = sim.hash();
+}
+
+ReplayCheck check_replay(const Replay& replay, const Level& level) {
+    ReplayCheck check;
+    check.same_level =
+        level.name == replay.level &&
+        (replay.level.empty() || (level.width == replay.grid_w && level.height == replay.grid_h));
+    if (!check.same_level) return check;
+
+    Simulation sim = replay.level.empty()
+                         ? Simulation(replay.grid_w, replay.grid_h, replay.starting_speed,
+                                      replay.seed)
+                         : Simulation(level, replay.starting_speed, replay.seed);
+    std::size_t next_input = 0;
+
+    while (sim.tick() < replay.final_tick && !sim.is_over()) {
+        if (next_input < replay.inputs.size() && replay.inputs[next_input].tick == sim.tick()) {
+            sim.set_direction(replay.inputs[next_input++].direction);
+        }
+        sim.step();
+
+        if (check.first_mismatch || sim.tick() % Replay::hash_interval != 0) continue;
+        const std::size_t checkpoint = sim.tick() / Replay::hash_interval - 1;
+        if (checkpoint < replay.hashes.size() && replay.hashes[checkpoint] != sim.hash()) {
+            check.first_mismatch = sim.tick();
+        }
+    }
+
+    check.ticks = sim.tick();
+    check.score = sim.score();
+    check.hash = sim.hash();
+    check.ok = !check.first_mismatch && check.ticks == replay.final_tick &&
+               check.score == replay.final_score && check.hash == replay.final_hash;
+    return check;
+}
+
+ReplayCheck verify_replay(const Replay& replay, const Level& level) {
+    const ReplayCheck check = check_replay(replay, level);
+    if (!check.same_level) {
+        std::print(stderr, "[replay] Recorded on level '{}', given '{}'\n", replay.level,
+                   level.name);
+        return check;
+    }
+    if (check.first_mismatch) {
+        const std::size_t checkpoint = *check.first_mismatch / Replay::hash_interval - 1;
+        std::print(stderr, "[replay] Hash mismatch at tick {}: expected {:016x}\n",
+                   *check.first_mismatch, replay.hashes[checkpoint]);
+    }
+    if (check.ticks != replay.final_tick || check.score != replay.final_score ||
+        check.hash != replay.final_hash) {
+        std::print(stderr,
+                   "[replay] Result mismatch: claimed tick {} score {} hash {:016x}, "
+                   "got tick {} score {} hash {:016x}\n",
+                   replay.final_tick, replay.final_score, replay.final_hash, check.ticks,
+                   check.score, check.hash);
+    }
+    return check;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "FileIO.hpp"
+#include "Simulation.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+// Everything needed to re-simulate a game headlessly: seed, settings and the turn inputs, plus
+// Zobrist checkpoints for locating where a re-simulation diverges.
+struct Replay {
+    struct Input {
+        std::uint32_t tick; // applied just before stepping from this tick
+        Direction direction;
+    };
+
+    std::uint64_t seed = 0;
+    int grid_w = 0;
+    int grid_h = 0;
+    std::chrono::milliseconds starting_speed{0};
+    std::string level; // LevelPack level name; empty for an open board
+    std::vector<Input> inputs;
+    std::vector<std::uint64_t> hashes; // Simulation::hash() after every hash_interval ticks
+
+    // Claimed result
+    std::uint32_t final_tick = 0;
+    int final_score = 0;
+    std::uint64_t final_hash = 0;
+
+    static constexpr std::uint32_t hash_interval = 16;
+
+    // Binary format; save() replaces the file atomically
+    [[nodiscard]] Bytes serialize() const;
+    static std::optional<Replay> parse(std::span<const std::uint8_t> bytes);
+    bool save(const std::string& path) const;
+    static std::optional<Replay> load(const std::string& path);
+};
+
+// Builds a Replay while Game drives a Simulation
+class ReplayRecorder {
+public:
+    void begin(const Simulation& sim);
+    void before_step(const Simulation& sim);
+    void after_step(const Simulation& sim);
+    // Forgets everything recorded after sim's tick, e.g. after rewinding
+    void rewind_to(const Simulation& sim);
+
+    [[nodiscard]] const Replay& replay() const { return replay_; }
+
+private:
+    Replay replay_;
+};
+
+struct ReplayCheck {
+    bool ok = false;
+    bool same_level = false; // false when the replay was recorded on another level
+    std::uint32_t ticks = 0;
+    int score = 0;
+    std::uint64_t hash = 0;
+    std::optional<std::uint32_t> first_mismatch; // tick of the first failing checkpoint
+};
+
+// Re-simulates the replay and compares checkpoints and the claimed result. Stops comparing
+// checkpoints after the first mismatch and never logs, so batches can run it on every core.
+// A replay recorded on a level needs that level passed in.
+ReplayCheck check_replay(const Replay& replay, const Level& level = {});
+// check_replay, logging what did not match
+ReplayCheck verify_replay(const Replay& replay, const Level& level = {});
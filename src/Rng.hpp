@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <random>
+
+// SplitMix64 generator. Its whole state is one 64-bit word, so it can be copied into a
+// trivially-copyable snapshot, and its bounded draws do not depend on the standard library's
+// distribution implementations (which differ between libstdc++ and libc++).
+class Rng {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Rng(std::uint64_t seed = 0) : state_(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() { return mix(state_ += 0x9E3779B97F4A7C15ULL); }
+
+    // Uniform integer in [0, bound)
+    std::uint32_t below(std::uint32_t bound) {
+        return static_cast<std::uint32_t>(((operator()() >> 32) * bound) >> 32);
+    }
+
+    // Uniform float in [0, 1)
+    float unit() { return static_cast<float>(operator()() >> 40) * 0x1p-24f; }
+
+    [[nodiscard]] std::uint64_t state() const { return state_; }
+    void set_state(std::uint64_t state) { state_ = state; }
+
+    // Non-deterministic seed for interactive play
+    static std::uint64_t random_seed() {
+        std::random_device rd;
+        return (std::uint64_t{rd()} << 32) | rd();
+    }
+
+    static constexpr std::uint64_t mix(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+private:
+    std::uint64_t state_;
+};
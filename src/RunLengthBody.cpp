@@ -0,0 +1,74 @@
+#include "RunLengthBody.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Direction that moves `from` onto the adjacent cell `to`, if they are adjacent
+bool step_between(sf::Vector2i from, sf::Vector2i to, Direction& out) {
+    for (const Direction dir :
+         {Direction::Up, Direction::Down, Direction::Left, Direction::Right}) {
+        if (from + direction_delta(dir) == to) {
+            out = dir;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+void RunLengthBody::clear() {
+    runs_.clear();
+    size_ = 0;
+}
+
+void RunLengthBody::push_front(sf::Vector2i cell, Direction dir) {
+    ++size_;
+    if (!runs_.empty()) {
+        Run& head = runs_.front();
+        if (head.dir == dir && head.start + direction_delta(dir) == cell) {
+            head.start = cell;
+            ++head.length;
+            return;
+        }
+    }
+    runs_.push_front({cell, dir, 1});
+}
+
+void RunLengthBody::push_back(sf::Vector2i cell) {
+    ++size_;
+    if (runs_.empty()) {
+        runs_.push_back({cell, Direction::Left, 1});
+        return;
+    }
+
+    Run& tail = runs_.back();
+    Direction dir = tail.dir;
+    const bool adjacent = step_between(cell, tail.end(), dir);
+    if (adjacent && (tail.length == 1 || dir == tail.dir)) {
+        tail.dir = dir;
+        ++tail.length;
+    } else {
+        runs_.push_back({cell, dir, 1});
+    }
+}
+
+void RunLengthBody::pop_front() {
+    --size_;
+    Run& head = runs_.front();
+    if (--head.length == 0) {
+        runs_.pop_front();
+    } else {
+        head.start -= direction_delta(head.dir);
+    }
+}
+
+void RunLengthBody::pop_back() {
+    --size_;
+    if (--runs_.back().length == 0) runs_.pop_back();
+}
+
+bool operator==(const RunLengthBody& a, const RunLengthBody& b) {
+    return a.size() == b.size() && std::ranges::equal(a, b);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Direction.hpp"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <iterator>
+
+// Snake body stored as straight runs instead of one cell per segment, so memory and iteration
+// over runs scale with the number of turns rather than the length. Runs are ordered head to
+// tail; a run's cells are start, start - delta(dir), ... and move towards start along dir.
+// Only the body itself scales so: Snake's occupancy bitset has a bit per board cell, and a
+// Snapshot stores one entry per cell, so Simulation::restore() is linear in the length.
+class RunLengthBody {
+public:
+    struct Run {
+        sf::Vector2i start; // head-most cell
+        Direction dir;      // direction of travel
+        int length;
+
+        [[nodiscard]] sf::Vector2i end() const {
+            return start - direction_delta(dir) * (length - 1);
+        }
+        friend bool operator==(const Run&, const Run&) = default;
+    };
+
+    // Walks the cells head to tail
+    class Iterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = sf::Vector2i;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+
+        sf::Vector2i operator*() const {
+            const Run& run = (*runs_)[run_];
+            return run.start - direction_delta(run.dir) * offset_;
+        }
+        Iterator& operator++() {
+            if (++offset_ == (*runs_)[run_].length) {
+                ++run_;
+                offset_ = 0;
+            }
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+        friend bool operator==(const Iterator& a, const Iterator& b) {
+            return a.run_ == b.run_ && a.offset_ == b.offset_;
+        }
+
+    private:
+        friend class RunLengthBody;
+        Iterator(const std::deque<Run>* runs, std::size_t run) : runs_(runs), run_(run) {}
+
+        const std::deque<Run>* runs_ = nullptr;
+        std::size_t run_ = 0;
+        int offset_ = 0;
+    };
+
+    void clear();
+    // Adds a new head that moved from the current head in dir
+    void push_front(sf::Vector2i cell, Direction dir);
+    // Appends a cell behind the current tail
+    void push_back(sf::Vector2i cell);
+    void pop_front();
+    void pop_back();
+
+    [[nodiscard]] sf::Vector2i front() const { return runs_.front().start; }
+    [[nodiscard]] sf::Vector2i back() const { return runs_.back().end(); }
+    [[nodiscard]] std::size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    [[nodiscard]] const std::deque<Run>& runs() const { return runs_; }
+
+    [[nodiscard]] Iterator begin() const { return {&runs_, 0}; }
+    [[nodiscard]] Iterator end() const { return {&runs_, runs_.size()}; }
+
+    // Compares cells, not runs: a one-cell run's direction is arbitrary
+    friend bool operator==(const RunLengthBody& a, const RunLengthBody& b);
+
+private:
+    std::deque<Run> runs_;
+    std::size_t size_ = 0;
+};
@@ -73,6 +73,13 @@ void Settings::load() {
                 const int v = std::stoi(val);
                 if (v == speed_slow || v == speed_medium || v == speed_fast)
                     starting_speed = std::chrono::milliseconds(v);
+            } else if (key == "ai_rollouts") {
+                const int v = std::stoi(val);
+                if (v == ai_rollouts_low || v == ai_rollouts_medium || v == ai_rollouts_high)
+                    ai_rollouts = v;
+            } else if (key == "split_games") {
+                const int v = std::stoi(val);
+                if (v == 1 || v == 4 || v == 9 || v == 16) split_games = v;
             }
         } catch (const std::exception&) {
             continue;
@@ -88,6 +95,8 @@ void Settings::load() {
             keys.right = name_to_key(val);
         } else if (key == "key_pause") {
             keys.pause = name_to_key(val);
+        } else if (key == "level") {
+            level = val;
         }
     }
 }
@@ -98,6 +107,9 @@ void Settings::save() const {
 
     file << "grid_size=" << grid_size << "\n";
     file << "speed=" << starting_speed.count() << "\n";
+    file << "ai_rollouts=" << ai_rollouts << "\n";
+    file << "level=" << level << "\n";
+    file << "split_games=" << split_games << "\n";
     file << "key_up=" << key_to_name(keys.up) << "\n";
     file << "key_down=" << key_to_name(keys.down) << "\n";
     file << "key_left=" << key_to_name(keys.left) << "\n";
@@ -1,7 +1,5 @@
 #pragma once
 
-#include "Config.hpp"
-
 #include <SFML/Window/Keyboard.hpp>
 
 #include <chrono>
@@ -13,18 +11,23 @@ struct KeyBindings {
     sf::Keyboard::Key left = sf::Keyboard::Key::Left;
     sf::Keyboard::Key right = sf::Keyboard::Key::Right;
     sf::Keyboard::Key pause = sf::Keyboard::Key::P;
+
+    [[nodiscard]] bool binds(sf::Keyboard::Key key) const {
+        return key == up || key == down || key == left || key == right || key == pause;
+    }
 };
 
 struct Settings {
     int grid_size = 20;                            // 15, 20, 25, 30
     std::chrono::milliseconds starting_speed{150}; // 200, 150, 100
+    int ai_rollouts = 5000;                        // 1000, 5000, 20000 per move
+    std::string level;                             // LevelPack name; empty for the open grid
+    int split_games = 1;                           // 1, 4, 9, 16 boards, all but one bots
     KeyBindings keys;
 
     void load();
     void save() const;
 
-    [[nodiscard]] int window_size() const { return grid_size * Config::cell_size; }
-
     static std::string key_to_name(sf::Keyboard::Key key);
     static sf::Keyboard::Key name_to_key(const std::string& name);
 
@@ -32,4 +35,9 @@ struct Settings {
     static constexpr int speed_slow = 200;
     static constexpr int speed_medium = 150;
     static constexpr int speed_fast = 100;
+
+    // Autopilot search budget presets (rollouts per move)
+    static constexpr int ai_rollouts_low = 1000;
+    static constexpr int ai_rollouts_medium = 5000;
+    static constexpr int ai_rollouts_high = 20000;
 };
@@ -0,0 +1,145 @@
+#include "Simulation.hpp"
+
+#include "Config.hpp"
+#include "Snapshot.hpp"
+#include "Trace.hpp"
+#include "Zobrist.hpp"
+
+#include <algorithm>
+
+Simulation::Simulation(int grid_w, int grid_h, std::chrono::milliseconds starting_speed,
+                       std::uint64_t seed)
+    : Simulation(Level::open_board(grid_w, grid_h), starting_speed, seed) {}
+
+Simulation::Simulation(const Level& level, std::chrono::milliseconds starting_speed,
+                       std::uint64_t seed)
+    : board_(level, seed), starting_speed_(starting_speed), seed_(seed) {
+    snake_.reset(level);
+    board_.spawn_food(snake_);
+}
+
+TickEvents Simulation::step() {
+    TickEvents events;
+    if (over_) return events;
+
+    const float dt = std::chrono::duration<float>(tick_interval()).count();
+    ++tick_;
+    snake_.update();
+
+    if (board_.is_blocked(snake_.head()) || snake_.has_self_collision()) {
+        over_ = true;
+        events.died = true;
+        return events;
+    }
+
+    if (snake_.head() == board_.food_position()) {
+        snake_.grow();
+        ++score_;
+        board_.spawn_food(snake_);
+        events.ate_food = true;
+        events.bonus_spawned = board_.try_spawn_bonus(snake_);
+        if (events.bonus_spawned && board_.bonus_position()) {
+            // Config::bonus_duration at the speed the bonus appeared at
+            const auto lifetime = static_cast<std::uint64_t>(Config::bonus_duration / dt);
+            bonus_expiry_ = timers_.schedule_at(tick_ + lifetime, SimTimer::BonusExpiry);
+        }
+    } else {
+        board_.snake_moved(snake_);
+    }
+
+    if (board_.bonus_position() && snake_.head() == *board_.bonus_position()) {
+        score_ += Config::bonus_points;
+        board_.clear_bonus();
+        timers_.cancel(bonus_expiry_);
+        events.ate_bonus = true;
+    }
+
+    timers_.advance(tick_, [this, &events](SimTimer timer) {
+        switch (timer) {
+        case SimTimer::BonusExpiry:
+            board_.clear_bonus();
+            events.bonus_expired = true;
+            break;
+        }
+    });
+    return events;
+}
+
+std::uint64_t Simulation::hash() const {
+    return snake_.hash() ^ board_.hash() ^ Zobrist::score(score_);
+}
+
+std::chrono::milliseconds Simulation::tick_interval() const {
+    const int speedups = score_ / Config::speed_increment_score;
+    auto ms = starting_speed_ - std::chrono::milliseconds(speedups * 10);
+    return std::max(ms, Config::min_tick);
+}
+
+float Simulation::bonus_time_remaining() const {
+    const float interval = std::chrono::duration<float>(tick_interval()).count();
+    return static_cast<float>(bonus_ticks_remaining()) * interval;
+}
+
+std::uint32_t Simulation::bonus_ticks_remaining() const {
+    const auto expiry = timers_.deadline(bonus_expiry_);
+    return expiry ? static_cast<std::uint32_t>(*expiry - tick_) : 0;
+}
+
+void Simulation::snapshot(Snapshot& out) const {
+    SNAKE_TRACE_ZONE("Simulation::snapshot");
+    out = Snapshot{};
+    const auto cell = [](sf::Vector2i p) {
+        return Snapshot::Cell{static_cast<std::int8_t>(p.x), static_cast<std::int8_t>(p.y)};
+    };
+
+    out.rng_state = board_.rng_state();
+    out.bonus_expiry = static_cast<std::uint32_t>(timers_.deadline(bonus_expiry_).value_or(0));
+    out.score = score_;
+    out.tick = tick_;
+    out.food = cell(board_.food_position());
+    if (auto bonus = board_.bonus_position()) {
+        out.bonus = cell(*bonus);
+        out.flags |= Snapshot::HasBonus;
+    }
+    if (snake_.is_growing()) out.flags |= Snapshot::ShouldGrow;
+    if (over_) out.flags |= Snapshot::Over;
+    out.grid_w = static_cast<std::uint8_t>(board_.width());
+    out.grid_h = static_cast<std::uint8_t>(board_.height());
+    out.direction = static_cast<std::uint8_t>(snake_.direction());
+    out.pending_direction = static_cast<std::uint8_t>(snake_.pending_direction());
+
+    const std::uint32_t start =
+        (Snapshot::max_cells - tick_ % Snapshot::max_cells) % Snapshot::max_cells;
+    out.body_start = static_cast<std::uint16_t>(start);
+    std::size_t i = 0;
+    for (const auto c : snake_.body()) {
+        if (i == Snapshot::max_cells) break;
+        out.cells[(start + i++) % Snapshot::max_cells] = cell(c);
+    }
+    out.body_length = static_cast<std::uint16_t>(i);
+}
+
+void Simulation::restore(const Snapshot& in) {
+    SNAKE_TRACE_ZONE("Simulation::restore");
+    RunLengthBody body;
+    for (std::size_t i = 0; i < in.body_length; ++i) {
+        const auto c = in.cells[(in.body_start + i) % Snapshot::max_cells];
+        body.push_back({c.x, c.y});
+    }
+    snake_.restore(std::move(body), static_cast<Direction>(in.direction),
+                   static_cast<Direction>(in.pending_direction),
+                   (in.flags & Snapshot::ShouldGrow) != 0);
+
+    std::optional<sf::Vector2i> bonus;
+    if ((in.flags & Snapshot::HasBonus) != 0) bonus = sf::Vector2i{in.bonus.x, in.bonus.y};
+    board_.restore({in.food.x, in.food.y}, bonus, in.rng_state);
+    board_.rebuild_distance_field(snake_);
+
+    score_ = in.score;
+    tick_ = in.tick;
+    over_ = (in.flags & Snapshot::Over) != 0;
+
+    timers_.clear(tick_);
+    bonus_expiry_ = {};
+    if (bonus) bonus_expiry_ = timers_.schedule_at(in.bonus_expiry, SimTimer::BonusExpiry);
+}
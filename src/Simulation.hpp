@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Board.hpp"
+#include "Snake.hpp"
+#include "TimerWheel.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+struct Snapshot;
+
+// What happened during one Simulation::step()
+struct TickEvents {
+    bool died = false;
+    bool ate_food = false;
+    bool ate_bonus = false;
+    bool bonus_spawned = false;
+    bool bonus_expired = false;
+};
+
+// Timed events on the simulation's tick clock
+enum class SimTimer : std::uint8_t { BonusExpiry };
+
+// Headless game rules: snake, board, score and tick counter, with no window or timing.
+// Game drives it from the frame loop; tools and AI search can run it directly.
+class Simulation {
+public:
+    Simulation(int grid_w, int grid_h, std::chrono::milliseconds starting_speed,
+               std::uint64_t seed);
+    // Plays on a level from a LevelPack, which must outlive the simulation and its copies
+    Simulation(const Level& level, std::chrono::milliseconds starting_speed, std::uint64_t seed);
+
+    void set_direction(Direction dir) { snake_.set_direction(dir); }
+    // Keeps board().distance_field() current from now on, including in copies
+    void enable_distance_field() { board_.enable_distance_field(snake_); }
+    TickEvents step();
+
+    // For rewinding and spectating. restore() rebuilds the body, its hash and occupancy cell by
+    // cell, and the distance field if enabled; copy-assigning a Simulation is the cheap clone.
+    void snapshot(Snapshot& out) const;
+    void restore(const Snapshot& in);
+
+    [[nodiscard]] std::chrono::milliseconds tick_interval() const;
+
+    [[nodiscard]] const Snake& snake() const { return snake_; }
+    [[nodiscard]] const Board& board() const { return board_; }
+    [[nodiscard]] int score() const { return score_; }
+    [[nodiscard]] std::uint32_t tick() const { return tick_; }
+    [[nodiscard]] bool is_over() const { return over_; }
+    [[nodiscard]] std::uint64_t seed() const { return seed_; }
+    [[nodiscard]] std::chrono::milliseconds starting_speed() const { return starting_speed_; }
+    // Seconds until the bonus expires at the current speed, 0 without a bonus
+    [[nodiscard]] float bonus_time_remaining() const;
+    // Ticks until the bonus expires, 0 without a bonus
+    [[nodiscard]] std::uint32_t bonus_ticks_remaining() const;
+
+    // 64-bit Zobrist fingerprint of snake, food, bonus and score; O(1), nothing is rescanned
+    [[nodiscard]] std::uint64_t hash() const;
+
+private:
+    Snake snake_;
+    Board board_;
+    std::chrono::milliseconds starting_speed_;
+    std::uint64_t seed_;
+    int score_ = 0;
+    std::uint32_t tick_ = 0;
+    bool over_ = false;
+    TimerWheel<SimTimer> timers_;
+    TimerWheel<SimTimer>::Handle bonus_expiry_;
+};
@@ -1,5 +1,7 @@
 #include "Snake.hpp"
 
+#include "Zobrist.hpp"
+
 #include <algorithm>
 #include <ranges>
 #include <utility>
@@ -9,57 +11,74 @@ Snake::Snake() {
 }
 
 void Snake::reset(int grid_w, int grid_h) {
+    reset(Level::open_board(grid_w, grid_h));
+}
+
+void Snake::reset(const Level& level) {
+    const bool same_grid = std::visit(
+        [&](const auto& occ) {
+            return occ.width() == level.width && occ.height() == level.height;
+        },
+        occupancy_);
+    if (!same_grid) occupancy_ = make_occupancy(level.width, level.height);
+    portals_ = level.portals;
+
     body_.clear();
-    const int cx = grid_w / 2;
-    const int cy = grid_h / 2;
-    body_.emplace_back(cx, cy);
-    body_.emplace_back(cx + 1, cy);
-    body_.emplace_back(cx + 2, cy);
-    prev_body_ = body_;
-    direction_ = Direction::Left;
-    pending_direction_ = Direction::Left;
+    const sf::Vector2i behind = -direction_delta(level.spawn_direction);
+    for (int i = 0; i < 3; ++i) {
+        body_.push_back(level.spawn + behind * i);
+    }
+    direction_ = level.spawn_direction;
+    pending_direction_ = level.spawn_direction;
     should_grow_ = false;
+    rebuild();
 }
 
 void Snake::set_direction(Direction dir) {
-    auto opposite = [](Direction a, Direction b) {
-        return (a == Direction::Up && b == Direction::Down) ||
-               (a == Direction::Down && b == Direction::Up) ||
-               (a == Direction::Left && b == Direction::Right) ||
-               (a == Direction::Right && b == Direction::Left);
-    };
-
-    if (!opposite(dir, direction_)) {
+    if (!is_opposite(dir, direction_)) {
         pending_direction_ = dir;
     }
 }
 
 void Snake::update() {
-    prev_body_ = body_;
+    hash_ ^= Zobrist::direction(static_cast<int>(direction_));
     direction_ = pending_direction_;
+    hash_ ^= Zobrist::direction(static_cast<int>(direction_));
 
-    sf::Vector2i delta;
-    switch (direction_) {
-    case Direction::Up: delta = {0, -1}; break;
-    case Direction::Down: delta = {0, 1}; break;
-    case Direction::Left: delta = {-1, 0}; break;
-    case Direction::Right: delta = {1, 0}; break;
-    default: std::unreachable();
+    sf::Vector2i new_head = head() + direction_delta(direction_);
+    for (const Portal& portal : portals_) {
+        if (new_head == portal.a() || new_head == portal.b()) {
+            new_head = new_head == portal.a() ? portal.b() : portal.a();
+            break;
+        }
     }
+    const sf::Vector2i tail = body_.back();
+    const bool moves_tail = !should_grow_;
 
-    const sf::Vector2i new_head = head() + delta;
-    body_.push_front(new_head);
+    // The tail leaves before the head arrives, so moving into the old tail cell is safe
+    std::visit(
+        [&](auto& occ) {
+            if (moves_tail) occ.reset(tail);
+            self_collision_ = occ.in_bounds(new_head) && occ.test(new_head);
+            if (occ.in_bounds(new_head)) occ.set(new_head);
+        },
+        occupancy_);
 
-    if (should_grow_) {
-        should_grow_ = false;
-    } else {
+    body_.push_front(new_head, direction_);
+    hash_ ^= Zobrist::body(new_head);
+
+    if (moves_tail) {
+        hash_ ^= Zobrist::body(tail);
         body_.pop_back();
     }
+    prev_tail_ = tail;
+    moved_ = true;
+    grew_ = !moves_tail;
+    should_grow_ = false;
 }
 
 bool Snake::has_self_collision() const {
-    auto tail = std::ranges::subrange(body_.begin() + 1, body_.end());
-    return std::ranges::contains(tail, head());
+    return self_collision_;
 }
 
 bool Snake::is_out_of_bounds(int width, int height) const {
@@ -68,9 +87,55 @@ bool Snake::is_out_of_bounds(int width, int height) const {
 }
 
 bool Snake::occupies(sf::Vector2i pos) const {
-    return std::ranges::contains(body_, pos);
+    return std::visit(
+        [&](const auto& occ) {
+            // Only the head can leave the grid, and only on the tick that ends the game
+            return occ.in_bounds(pos) ? occ.test(pos) : pos == head();
+        },
+        occupancy_);
 }
 
 void Snake::grow() {
     should_grow_ = true;
 }
+
+RunLengthBody Snake::prev_body() const {
+    RunLengthBody prev = body_;
+    if (moved_) {
+        prev.pop_front();
+        if (!grew_) prev.push_back(prev_tail_);
+    }
+    return prev;
+}
+
+void Snake::restore(RunLengthBody body, Direction direction, Direction pending,
+                    bool should_grow) {
+    body_ = std::move(body);
+    direction_ = direction;
+    pending_direction_ = pending;
+    should_grow_ = should_grow;
+    rebuild();
+}
+
+void Snake::rebuild() {
+    prev_tail_ = body_.back();
+    moved_ = false;
+    grew_ = false;
+
+    hash_ = Zobrist::direction(static_cast<int>(direction_));
+    for (const auto cell : body_) {
+        hash_ ^= Zobrist::body(cell);
+    }
+
+    const auto rest = std::ranges::subrange(std::next(body_.begin()), body_.end());
+    self_collision_ = std::ranges::contains(rest, head());
+
+    std::visit(
+        [&](auto& occ) {
+            occ.clear();
+            for (const auto cell : body_) {
+                if (occ.in_bounds(cell)) occ.set(cell);
+            }
+        },
+        occupancy_);
+}
@@ -1,16 +1,22 @@
 #pragma once
 
-#include <SFML/System/Vector2.hpp>
+#include "Direction.hpp"
+#include "Level.hpp"
+#include "Occupancy.hpp"
+#include "RunLengthBody.hpp"
 
-#include <deque>
+#include <SFML/System/Vector2.hpp>
 
-enum class Direction { Up, Down, Left, Right };
+#include <cstdint>
+#include <span>
 
 class Snake {
 public:
     Snake();
 
     void reset(int grid_w, int grid_h);
+    // Three cells long with the head on the level's spawn; update() follows its portals
+    void reset(const Level& level);
     void set_direction(Direction dir);
     void update();
     [[nodiscard]] bool has_self_collision() const;
@@ -18,15 +24,36 @@ public:
     [[nodiscard]] bool occupies(sf::Vector2i pos) const;
     void grow();
 
-    [[nodiscard]] const std::deque<sf::Vector2i>& body() const { return body_; }
-    [[nodiscard]] const std::deque<sf::Vector2i>& prev_body() const { return prev_body_; }
+    // Replaces the whole state, e.g. when restoring a snapshot; prev_body() becomes body().
+    // Linear in the length, as the hash and occupancy are rebuilt cell by cell.
+    void restore(RunLengthBody body, Direction direction, Direction pending, bool should_grow);
+
+    [[nodiscard]] const RunLengthBody& body() const { return body_; }
+    // Body before the last update(), rebuilt from body() in O(turns); meant for tests and tools
+    [[nodiscard]] RunLengthBody prev_body() const;
+    // Where the tail was before the last update(); equal to the tail after growing
+    [[nodiscard]] sf::Vector2i prev_tail() const { return prev_tail_; }
     [[nodiscard]] sf::Vector2i head() const { return body_.front(); }
     [[nodiscard]] Direction direction() const { return direction_; }
+    [[nodiscard]] Direction pending_direction() const { return pending_direction_; }
+    [[nodiscard]] bool is_growing() const { return should_grow_; }
+    // Zobrist hash of the body cells and direction, maintained incrementally by update()
+    [[nodiscard]] std::uint64_t hash() const { return hash_; }
+    // Bitset of body cells, specialised for the grid size chosen in reset()
+    [[nodiscard]] const AnyOccupancy& occupancy() const { return occupancy_; }
 
 private:
-    std::deque<sf::Vector2i> body_;
-    std::deque<sf::Vector2i> prev_body_;
+    void rebuild();
+
+    RunLengthBody body_;
+    sf::Vector2i prev_tail_;
+    bool moved_ = false; // an update() happened since reset() or restore()
+    bool grew_ = false;  // the last update() kept the tail in place
     Direction direction_ = Direction::Left;
     Direction pending_direction_ = Direction::Left;
     bool should_grow_ = false;
+    bool self_collision_ = false;
+    std::uint64_t hash_ = 0;
+    AnyOccupancy occupancy_;
+    std::span<const Portal> portals_;
 };
@@ -0,0 +1,151 @@
+#include "Snapshot.hpp"
+
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Zero gaps shorter than a record header are cheaper to copy than to split
+constexpr std::size_t record_header = 4;
+
+void put_u16(std::vector<std::uint8_t>& out, std::size_t v) {
+    out.push_back(static_cast<std::uint8_t>(v & 0xFF));
+    out.push_back(static_cast<std::uint8_t>(v >> 8));
+}
+
+// Appends [offset][length][xor bytes] records for every differing run of a and b
+void encode_delta(const Snapshot& a, const Snapshot& b, std::vector<std::uint8_t>& out) {
+    std::array<std::uint8_t, sizeof(Snapshot)> diff{};
+    const auto* pa = reinterpret_cast<const std::uint8_t*>(&a);
+    const auto* pb = reinterpret_cast<const std::uint8_t*>(&b);
+    for (std::size_t i = 0; i < sizeof(Snapshot); ++i) {
+        diff[i] = pa[i] ^ pb[i];
+    }
+
+    std::size_t i = 0;
+    while (i < diff.size()) {
+        if (diff[i] == 0) {
+            ++i;
+            continue;
+        }
+        const std::size_t start = i;
+        std::size_t end = i + 1;
+        std::size_t zeros = 0;
+        for (std::size_t j = end; j < diff.size() && zeros <= record_header; ++j) {
+            if (diff[j] != 0) {
+                end = j + 1;
+                zeros = 0;
+            } else {
+                ++zeros;
+            }
+        }
+        put_u16(out, start);
+        put_u16(out, end - start);
+        out.insert(out.end(), diff.begin() + static_cast<std::ptrdiff_t>(start),
+                   diff.begin() + static_cast<std::ptrdiff_t>(end));
+        i = end;
+    }
+}
+
+void apply_delta(Snapshot& s, const std::uint8_t* delta, std::size_t size) {
+    auto* bytes = reinterpret_cast<std::uint8_t*>(&s);
+    std::size_t i = 0;
+    while (i + record_header <= size) {
+        const std::size_t offset = delta[i] | (delta[i + 1] << 8);
+        const std::size_t length = delta[i + 2] | (delta[i + 3] << 8);
+        i += record_header;
+        for (std::size_t k = 0; k < length; ++k) {
+            bytes[offset + k] ^= delta[i + k];
+        }
+        i += length;
+    }
+}
+
+} // namespace
+
+RewindBuffer::RewindBuffer(std::size_t max_frames, std::size_t capacity_bytes)
+    : max_frames_(max_frames), ring_(capacity_bytes) {
+    scratch_.reserve(sizeof(Snapshot) * 2);
+}
+
+void RewindBuffer::clear() {
+    has_latest_ = false;
+    begin_ = 0;
+    used_ = 0;
+    deltas_ = 0;
+}
+
+void RewindBuffer::push(const Snapshot& state) {
+    SNAKE_TRACE_ZONE("RewindBuffer::push");
+    if (!has_latest_) {
+        latest_ = state;
+        has_latest_ = true;
+        return;
+    }
+
+    // Frame layout: [u16 length][delta][u16 length], so it can be walked from either end
+    scratch_.assign(2, 0);
+    encode_delta(latest_, state, scratch_);
+    const std::size_t length = scratch_.size() - 2;
+    scratch_[0] = static_cast<std::uint8_t>(length & 0xFF);
+    scratch_[1] = static_cast<std::uint8_t>(length >> 8);
+    put_u16(scratch_, length);
+
+    while (deltas_ > 0 && (deltas_ + 2 > max_frames_ || used_ + scratch_.size() > ring_.size())) {
+        drop_oldest();
+    }
+    latest_ = state;
+    if (deltas_ + 2 > max_frames_ || scratch_.size() > ring_.size()) return;
+
+    write((begin_ + used_) % ring_.size(), scratch_.data(), scratch_.size());
+    used_ += scratch_.size();
+    ++deltas_;
+}
+
+bool RewindBuffer::pop(Snapshot& out) {
+    SNAKE_TRACE_ZONE("RewindBuffer::pop");
+    if (!has_latest_) return false;
+    out = latest_;
+
+    if (deltas_ == 0) {
+        has_latest_ = false;
+        return true;
+    }
+
+    const std::size_t end = begin_ + used_;
+    const std::size_t length = read_u16((end - 2) % ring_.size());
+    const std::size_t frame = length + 4;
+    scratch_.resize(length);
+    read((end - frame + 2) % ring_.size(), scratch_.data(), length);
+    apply_delta(latest_, scratch_.data(), length);
+    used_ -= frame;
+    --deltas_;
+    return true;
+}
+
+void RewindBuffer::drop_oldest() {
+    const std::size_t frame = read_u16(begin_) + std::size_t{4};
+    begin_ = (begin_ + frame) % ring_.size();
+    used_ -= frame;
+    --deltas_;
+}
+
+void RewindBuffer::write(std::size_t pos, const std::uint8_t* data, std::size_t n) {
+    const std::size_t first = std::min(n, ring_.size() - pos);
+    std::memcpy(ring_.data() + pos, data, first);
+    std::memcpy(ring_.data(), data + first, n - first);
+}
+
+void RewindBuffer::read(std::size_t pos, std::uint8_t* data, std::size_t n) const {
+    const std::size_t first = std::min(n, ring_.size() - pos);
+    std::memcpy(data, ring_.data() + pos, first);
+    std::memcpy(data + first, ring_.data(), n - first);
+}
+
+std::uint16_t RewindBuffer::read_u16(std::size_t pos) const {
+    std::array<std::uint8_t, 2> b{};
+    read(pos, b.data(), 2);
+    return static_cast<std::uint16_t>(b[0] | (b[1] << 8));
+}
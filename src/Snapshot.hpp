@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Config.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Complete simulation state in one flat, trivially-copyable block, so copying a snapshot is a
+// single memcpy. The body is stored as a ring indexed by tick: body[i] lives in
+// cells[(body_start + i) % max_cells] and body_start moves back one slot per tick, so
+// consecutive snapshots differ in only a handful of bytes (see RewindBuffer).
+struct Snapshot {
+    static constexpr int max_cells = Config::max_grid_size * Config::max_grid_size;
+
+    struct Cell {
+        std::int8_t x;
+        std::int8_t y;
+    };
+
+    enum Flags : std::uint8_t { HasBonus = 1, ShouldGrow = 2, Over = 4 };
+
+    std::uint64_t rng_state;
+    std::uint32_t bonus_expiry; // tick the bonus disappears on, with HasBonus
+    std::int32_t score;
+    std::uint32_t tick;
+    std::uint16_t body_start;
+    std::uint16_t body_length;
+    Cell food;
+    Cell bonus;
+    std::uint8_t grid_w;
+    std::uint8_t grid_h;
+    std::uint8_t direction;
+    std::uint8_t pending_direction;
+    std::uint8_t flags;
+    std::array<std::uint8_t, 7> reserved; // keeps the layout free of padding
+    std::array<Cell, max_cells> cells;
+};
+
+static_assert(std::is_trivially_copyable_v<Snapshot>);
+static_assert(sizeof(Snapshot) == 40 + sizeof(Snapshot::Cell) * Snapshot::max_cells,
+              "Snapshot must not contain padding, delta encoding compares raw bytes");
+
+// Bounded history of snapshots for rewinding. Only the newest snapshot is kept whole; older
+// ones are stored as XOR deltas against their successor, run-length encoded into a byte ring.
+// When either the frame or the byte budget is exceeded, the oldest frames are dropped.
+class RewindBuffer {
+public:
+    RewindBuffer(std::size_t max_frames, std::size_t capacity_bytes);
+
+    void clear();
+    void push(const Snapshot& state);
+    // Removes the newest snapshot and writes it to out; false when the history is empty
+    bool pop(Snapshot& out);
+
+    [[nodiscard]] std::size_t frames() const { return has_latest_ ? deltas_ + 1 : 0; }
+    [[nodiscard]] std::size_t bytes_used() const { return used_; }
+    [[nodiscard]] std::size_t memory_footprint() const {
+        return sizeof(*this) + ring_.capacity();
+    }
+
+private:
+    void drop_oldest();
+    void write(std::size_t pos, const std::uint8_t* data, std::size_t n);
+    void read(std::size_t pos, std::uint8_t* data, std::size_t n) const;
+    [[nodiscard]] std::uint16_t read_u16(std::size_t pos) const;
+
+    Snapshot latest_{};
+    bool has_latest_ = false;
+    std::size_t max_frames_;
+    std::vector<std::uint8_t> ring_;
+    std::size_t begin_ = 0; // offset of the oldest delta
+    std::size_t used_ = 0;  // bytes in use, starting at begin_
+    std::size_t deltas_ = 0;
+    std::vector<std::uint8_t> scratch_;
+};
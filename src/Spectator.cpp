@@ -0,0 +1,219 @@
+#include "Spectator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <format>
+#include <new>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Payloads are stored as relaxed 64-bit atomics, so a reader racing the writer sees stale or
+// mixed words rather than a data race, and the slot's sequence number tells it to discard them
+struct SpectatorRing {
+    static constexpr std::uint32_t magic = 0x54435053; // "SPCT"
+    static constexpr std::uint32_t version = 1;
+    static constexpr std::size_t words = sizeof(Snapshot) / 8;
+
+    struct alignas(64) Slot {
+        // 2n - 1 while publication n is being written into the slot, 2n once it is complete
+        std::atomic<std::uint64_t> sequence{0};
+        std::array<std::atomic<std::uint64_t>, words> payload{};
+    };
+
+    std::atomic<std::uint32_t> ready{0}; // magic once the rest is initialised
+    std::uint32_t layout_version = version;
+    std::uint32_t slot_count = SpectatorFeed::slot_count;
+    std::uint32_t slot_bytes = sizeof(Slot);
+    alignas(64) std::atomic<std::uint64_t> head{0}; // publications completed
+    std::array<Slot, SpectatorFeed::slot_count> slots;
+};
+
+namespace {
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                  std::atomic<std::uint32_t>::is_always_lock_free,
+              "Shared-memory atomics must not rely on a process-local lock");
+static_assert(sizeof(Snapshot) % 8 == 0 && offsetof(Snapshot, cells) % 8 == 0);
+
+constexpr std::size_t header_words = offsetof(Snapshot, cells) / 8;
+
+// Calls f(first, last) for the word ranges holding the live body slice of the cell ring, which
+// wraps at most once. Bounded even for a torn header, which the sequence check then rejects.
+template <typename F>
+void for_each_body_range(const Snapshot& state, F f) {
+    constexpr auto max_cells = static_cast<std::size_t>(Snapshot::max_cells);
+    const std::size_t length = std::min<std::size_t>(state.body_length, max_cells);
+    const std::size_t start = state.body_start % max_cells;
+    const std::size_t before_wrap = std::min(length, max_cells - start);
+    auto cells = [&](std::size_t from, std::size_t count) {
+        if (count == 0) return;
+        const std::size_t begin = offsetof(Snapshot, cells) + from * sizeof(Snapshot::Cell);
+        f(begin / 8, (begin + count * sizeof(Snapshot::Cell) + 7) / 8);
+    };
+    cells(start, before_wrap);
+    cells(0, length - before_wrap);
+}
+
+// Copies publication n out of slot; false when the writer has reused the slot
+bool copy_out(const SpectatorRing::Slot& slot, std::uint64_t n, Snapshot& out) {
+    const std::uint64_t sequence = 2 * n;
+    if (slot.sequence.load(std::memory_order_acquire) != sequence) return false;
+    auto* bytes = reinterpret_cast<std::byte*>(&out); // NOLINT(*-reinterpret-cast)
+    auto load = [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            const std::uint64_t word = slot.payload[i].load(std::memory_order_relaxed);
+            std::memcpy(bytes + i * 8, &word, 8);
+        }
+    };
+    load(0, header_words);
+    for_each_body_range(out, load);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+std::string system_error(const std::string& name, const char* what) {
+    return std::format("Spectator feed {}: {} failed: {}", name, what, std::strerror(errno));
+}
+
+} // namespace
+
+std::expected<SpectatorFeed, std::string> SpectatorFeed::create(std::string name) {
+    ::shm_unlink(name.c_str()); // a feed left behind by a crashed run
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) return std::unexpected(system_error(name, "shm_open"));
+    if (::ftruncate(fd, sizeof(SpectatorRing)) != 0) {
+        const std::string error = system_error(name, "ftruncate");
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return std::unexpected(error);
+    }
+    void* memory =
+        ::mmap(nullptr, sizeof(SpectatorRing), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        const std::string error = system_error(name, "mmap");
+        ::shm_unlink(name.c_str());
+        return std::unexpected(error);
+    }
+    auto* ring = new (memory) SpectatorRing{};
+    ring->ready.store(SpectatorRing::magic, std::memory_order_release);
+    return SpectatorFeed(std::move(name), ring);
+}
+
+SpectatorFeed::SpectatorFeed(SpectatorFeed&& other) noexcept
+    : name_(std::move(other.name_)), ring_(std::exchange(other.ring_, nullptr)),
+      published_(other.published_) {}
+
+SpectatorFeed& SpectatorFeed::operator=(SpectatorFeed&& other) noexcept {
+    if (this != &other) {
+        std::swap(name_, other.name_);
+        std::swap(ring_, other.ring_);
+        std::swap(published_, other.published_);
+    }
+    return *this;
+}
+
+SpectatorFeed::~SpectatorFeed() {
+    if (ring_ == nullptr) return;
+    ::munmap(ring_, sizeof(SpectatorRing));
+    ::shm_unlink(name_.c_str());
+}
+
+void SpectatorFeed::publish(const Snapshot& state) {
+    const std::uint64_t n = ++published_;
+    SpectatorRing::Slot& slot = ring_->slots[(n - 1) % slot_count];
+    slot.sequence.store(2 * n - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const auto* bytes = reinterpret_cast<const std::byte*>(&state); // NOLINT(*-reinterpret-cast)
+    auto store = [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, bytes + i * 8, 8);
+            slot.payload[i].store(word, std::memory_order_relaxed);
+        }
+    };
+    store(0, header_words);
+    for_each_body_range(state, store);
+    slot.sequence.store(2 * n, std::memory_order_release);
+    ring_->head.store(n, std::memory_order_release);
+}
+
+std::expected<SpectatorReader, std::string> SpectatorReader::open(const std::string& name) {
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return std::unexpected(system_error(name, "shm_open"));
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(SpectatorRing)) {
+        ::close(fd);
+        return std::unexpected(std::format("Spectator feed {}: not a spectator feed", name));
+    }
+    void* memory = ::mmap(nullptr, sizeof(SpectatorRing), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (memory == MAP_FAILED) return std::unexpected(system_error(name, "mmap"));
+
+    const auto* ring = static_cast<const SpectatorRing*>(memory);
+    if (ring->ready.load(std::memory_order_acquire) != SpectatorRing::magic ||
+        ring->layout_version != SpectatorRing::version ||
+        ring->slot_count != SpectatorFeed::slot_count ||
+        ring->slot_bytes != sizeof(SpectatorRing::Slot)) {
+        ::munmap(memory, sizeof(SpectatorRing));
+        return std::unexpected(
+            std::format("Spectator feed {}: incompatible or not yet initialised", name));
+    }
+    SpectatorReader reader(ring);
+    // Start at the oldest state still held, without counting earlier ones as missed
+    const std::uint64_t head = ring->head.load(std::memory_order_acquire);
+    reader.read_ = head - std::min<std::uint64_t>(head, SpectatorFeed::slot_count);
+    return reader;
+}
+
+SpectatorReader::SpectatorReader(SpectatorReader&& other) noexcept
+    : ring_(std::exchange(other.ring_, nullptr)), read_(other.read_), missed_(other.missed_) {}
+
+SpectatorReader& SpectatorReader::operator=(SpectatorReader&& other) noexcept {
+    if (this != &other) {
+        std::swap(ring_, other.ring_);
+        std::swap(read_, other.read_);
+        std::swap(missed_, other.missed_);
+    }
+    return *this;
+}
+
+SpectatorReader::~SpectatorReader() {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    if (ring_ != nullptr) ::munmap(const_cast<SpectatorRing*>(ring_), sizeof(SpectatorRing));
+}
+
+std::uint64_t SpectatorReader::published() const {
+    return ring_->head.load(std::memory_order_acquire);
+}
+
+bool SpectatorReader::next(Snapshot& out) {
+    for (;;) {
+        const std::uint64_t head = ring_->head.load(std::memory_order_acquire);
+        if (read_ >= head) return false;
+        if (head - read_ > SpectatorFeed::slot_count) {
+            missed_ += head - SpectatorFeed::slot_count - read_;
+            read_ = head - SpectatorFeed::slot_count;
+        }
+        const std::uint64_t n = ++read_;
+        if (copy_out(ring_->slots[(n - 1) % SpectatorFeed::slot_count], n, out)) return true;
+        ++missed_; // overwritten while it was being copied
+    }
+}
+
+bool SpectatorReader::latest(Snapshot& out) {
+    for (;;) {
+        const std::uint64_t head = ring_->head.load(std::memory_order_acquire);
+        if (read_ >= head) return false;
+        read_ = head;
+        if (copy_out(ring_->slots[(head - 1) % SpectatorFeed::slot_count], head, out)) return true;
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Snapshot.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <utility>
+
+// Live game state for other local processes (viewers, overlays, bots) through a POSIX
+// shared-memory ring of Snapshots. The game publishes one per tick and never waits on readers;
+// each slot is guarded by its own sequence number (a seqlock), so any number of readers copy
+// states out lock-free and detect, rather than block, a write that overtook them. Only the
+// header and the body's slice of the cell ring are copied each way.
+
+struct SpectatorRing; // the shared layout, see Spectator.cpp
+
+// Creates the shared-memory object and publishes into it; the object is removed on destruction.
+// Any stale object of the same name, e.g. left by a crash, is replaced.
+class SpectatorFeed {
+public:
+    static constexpr std::size_t slot_count = 64; // states a reader may fall behind by
+
+    // name is a POSIX shared-memory name such as "/snake-spectator"
+    static std::expected<SpectatorFeed, std::string> create(std::string name);
+
+    SpectatorFeed(const SpectatorFeed&) = delete;
+    SpectatorFeed& operator=(const SpectatorFeed&) = delete;
+    SpectatorFeed(SpectatorFeed&& other) noexcept;
+    SpectatorFeed& operator=(SpectatorFeed&& other) noexcept;
+    ~SpectatorFeed();
+
+    void publish(const Snapshot& state);
+
+    [[nodiscard]] std::uint64_t published() const { return published_; }
+
+private:
+    SpectatorFeed(std::string name, SpectatorRing* ring) : name_(std::move(name)), ring_(ring) {}
+
+    std::string name_;
+    SpectatorRing* ring_ = nullptr;
+    std::uint64_t published_ = 0;
+};
+
+// Read-only view of a feed. States come out in publication order; a reader that falls more than
+// SpectatorFeed::slot_count behind skips to the oldest state still held and counts the rest in
+// missed(). In the states it returns only the live body slice of cells is filled in.
+class SpectatorReader {
+public:
+    static std::expected<SpectatorReader, std::string> open(const std::string& name);
+
+    SpectatorReader(const SpectatorReader&) = delete;
+    SpectatorReader& operator=(const SpectatorReader&) = delete;
+    SpectatorReader(SpectatorReader&& other) noexcept;
+    SpectatorReader& operator=(SpectatorReader&& other) noexcept;
+    ~SpectatorReader();
+
+    // The oldest state not read yet; false when there is none
+    bool next(Snapshot& out);
+    // The newest state, skipping any in between; false when nothing new was published
+    bool latest(Snapshot& out);
+
+    [[nodiscard]] std::uint64_t published() const;
+    [[nodiscard]] std::uint64_t missed() const { return missed_; }
+
+private:
+    explicit SpectatorReader(const SpectatorRing* ring) : ring_(ring) {}
+
+    const SpectatorRing* ring_ = nullptr;
+    std::uint64_t read_ = 0; // publications consumed or skipped
+    std::uint64_t missed_ = 0;
+};
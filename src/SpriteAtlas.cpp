@@ -0,0 +1,243 @@
+#include "SpriteAtlas.hpp"
+
+#include "Config.hpp"
+#include "Trace.hpp"
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+// Sprites sit side by side in one row, separated by a transparent gutter
+constexpr unsigned gutter = 2;
+constexpr float padding = 1.f; // transparent margin inside each sprite, as between cells
+
+// Anti-aliased coverage from a signed distance in pixels, negative inside
+float coverage(float distance) { return std::clamp(0.5f - distance, 0.f, 1.f); }
+
+sf::Color shade(sf::Color color, float factor) {
+    auto channel = [&](std::uint8_t c) {
+        return static_cast<std::uint8_t>(std::clamp(static_cast<float>(c) * factor, 0.f, 255.f));
+    };
+    return {channel(color.r), channel(color.g), channel(color.b), color.a};
+}
+
+sf::Color mix(sf::Color a, sf::Color b, float t) {
+    auto channel = [&](std::uint8_t x, std::uint8_t y) {
+        return static_cast<std::uint8_t>(static_cast<float>(x) +
+                                         (static_cast<float>(y) - static_cast<float>(x)) * t);
+    };
+    return {channel(a.r, b.r), channel(a.g, b.g), channel(a.b, b.b), channel(a.a, b.a)};
+}
+
+// Source-over compositing of color at the given coverage
+sf::Color over(sf::Color dst, sf::Color src, float cover) {
+    const float sa = static_cast<float>(src.a) / 255.f * cover;
+    const float da = static_cast<float>(dst.a) / 255.f;
+    const float out_a = sa + da * (1.f - sa);
+    if (out_a <= 0.f) return sf::Color::Transparent;
+    auto channel = [&](std::uint8_t s, std::uint8_t d) {
+        const float v = (static_cast<float>(s) * sa + static_cast<float>(d) * da * (1.f - sa));
+        return static_cast<std::uint8_t>(std::clamp(v / out_a, 0.f, 255.f));
+    };
+    return {channel(src.r, dst.r), channel(src.g, dst.g), channel(src.b, dst.b),
+            static_cast<std::uint8_t>(out_a * 255.f)};
+}
+
+float length(float x, float y) { return std::sqrt(x * x + y * y); }
+
+float rounded_box(float x, float y, float half, float radius) {
+    const float qx = std::abs(x) - half + radius;
+    const float qy = std::abs(y) - half + radius;
+    return length(std::max(qx, 0.f), std::max(qy, 0.f)) + std::min(std::max(qx, qy), 0.f) -
+           radius;
+}
+
+// Colour of one pixel of a sprite, sampled at its centre (x, y) in a size x size cell. Body,
+// Corner and Tail share a cross-section shading that is symmetric about the centre line, so they
+// join seamlessly in any rotation.
+sf::Color paint(Sprite sprite, float x, float y, float size) {
+    const float c = size / 2.f;
+    const float half = c - padding;
+    auto body_shade = [&](float offset) {
+        const float t = std::min(std::abs(offset) / half, 1.f);
+        return shade(Config::snake_body, 1.08f - 0.2f * t * t);
+    };
+
+    switch (sprite) {
+    case Sprite::Solid: return sf::Color::White;
+    case Sprite::Body:
+        return over(sf::Color::Transparent, body_shade(y - c), coverage(std::abs(y - c) - half));
+    case Sprite::Corner: {
+        // A quarter ring around the bottom-left corner joining the left and bottom edges
+        const float r = length(x, size - y);
+        const float distance = std::max(r - (size - padding), padding - r);
+        return over(sf::Color::Transparent, body_shade(r - c), coverage(distance));
+    }
+    case Sprite::Tail: {
+        // Tapers to a rounded point on the left; full body width where it meets the body
+        const float t = std::clamp((x - 3.f) / (size - 3.f), 0.f, 1.f);
+        const float distance = std::abs(y - c) - half * std::sqrt(t);
+        return over(sf::Color::Transparent, body_shade(y - c), coverage(distance));
+    }
+    case Sprite::Head: {
+        const float box = rounded_box(x - c, y - c, half, 7.f);
+        const sf::Color rim(Config::snake_head.r, Config::snake_head.g, Config::snake_head.b, 120);
+        sf::Color color = over(sf::Color::Transparent, rim, coverage(box));
+        color = over(color, Config::snake_head, coverage(box + 2.f));
+        const float eye_x = size * 0.68f;
+        for (const float eye_y : {size * 0.3f, size * 0.7f}) {
+            color = over(color, Config::background, coverage(length(x - eye_x, y - eye_y) - 3.f));
+            color = over(color, sf::Color::White,
+                         coverage(length(x - eye_x - 1.f, y - eye_y + 1.f) - 1.f));
+        }
+        return color;
+    }
+    case Sprite::Food: {
+        const float radius = c - 2.f;
+        const float r = length(x - c, y - c);
+        sf::Color color = over(sf::Color::Transparent, Config::food_color, coverage(r - radius));
+        const float glint = length(x - size * 0.36f, y - size * 0.36f);
+        color = over(color, sf::Color(255, 255, 255, 110), coverage(glint - size * 0.1f));
+        return color;
+    }
+    case Sprite::Bonus: {
+        // Five-pointed star, pointing up, brightening towards the centre
+        const float r = length(x - c, y - c);
+        const float angle = std::atan2(y - c, x - c) + std::numbers::pi_v<float> / 2.f;
+        const float edge = (c - 2.f) * (0.65f + 0.35f * std::cos(5.f * angle));
+        const sf::Color fill = mix(sf::Color::White, Config::bonus_food_color,
+                                   std::clamp(r / (c - 2.f) + 0.4f, 0.f, 1.f));
+        return over(sf::Color::Transparent, fill, coverage(r - edge));
+    }
+    case Sprite::Spark: {
+        // Soft white dot, tinted by the vertex colour
+        const float t = std::clamp(1.f - length(x - c, y - c) / half, 0.f, 1.f);
+        return {255, 255, 255, static_cast<std::uint8_t>(255.f * t * t)};
+    }
+    case Sprite::Portal: {
+        // White ring with a faint centre, tinted by the vertex colour
+        const float r = length(x - c, y - c);
+        sf::Color color = over(sf::Color::Transparent, sf::Color(255, 255, 255, 70),
+                               coverage(r - (half - 4.f)));
+        return over(color, sf::Color::White, coverage(std::abs(r - (half - 3.f)) - 2.f));
+    }
+    }
+    return sf::Color::Transparent;
+}
+
+} // namespace
+
+std::expected<SpriteAtlas, std::string> SpriteAtlas::create(unsigned sprite_size) {
+    SNAKE_TRACE_ZONE("SpriteAtlas::create");
+    const unsigned stride = sprite_size + gutter;
+    sf::Image image({stride * static_cast<unsigned>(sprite_count), sprite_size},
+                    sf::Color::Transparent);
+
+    const auto size = static_cast<float>(sprite_size);
+    for (unsigned s = 0; s < sprite_count; ++s) {
+        const auto sprite = static_cast<Sprite>(s);
+        for (unsigned y = 0; y < sprite_size; ++y) {
+            for (unsigned x = 0; x < sprite_size; ++x) {
+                const sf::Color color = paint(sprite, static_cast<float>(x) + 0.5f,
+                                              static_cast<float>(y) + 0.5f, size);
+                image.setPixel({s * stride + x, y}, color);
+            }
+        }
+    }
+
+    sf::Texture texture; // NOLINT(misc-const-correctness)
+    if (!texture.loadFromImage(image)) {
+        return std::unexpected("Failed to create sprite atlas texture");
+    }
+    texture.setSmooth(true);
+    return SpriteAtlas{std::move(texture), sprite_size};
+}
+
+SpriteAtlas::SpriteAtlas(sf::Texture texture, unsigned sprite_size)
+    : texture_(std::move(texture)), sprite_size_(sprite_size) {}
+
+sf::FloatRect SpriteAtlas::rect(Sprite sprite) const {
+    const auto size = static_cast<float>(sprite_size_);
+    const auto left = static_cast<float>(static_cast<unsigned>(sprite) * (sprite_size_ + gutter));
+    return {{left + 0.5f, 0.5f}, {size - 1.f, size - 1.f}};
+}
+
+void SpriteBatch::add(const SpriteAtlas& atlas, Sprite sprite, sf::FloatRect rect,
+                      int quarter_turns, sf::Color color) {
+    const sf::FloatRect tex = atlas.rect(sprite);
+    rect.position += origin_;
+    const int turns = ((quarter_turns % 4) + 4) % 4;
+
+    // Screen corners in (u, v) unit coordinates; the sprite point shown at each is the corner
+    // rotated back by the requested number of clockwise quarter turns
+    constexpr std::array<sf::Vector2f, 4> unit = {
+        sf::Vector2f{0.f, 0.f}, sf::Vector2f{1.f, 0.f}, sf::Vector2f{1.f, 1.f},
+        sf::Vector2f{0.f, 1.f}};
+    std::array<sf::Vertex, 4> corners{};
+    for (std::size_t i = 0; i < unit.size(); ++i) {
+        sf::Vector2f uv = unit[i] - sf::Vector2f{0.5f, 0.5f};
+        for (int t = 0; t < turns; ++t) {
+            uv = {uv.y, -uv.x};
+        }
+        uv += sf::Vector2f{0.5f, 0.5f};
+        corners[i] = sf::Vertex{rect.position + sf::Vector2f{unit[i].x * rect.size.x,
+                                                             unit[i].y * rect.size.y},
+                                color,
+                                tex.position + sf::Vector2f{uv.x * tex.size.x, uv.y * tex.size.y}};
+    }
+    for (const std::size_t i : {0U, 1U, 2U, 0U, 2U, 3U}) {
+        vertices_.append(corners[i]);
+    }
+}
+
+void SpriteBatch::draw(sf::RenderTarget& target, const SpriteAtlas& atlas) const {
+    sf::RenderStates states;
+    states.texture = &atlas.texture();
+    target.draw(vertices_, states);
+}
+
+void TextBatch::add(const sf::Font& font, std::string_view text, sf::Vector2f position,
+                    float scale, sf::Color color) {
+    // Laid out as sf::Text does: the baseline sits one character size below the top
+    float x = 0.f;
+    const auto baseline = static_cast<float>(character_size_);
+    char32_t previous = 0;
+    for (const char c : text) {
+        const auto code = static_cast<char32_t>(static_cast<unsigned char>(c));
+        x += font.getKerning(previous, code, character_size_);
+        previous = code;
+        const sf::Glyph& glyph = font.getGlyph(code, character_size_, false);
+        const sf::FloatRect quad{{x + glyph.bounds.position.x, baseline + glyph.bounds.position.y},
+                                 glyph.bounds.size};
+        x += glyph.advance;
+        if (quad.size.x <= 0.f || quad.size.y <= 0.f) continue; // spaces
+
+        const sf::Vector2f tex_pos(glyph.textureRect.position);
+        const sf::Vector2f tex_size(glyph.textureRect.size);
+        const std::array<sf::Vertex, 4> corners = {
+            sf::Vertex{position + quad.position * scale, color, tex_pos},
+            sf::Vertex{position + sf::Vector2f{quad.position.x + quad.size.x, quad.position.y} *
+                                      scale,
+                       color, tex_pos + sf::Vector2f{tex_size.x, 0.f}},
+            sf::Vertex{position + (quad.position + quad.size) * scale, color, tex_pos + tex_size},
+            sf::Vertex{position + sf::Vector2f{quad.position.x, quad.position.y + quad.size.y} *
+                                      scale,
+                       color, tex_pos + sf::Vector2f{0.f, tex_size.y}},
+        };
+        for (const std::size_t i : {0U, 1U, 2U, 0U, 2U, 3U}) {
+            vertices_.append(corners[i]);
+        }
+    }
+}
+
+void TextBatch::draw(sf::RenderTarget& target, const sf::Font& font) const {
+    sf::RenderStates states;
+    states.texture = &font.getTexture(character_size_);
+    target.draw(vertices_, states);
+}
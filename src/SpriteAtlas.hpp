@@ -0,0 +1,86 @@
+#pragma once
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include <cstddef>
+#include <expected>
+#include <string>
+#include <string_view>
+
+// Sprites in the atlas. Directional ones face right (+x) and are rotated when drawn; Body is
+// uniform along x so it can be stretched over a whole straight run.
+enum class Sprite { Solid, Body, Corner, Tail, Head, Food, Bonus, Spark, Portal };
+
+// Every board sprite painted procedurally into one texture at startup, so a frame needs a single
+// texture bind and no per-frame shape tessellation.
+class SpriteAtlas {
+public:
+    static constexpr std::size_t sprite_count = 9;
+
+    static std::expected<SpriteAtlas, std::string> create(unsigned sprite_size);
+
+    [[nodiscard]] const sf::Texture& texture() const { return texture_; }
+    // Texture coordinates of a sprite, inset by half a texel so smoothing never samples a
+    // neighbour
+    [[nodiscard]] sf::FloatRect rect(Sprite sprite) const;
+
+private:
+    SpriteAtlas(sf::Texture texture, unsigned sprite_size);
+
+    sf::Texture texture_;
+    unsigned sprite_size_;
+};
+
+// Textured quads from one atlas, accumulated into a single vertex array and drawn with one call.
+// The array keeps its capacity across clear(), so steady-state frames do not allocate.
+class SpriteBatch {
+public:
+    void clear() {
+        vertices_.clear();
+        origin_ = {};
+    }
+
+    // Offset added to every rect passed to add() from now on, e.g. to place one of several
+    // boards
+    void set_origin(sf::Vector2f origin) { origin_ = origin; }
+
+    // quarter_turns rotates the sprite clockwise, e.g. 1 makes a right-facing sprite face down
+    void add(const SpriteAtlas& atlas, Sprite sprite, sf::FloatRect rect, int quarter_turns = 0,
+             sf::Color color = sf::Color::White);
+
+    void draw(sf::RenderTarget& target, const SpriteAtlas& atlas) const;
+
+    [[nodiscard]] std::size_t vertex_count() const { return vertices_.getVertexCount(); }
+
+private:
+    sf::VertexArray vertices_{sf::PrimitiveType::Triangles};
+    sf::Vector2f origin_;
+};
+
+// Text as glyph quads from one character size of one font, so many labels share a single draw
+// call instead of one per sf::Text. Glyphs are rasterised at the batch's size and may be drawn
+// scaled.
+class TextBatch {
+public:
+    explicit TextBatch(unsigned character_size) : character_size_(character_size) {}
+
+    void clear() { vertices_.clear(); }
+
+    // Appends one line of text with its top-left at position, scaled by scale
+    void add(const sf::Font& font, std::string_view text, sf::Vector2f position, float scale,
+             sf::Color color);
+
+    void draw(sf::RenderTarget& target, const sf::Font& font) const;
+
+    [[nodiscard]] unsigned character_size() const { return character_size_; }
+    [[nodiscard]] std::size_t vertex_count() const { return vertices_.getVertexCount(); }
+
+private:
+    unsigned character_size_;
+    sf::VertexArray vertices_{sf::PrimitiveType::Triangles};
+};
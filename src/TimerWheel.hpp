@@ -0,0 +1,187 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Timers on an integer clock (simulation ticks, frame milliseconds) kept in a hierarchy of
+// 64-slot wheels, so schedule() and cancel() are O(1) and advance() moves each timer down at
+// most once per level instead of polling every timer every tick. Level l holds the timers whose
+// deadline first differs from now() in bits [6l, 6l + 6); when now() reaches the start of a
+// slot's span the slot cascades to the levels below, and level 0 slots fire. Deadlines beyond
+// the top level wait in an overflow list that is rescanned each time the top level wraps.
+//
+// Timers carry a small payload rather than a callback, so a wheel copies along with its owner
+// (a Simulation copied for search keeps working timers) and advance() hands due payloads back.
+template <typename T>
+class TimerWheel {
+public:
+    struct Handle {
+        std::uint32_t index = ~std::uint32_t{0};
+        std::uint32_t generation = 0;
+    };
+
+    explicit TimerWheel(std::uint64_t now = 0) : now_(now) {
+        heads_.fill(none);
+        tails_.fill(none);
+    }
+
+    // Fires during the advance() that reaches now() + delay; a delay of 0 counts as 1
+    Handle schedule(std::uint64_t delay, T payload) {
+        return schedule_at(now_ + (delay == 0 ? 1 : delay), payload);
+    }
+
+    // Fires during the advance() that reaches deadline, which must be later than now()
+    Handle schedule_at(std::uint64_t deadline, T payload) {
+        std::uint32_t i = free_;
+        if (i != none) {
+            free_ = nodes_[i].next;
+        } else {
+            i = static_cast<std::uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+        Node& node = nodes_[i];
+        node.payload = payload;
+        node.deadline = deadline;
+        insert(i);
+        ++size_;
+        return {i, node.generation};
+    }
+
+    // False when the timer already fired or was cancelled
+    bool cancel(Handle handle) {
+        if (!live(handle)) return false;
+        unlink(handle.index);
+        release(handle.index);
+        return true;
+    }
+
+    // Drops every timer and restarts the clock at now
+    void clear(std::uint64_t now) {
+        for (std::uint32_t i = 0; i < nodes_.size(); ++i) {
+            if (nodes_[i].list != none) release(i);
+        }
+        heads_.fill(none);
+        tails_.fill(none);
+        now_ = now;
+    }
+
+    // Moves the clock forward to `to`, calling fire(payload) for each timer that falls due, in
+    // deadline order and first-scheduled first within a tick. fire may schedule and cancel.
+    template <typename F>
+    void advance(std::uint64_t to, F fire) {
+        while (now_ < to) {
+            if (size_ == 0) {
+                now_ = to;
+                return;
+            }
+            ++now_;
+            if (starts_span(levels)) cascade(overflow);
+            for (int level = levels - 1; level > 0; --level) {
+                if (starts_span(level)) cascade(list_index(level, now_ >> (slot_bits * level)));
+            }
+            const std::uint32_t due = list_index(0, now_);
+            while (heads_[due] != none) {
+                const std::uint32_t i = heads_[due];
+                unlink(i);
+                const T payload = nodes_[i].payload;
+                release(i);
+                fire(payload);
+            }
+        }
+    }
+
+    [[nodiscard]] std::optional<std::uint64_t> deadline(Handle handle) const {
+        if (!live(handle)) return std::nullopt;
+        return nodes_[handle.index].deadline;
+    }
+    [[nodiscard]] bool pending(Handle handle) const { return live(handle); }
+    [[nodiscard]] std::uint64_t now() const { return now_; }
+    [[nodiscard]] std::size_t size() const { return size_; }
+
+private:
+    static constexpr std::uint32_t none = ~std::uint32_t{0};
+    static constexpr int slot_bits = 6;
+    static constexpr std::uint32_t slots = 1U << slot_bits;
+    static constexpr int levels = 4; // 2^24 ticks ahead before the overflow list
+    static constexpr std::uint32_t overflow = levels * slots;
+
+    struct Node {
+        T payload{};
+        std::uint64_t deadline = 0;
+        std::uint32_t next = none; // also links the free list
+        std::uint32_t prev = none;
+        std::uint32_t list = none; // index into heads_, none while free
+        std::uint32_t generation = 0;
+    };
+
+    static std::uint32_t list_index(int level, std::uint64_t t) {
+        return static_cast<std::uint32_t>(level) * slots +
+               static_cast<std::uint32_t>(t & (slots - 1));
+    }
+
+    // True when now() is the first tick of a slot at this level
+    [[nodiscard]] bool starts_span(int level) const {
+        return (now_ & ((std::uint64_t{1} << (slot_bits * level)) - 1)) == 0;
+    }
+
+    [[nodiscard]] bool live(Handle handle) const {
+        return handle.index < nodes_.size() && nodes_[handle.index].list != none &&
+               nodes_[handle.index].generation == handle.generation;
+    }
+
+    void insert(std::uint32_t i) {
+        Node& node = nodes_[i];
+        // The highest bit where the deadline differs from now picks the level; a deadline of
+        // exactly now only happens mid-cascade and goes to level 0, which fires next
+        const std::uint64_t differs = node.deadline ^ now_;
+        const int level =
+            differs == 0 ? 0 : (static_cast<int>(std::bit_width(differs)) - 1) / slot_bits;
+        node.list =
+            level >= levels ? overflow : list_index(level, node.deadline >> (slot_bits * level));
+        node.next = none;
+        node.prev = tails_[node.list];
+        if (node.prev != none) nodes_[node.prev].next = i;
+        else heads_[node.list] = i;
+        tails_[node.list] = i;
+    }
+
+    void unlink(std::uint32_t i) {
+        Node& node = nodes_[i];
+        if (node.prev != none) nodes_[node.prev].next = node.next;
+        else heads_[node.list] = node.next;
+        if (node.next != none) nodes_[node.next].prev = node.prev;
+        else tails_[node.list] = node.prev;
+    }
+
+    void release(std::uint32_t i) {
+        Node& node = nodes_[i];
+        node.list = none;
+        ++node.generation;
+        node.next = free_;
+        free_ = i;
+        --size_;
+    }
+
+    // Re-files every timer in a list against the current time, which moves each one down
+    void cascade(std::uint32_t list) {
+        std::uint32_t i = heads_[list];
+        heads_[list] = none;
+        tails_[list] = none;
+        while (i != none) {
+            const std::uint32_t next = nodes_[i].next;
+            insert(i);
+            i = next;
+        }
+    }
+
+    std::vector<Node> nodes_;
+    std::array<std::uint32_t, levels * slots + 1> heads_{};
+    std::array<std::uint32_t, levels * slots + 1> tails_{};
+    std::uint32_t free_ = none;
+    std::uint64_t now_;
+    std::size_t size_ = 0;
+};
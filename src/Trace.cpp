@@ -0,0 +1,147 @@
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct Event {
+    const char* name;
+    std::uint64_t start;
+    std::uint64_t end;
+};
+
+// Single-writer ring; the oldest events are overwritten once it wraps
+struct ThreadRing {
+    static constexpr std::size_t capacity = std::size_t{1} << 14;
+
+    void push(const Event& e) {
+        const auto h = head.load(std::memory_order_relaxed);
+        events[h & (capacity - 1)] = e;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    std::array<Event, capacity> events{};
+    std::atomic<std::uint64_t> head{0};
+    std::atomic<const char*> thread_name{"thread"};
+    int tid = 0;
+};
+
+// Owns every ring ever handed out, so events survive the thread that wrote them. Rings of exited
+// threads are reused by new ones, which keeps short-lived worker threads from growing memory.
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    std::vector<ThreadRing*> released;
+    std::uint64_t origin_ticks = Trace::now();
+    std::chrono::steady_clock::time_point origin_time = std::chrono::steady_clock::now();
+
+    ThreadRing* acquire() {
+        const std::scoped_lock lock(mutex);
+        if (!released.empty()) {
+            ThreadRing* ring = released.back();
+            released.pop_back();
+            ring->thread_name.store("thread", std::memory_order_relaxed);
+            return ring;
+        }
+        rings.push_back(std::make_unique<ThreadRing>());
+        rings.back()->tid = static_cast<int>(rings.size());
+        return rings.back().get();
+    }
+
+    void release(ThreadRing* ring) {
+        const std::scoped_lock lock(mutex);
+        released.push_back(ring);
+    }
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+struct ThreadSlot {
+    ThreadRing* ring = nullptr;
+
+    ThreadRing& get() {
+        if (ring == nullptr) ring = registry().acquire();
+        return *ring;
+    }
+    ~ThreadSlot() {
+        if (ring != nullptr) registry().release(ring);
+    }
+};
+
+thread_local ThreadSlot slot;
+
+} // namespace
+
+void Trace::record(const char* name, std::uint64_t start, std::uint64_t end) {
+    slot.get().push({name, start, end});
+}
+
+void Trace::set_thread_name(const char* name) {
+    slot.get().thread_name.store(name, std::memory_order_relaxed);
+}
+
+bool Trace::flush(const std::string& path) {
+    Registry& reg = registry();
+
+    // Calibrate counter ticks against the steady clock over the whole run so far
+    const std::uint64_t ticks = now() - reg.origin_ticks;
+    const auto elapsed = std::chrono::steady_clock::now() - reg.origin_time;
+    const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    const double us_per_tick = ticks > 0 && ns > 0 ? ns / 1000.0 / static_cast<double>(ticks)
+                                                   : 0.001;
+
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+    bool first = true;
+    const auto separator = [&] {
+        if (!first) out << ",\n";
+        first = false;
+    };
+
+    constexpr auto capacity = ThreadRing::capacity;
+    const std::scoped_lock lock(reg.mutex);
+    std::vector<Event> events;
+    for (const auto& ring : reg.rings) {
+        // Copy the live window; anything the writer may have overwritten meanwhile is dropped
+        const auto before = ring->head.load(std::memory_order_acquire);
+        const auto begin = before > capacity ? before - capacity : 0;
+        events.clear();
+        for (auto i = begin; i < before; ++i) {
+            events.push_back(ring->events[i & (capacity - 1)]);
+        }
+        // The writer may already be storing event `after`, which reuses the slot of
+        // after - capacity
+        const auto after = ring->head.load(std::memory_order_acquire);
+        const auto first_valid = after + 1 > capacity ? after + 1 - capacity : 0;
+        const auto skip = static_cast<std::size_t>(
+            std::min(before - begin, first_valid > begin ? first_valid - begin : 0));
+
+        separator();
+        out << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << ring->tid
+            << R"(,"args":{"name":")" << ring->thread_name.load(std::memory_order_relaxed)
+            << "\"}}";
+
+        for (std::size_t i = skip; i < events.size(); ++i) {
+            const Event& e = events[i];
+            if (e.start < reg.origin_ticks) continue;
+            separator();
+            out << R"({"name":")" << e.name << R"(","ph":"X","pid":1,"tid":)" << ring->tid
+                << ",\"ts\":" << static_cast<double>(e.start - reg.origin_ticks) * us_per_tick
+                << ",\"dur\":" << static_cast<double>(e.end - e.start) * us_per_tick << "}";
+        }
+    }
+
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
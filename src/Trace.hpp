@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#endif
+
+// Scoped timing zones for finding frame hitches. Each thread records into its own fixed-size
+// ring (one plain store and one release store per zone, no locks), and flush() writes the most
+// recent events of every thread as Chrome trace-event JSON, which Perfetto and chrome://tracing
+// load directly. The SNAKE_TRACE_ZONE macro compiles to nothing unless the SNAKE_TRACING CMake
+// option is on; the Trace functions themselves are always available.
+class Trace {
+public:
+    // Raw CPU counter: a few nanoseconds to read, converted to wall time only at flush
+    static std::uint64_t now() {
+#if defined(__x86_64__) || defined(_M_X64)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        std::uint64_t ticks = 0;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return static_cast<std::uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    // `name` must outlive the trace; zone names are string literals
+    static void record(const char* name, std::uint64_t start, std::uint64_t end);
+    static void set_thread_name(const char* name);
+
+    // Writes every thread's buffered events to path; false if the file cannot be written
+    static bool flush(const std::string& path);
+};
+
+class TraceZone {
+public:
+    explicit TraceZone(const char* name) : name_(name), start_(Trace::now()) {}
+    ~TraceZone() { Trace::record(name_, start_, Trace::now()); }
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+    const char* name_;
+    std::uint64_t start_;
+};
+
+#ifdef SNAKE_TRACING
+inline constexpr bool tracing_enabled = true;
+#define SNAKE_TRACE_CONCAT_(a, b) a##b
+#define SNAKE_TRACE_CONCAT(a, b) SNAKE_TRACE_CONCAT_(a, b)
+#define SNAKE_TRACE_ZONE(name) const TraceZone SNAKE_TRACE_CONCAT(trace_zone_, __LINE__)(name)
+#else
+inline constexpr bool tracing_enabled = false;
+#define SNAKE_TRACE_ZONE(name) static_cast<void>(0)
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Rng.hpp"
+
+#include <SFML/System/Vector2.hpp>
+
+#include <cstdint>
+
+// Zobrist keys for the hashed state features. Keys are derived by mixing the feature and cell
+// rather than read from a table, so they need no initialisation and work for any grid size.
+struct Zobrist {
+    enum class Feature : std::uint64_t { Body = 1, Food, Bonus, Direction, Score };
+
+    static constexpr std::uint64_t key(Feature feature, sf::Vector2i cell) {
+        const auto x = static_cast<std::uint32_t>(cell.x);
+        const auto y = static_cast<std::uint32_t>(cell.y);
+        return Rng::mix((static_cast<std::uint64_t>(feature) << 56) ^
+                        (static_cast<std::uint64_t>(y) << 28) ^ x);
+    }
+
+    static constexpr std::uint64_t body(sf::Vector2i cell) { return key(Feature::Body, cell); }
+    static constexpr std::uint64_t food(sf::Vector2i cell) { return key(Feature::Food, cell); }
+    static constexpr std::uint64_t bonus(sf::Vector2i cell) { return key(Feature::Bonus, cell); }
+    static constexpr std::uint64_t direction(int dir) {
+        return key(Feature::Direction, {dir, 0});
+    }
+    static constexpr std::uint64_t score(int score) { return key(Feature::Score, {score, 0}); }
+};
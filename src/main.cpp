@@ -1,15 +1,146 @@
+#include "Config.hpp"
+#include "Engine.hpp"
 #include "Game.hpp"
+#include "Level.hpp"
+#include "Log.hpp"
+#include "Metrics.hpp"
+#include "Replay.hpp"
+#include "Spectator.hpp"
 
+#include <charconv>
+#include <cstdint>
 #include <cstdlib>
+#include <optional>
 #include <print>
+#include <string_view>
 
-int main() { // NOLINT(bugprone-exception-escape)
-    auto game = Game::create();
+namespace {
+
+int verify(const char* path) {
+    const auto replay = Replay::load(path);
+    if (!replay) {
+        std::print(stderr, "[snake] Error: cannot read replay {}\n", path);
+        return EXIT_FAILURE;
+    }
+    std::optional<LevelPack> pack;
+    Level level;
+    if (!replay->level.empty()) {
+        if (auto opened = LevelPack::open(Config::level_pack_path)) pack = std::move(*opened);
+        const auto index = pack ? pack->find(replay->level) : std::nullopt;
+        if (!index) {
+            std::print(stderr, "[snake] Error: replay level '{}' is not in {}\n", replay->level,
+                       Config::level_pack_path);
+            return EXIT_FAILURE;
+        }
+        level = pack->level(*index);
+    }
+    const ReplayCheck check = verify_replay(*replay, level);
+    std::print("[snake] Replay {}: {} ticks, score {}, hash {:016x}\n", check.ok ? "OK" : "FAILED",
+               check.ticks, check.score, check.hash);
+    return check.ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+struct Options {
+    const char* verify_replay = nullptr; // checks this replay instead of playing
+    std::optional<std::uint16_t> metrics_port;
+    bool spectate = false;
+    const char* engine = nullptr;
+};
+
+void usage(const char* argv0) {
+    std::print(stderr,
+               "usage: {} [--metrics-port PORT] [--spectate] [--engine CMD]\n"
+               "       {} --verify-replay PATH\n",
+               argv0, argv0);
+}
+
+std::optional<Options> parse_args(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--spectate") {
+            options.spectate = true;
+            continue;
+        }
+        if (i + 1 >= argc) return std::nullopt;
+        const char* value = argv[++i];
+        if (arg == "--verify-replay") {
+            options.verify_replay = value;
+        } else if (arg == "--metrics-port") {
+            const std::string_view port = value;
+            std::uint16_t parsed = 0;
+            const auto [end, ec] = std::from_chars(port.data(), port.data() + port.size(), parsed);
+            if (ec != std::errc{} || end != port.data() + port.size()) {
+                Log::error("Invalid metrics port '{}'", port);
+                return std::nullopt;
+            }
+            options.metrics_port = parsed;
+        } else if (arg == "--engine") {
+            options.engine = value;
+        } else {
+            return std::nullopt;
+        }
+    }
+    // Verifying is a mode of its own rather than something to do while playing
+    if (options.verify_replay &&
+        (options.metrics_port || options.spectate || options.engine != nullptr)) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char** argv) { // NOLINT(bugprone-exception-escape)
+    const auto launched = Game::Clock::now();
+
+    const auto options = parse_args(argc, argv);
+    if (!options) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (options->verify_replay) return verify(options->verify_replay);
+
+    // --metrics-port PORT serves Prometheus metrics on 127.0.0.1 while the game runs
+    std::optional<MetricsServer> metrics;
+    if (options->metrics_port) {
+        auto server = MetricsServer::start(*options->metrics_port);
+        if (!server) {
+            Log::error("{}", server.error());
+            return EXIT_FAILURE;
+        }
+        metrics = std::move(*server);
+        Log::info("Serving metrics on http://127.0.0.1:{}/metrics", metrics->port());
+    }
+
+    auto game = Game::create(launched);
     if (!game) {
-        std::print(stderr, "[snake] Error: {}\n", game.error());
+        Log::error("{}", game.error());
         return EXIT_FAILURE;
     }
 
+    // --spectate publishes every tick to shared memory for snake_spectate and other readers
+    if (options->spectate) {
+        auto feed = SpectatorFeed::create(Config::spectator_feed);
+        if (!feed) {
+            Log::error("{}", feed.error());
+            return EXIT_FAILURE;
+        }
+        game->set_spectator(std::move(*feed));
+        Log::info("Publishing game state to shared memory {}", Config::spectator_feed);
+    }
+
+    // --engine CMD runs CMD as the autopilot, speaking the line protocol in Engine.hpp
+    if (options->engine != nullptr) {
+        auto engine = Engine::start(options->engine, Config::engine_handshake_timeout);
+        if (!engine) {
+            Log::error("{}", engine.error());
+            return EXIT_FAILURE;
+        }
+        Log::info("Engine {} attached; press M to hand it the snake", engine->name());
+        game->set_engine(std::move(*engine));
+    }
+
     game->run();
     return EXIT_SUCCESS;
 }
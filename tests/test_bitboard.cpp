@@ -0,0 +1,116 @@
+#include "../src/Bitboard.hpp"
+
+#include "../src/FileIO.hpp"
+#include "../src/Policy.hpp"
+#include "../src/Rng.hpp"
+#include "../src/Simulation.hpp"
+#include "../src/Snapshot.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::string_view pocket = "#########\n"
+                                    "####.####\n"
+                                    "#...<...#\n"
+                                    "#.......#\n"
+                                    "#########\n";
+
+// Cell-by-cell BFS for comparison with the word-parallel fill
+Bitboard naive_fill(sf::Vector2i seed, const Bitboard& free) {
+    Bitboard reached(free.width(), free.height());
+    reached.set(seed);
+    std::vector<sf::Vector2i> queue = {seed};
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+        for (const Direction dir : all_directions) {
+            const sf::Vector2i n = queue[i] + direction_delta(dir);
+            if (n.x < 0 || n.x >= free.width() || n.y < 0 || n.y >= free.height()) continue;
+            if (!free.test(n) || reached.test(n)) continue;
+            reached.set(n);
+            queue.push_back(n);
+        }
+    }
+    return reached;
+}
+
+} // namespace
+
+TEST_CASE("Bitboard flood fill matches a cell-by-cell BFS", "[bitboard]") {
+    Rng rng(5);
+    for (const auto& [w, h] : {std::pair{5, 5}, {7, 9}, {15, 15}, {17, 30}, {30, 30}}) {
+        for (int trial = 0; trial < 20; ++trial) {
+            Bitboard free = Bitboard::full(w, h);
+            for (int y = 0; y < h; ++y) {
+                for (int x = 0; x < w; ++x) {
+                    if (rng.unit() < 0.35f) free.reset({x, y});
+                }
+            }
+            const sf::Vector2i seed{static_cast<int>(rng.below(static_cast<std::uint32_t>(w))),
+                                    static_cast<int>(rng.below(static_cast<std::uint32_t>(h)))};
+            Bitboard start(w, h);
+            start.set(seed);
+            CHECK(flood_fill(start, free, {}) == naive_fill(seed, free));
+        }
+    }
+}
+
+TEST_CASE("Bitboard state mirrors the snake and food", "[bitboard]") {
+    Simulation sim(20, 20, Config::initial_tick, 4);
+    Rng rng(4);
+    for (int i = 0; i < 300 && !sim.is_over(); ++i) {
+        const BitboardState state = BitboardState::from(sim);
+        CHECK(state.food_cell() == sim.board().food_position());
+        CHECK(state.body.count() == static_cast<int>(sim.snake().body().size()));
+        for (const sf::Vector2i cell : sim.snake().body()) CHECK(state.body.test(cell));
+
+        for (const Direction dir : all_directions) {
+            const bool legal = (state.legal_moves() & (1U << static_cast<int>(dir))) != 0;
+            CHECK(legal == is_safe_move(sim, dir));
+        }
+        sim.set_direction(heuristic_move(sim, rng));
+        sim.step();
+    }
+}
+
+TEST_CASE("leaves_room rejects moves into pockets smaller than the snake", "[bitboard]") {
+    const std::string path = "test_bitboard.pack";
+    const std::array specs = {parse_level("Pocket", pocket).value()};
+    REQUIRE(write_file_atomically(path, LevelPack::build(specs)));
+    auto pack = LevelPack::open(path);
+    std::remove(path.c_str());
+    REQUIRE(pack.has_value());
+
+    const Simulation sim(pack->level(0), Config::initial_tick, 1);
+    const BitboardState state = BitboardState::from(sim);
+    CHECK_FALSE(state.leaves_room(Direction::Up));    // a one-cell dead end
+    CHECK(state.leaves_room(Direction::Left));
+    CHECK(state.leaves_room(Direction::Down));
+    CHECK_FALSE(state.leaves_room(Direction::Right)); // reversing into the body
+}
+
+TEST_CASE("weighted_move weighs food against room to move", "[bitboard]") {
+    const std::string path = "test_bitboard_weighted.pack";
+    const std::array specs = {parse_level("Pocket", pocket).value()};
+    REQUIRE(write_file_atomically(path, LevelPack::build(specs)));
+    auto pack = LevelPack::open(path);
+    std::remove(path.c_str());
+    REQUIRE(pack.has_value());
+
+    Simulation sim(pack->level(0), Config::initial_tick, 1);
+    Snapshot snapshot;
+    sim.snapshot(snapshot);
+    snapshot.food = {4, 1}; // at the end of the dead end
+    sim.restore(snapshot);
+    CHECK(weighted_move(sim, {.food = 1.0f}) == Direction::Up);
+    CHECK(weighted_move(sim, {.food = 1.0f, .space = 2.0f}) != Direction::Up);
+    CHECK(weighted_move(sim, {.food = 0.0f, .straight = 1.0f}) == Direction::Left);
+
+    const auto weights = PolicyWeights{.food = 0.5f, .space = 1.5f, .tail = -1.0f};
+    CHECK(PolicyWeights::from(weights.to_array()).to_array() == weights.to_array());
+}
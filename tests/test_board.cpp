@@ -57,7 +57,6 @@ TEST_CASE("Board bonus food lifecycle", "[board]") {
 
     board.spawn_bonus(snake);
     CHECK(board.bonus_position().has_value());
-    CHECK(board.bonus_time_remaining() > 0.f);
 
     REQUIRE(board.bonus_position().has_value());
     auto pos = *board.bonus_position(); // NOLINT(bugprone-unchecked-optional-access)
@@ -66,9 +65,6 @@ TEST_CASE("Board bonus food lifecycle", "[board]") {
     CHECK(pos.y >= 0);
     CHECK(pos.y < 20);
     CHECK_FALSE(snake.occupies(pos));
-
-    board.update_bonus(10.f);
-    CHECK_FALSE(board.bonus_position().has_value());
 }
 
 TEST_CASE("Board clear_bonus removes bonus", "[board]") {
@@ -81,5 +77,4 @@ TEST_CASE("Board clear_bonus removes bonus", "[board]") {
 
     board.clear_bonus();
     CHECK_FALSE(board.bonus_position().has_value());
-    CHECK(board.bonus_time_remaining() == 0.f);
 }
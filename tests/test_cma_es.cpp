@@ -0,0 +1,56 @@
+#include "../src/CmaEs.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace {
+
+// Maximised at x[i] = i + 1, each dimension scaled by 10^i
+double ellipsoid(const std::vector<double>& x) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        const double scale = std::pow(10.0, static_cast<double>(i));
+        const double d = (x[i] - static_cast<double>(i + 1)) * scale;
+        sum += d * d;
+    }
+    return -sum;
+}
+
+double run(SepCmaEs& search, int generations) {
+    std::vector<double> fitness(search.population());
+    for (int g = 0; g < generations; ++g) {
+        const auto& candidates = search.ask();
+        for (std::size_t k = 0; k < candidates.size(); ++k) fitness[k] = ellipsoid(candidates[k]);
+        search.tell(fitness);
+    }
+    return search.best_fitness();
+}
+
+} // namespace
+
+TEST_CASE("SepCmaEs finds the top of a badly scaled ellipsoid", "[cma_es]") {
+    SepCmaEs search(std::vector<double>(4, 0.0), 1.0, 0, 1);
+    CHECK(search.population() == SepCmaEs::default_population(4));
+
+    CHECK(run(search, 400) > -1e-10);
+    REQUIRE(search.best().size() == 4);
+    for (std::size_t i = 0; i < 4; ++i) {
+        CHECK(std::abs(search.mean()[i] - static_cast<double>(i + 1)) < 1e-3);
+    }
+    CHECK(search.generation() == 400);
+    CHECK(search.sigma() < 1e-3);
+}
+
+TEST_CASE("SepCmaEs repeats its search from the same seed", "[cma_es]") {
+    SepCmaEs a(std::vector<double>(3, 0.5), 0.3, 8, 42);
+    SepCmaEs b(std::vector<double>(3, 0.5), 0.3, 8, 42);
+    SepCmaEs other(std::vector<double>(3, 0.5), 0.3, 8, 43);
+    CHECK(run(a, 20) == run(b, 20));
+    CHECK(a.mean() == b.mean());
+    CHECK(a.ask() == b.ask());
+    run(other, 20);
+    CHECK(a.mean() != other.mean());
+}
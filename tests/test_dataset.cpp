@@ -0,0 +1,207 @@
+#include "../src/Dataset.hpp"
+
+#include "../src/Config.hpp"
+#include "../src/FileIO.hpp"
+#include "../src/Level.hpp"
+#include "../src/Policy.hpp"
+#include "../src/Rng.hpp"
+#include "../src/Simulation.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string temp_path(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+struct Step {
+    Snapshot state;
+    Direction action;
+    int reward;
+    bool done;
+};
+
+// Plays games with the rollout policy until steps are recorded, keeping what was recorded
+std::vector<Step> play(DatasetBuffer& buffer, std::uint64_t first_seed, std::size_t steps,
+                       const Level* level = nullptr) {
+    std::vector<Step> played;
+    for (std::uint64_t seed = first_seed; played.size() < steps; ++seed) {
+        Simulation sim = level ? Simulation(*level, Config::initial_tick, seed)
+                               : Simulation(20, 20, Config::initial_tick, seed);
+        Rng rng(seed);
+        while (!sim.is_over() && played.size() < steps) {
+            Step step{};
+            sim.snapshot(step.state);
+            step.action = heuristic_move(sim, rng);
+            buffer.begin_step(sim, step.action);
+            const int before = sim.score();
+            sim.set_direction(step.action);
+            buffer.end_step(sim, sim.step());
+            step.reward = sim.score() - before;
+            step.done = sim.is_over();
+            played.push_back(step);
+        }
+    }
+    return played;
+}
+
+void check_same(const Transition& read, const Step& played) {
+    const Snapshot& a = read.state;
+    const Snapshot& b = played.state;
+    CHECK(a.tick == b.tick);
+    CHECK(a.score == b.score);
+    CHECK(a.grid_w == b.grid_w);
+    CHECK(a.direction == b.direction);
+    CHECK(a.flags == b.flags);
+    CHECK((a.food.x == b.food.x && a.food.y == b.food.y));
+    if ((b.flags & Snapshot::HasBonus) != 0) {
+        CHECK((a.bonus.x == b.bonus.x && a.bonus.y == b.bonus.y));
+        CHECK(a.bonus_expiry == b.bonus_expiry);
+    }
+    REQUIRE(a.body_length == b.body_length);
+    bool same_body = true;
+    for (std::size_t i = 0; i < b.body_length; ++i) {
+        const auto cb = b.cells[(b.body_start + i) % Snapshot::max_cells];
+        const auto ca = a.cells[(a.body_start + i) % Snapshot::max_cells];
+        same_body = same_body && ca.x == cb.x && ca.y == cb.y;
+    }
+    CHECK(same_body);
+    CHECK(read.action == played.action);
+    CHECK(read.reward == played.reward);
+    CHECK(read.done == played.done);
+}
+
+} // namespace
+
+TEST_CASE("DatasetReader reads back every recorded step across chunks", "[dataset]") {
+    const std::string path = temp_path("snake_test_dataset.bin");
+    std::vector<Step> played;
+    {
+        auto writer = DatasetWriter::create(path);
+        REQUIRE(writer.has_value());
+        DatasetBuffer buffer = writer->buffer();
+        played = play(buffer, 1, DatasetBuffer::chunk_steps * 2 + 100);
+        buffer.submit();
+        writer->flush();
+        CHECK(writer->steps_written() == played.size());
+        // Only the action and the odd event are stored per step
+        CHECK(writer->bytes_written() < played.size() * 4);
+    }
+
+    auto reader = DatasetReader::open(path);
+    REQUIRE(reader.has_value());
+    CHECK(reader->level().empty());
+    CHECK(reader->chunk_count() == 3);
+    REQUIRE(reader->size() == played.size());
+    Transition step;
+    std::uint64_t game = 0;
+    for (std::size_t i = 0; i < played.size(); ++i) {
+        REQUIRE(reader->read(i, step));
+        check_same(step, played[i]);
+        if (i > 0 && played[i - 1].done) ++game;
+        CHECK(step.game == 1 + game);
+    }
+    CHECK_FALSE(reader->read(played.size(), step));
+
+    Rng rng(5);
+    for (int i = 0; i < 100; ++i) REQUIRE(reader->sample(rng, step));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("DatasetWriter takes chunks from many threads", "[dataset]") {
+    const std::string path = temp_path("snake_test_dataset_threads.bin");
+    constexpr int threads = 4;
+    constexpr std::size_t steps = DatasetBuffer::chunk_steps + 500;
+    {
+        auto writer = DatasetWriter::create(path);
+        REQUIRE(writer.has_value());
+        std::vector<std::jthread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&writer, t] {
+                DatasetBuffer buffer = writer->buffer();
+                play(buffer, 1000 * static_cast<std::uint64_t>(t + 1), steps);
+            }); // the buffer hands over its partial chunk as the thread ends
+        }
+    }
+
+    auto reader = DatasetReader::open(path);
+    REQUIRE(reader.has_value());
+    CHECK(reader->size() == threads * steps);
+    CHECK(reader->chunk_count() == threads * 2);
+    Transition step;
+    bool all_read = true;
+    for (std::uint64_t i = 0; i < reader->size(); ++i) {
+        all_read = all_read && reader->read(i, step);
+    }
+    CHECK(all_read);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("DatasetReader follows portals and ignores a partial last chunk", "[dataset]") {
+    constexpr std::string_view portal_room = "#######\n"
+                                             "#.....#\n"
+                                             "#A.#..#\n"
+                                             "#..<..#\n"
+                                             "#...A.#\n"
+                                             "#.....#\n"
+                                             "#######\n";
+    const std::string pack_path = temp_path("snake_test_dataset.pack");
+    const std::array specs = {parse_level("Portal", portal_room).value()};
+    REQUIRE(write_file_atomically(pack_path, LevelPack::build(specs)));
+    auto pack = LevelPack::open(pack_path);
+    std::filesystem::remove(pack_path);
+    REQUIRE(pack.has_value());
+
+    const std::string path = temp_path("snake_test_dataset_portal.bin");
+    std::vector<Step> played;
+    {
+        auto writer = DatasetWriter::create(path, "Portal");
+        REQUIRE(writer.has_value());
+        DatasetBuffer buffer = writer->buffer();
+        // Steers through the portal: the body then jumps between (1, 2) and (4, 4)
+        Simulation sim(pack->level(0), Config::initial_tick, 1);
+        for (const Direction dir : {Direction::Left, Direction::Up, Direction::Left,
+                                    Direction::Left, Direction::Up}) {
+            Step step{};
+            sim.snapshot(step.state);
+            step.action = dir;
+            buffer.begin_step(sim, dir);
+            const int before = sim.score();
+            sim.set_direction(dir);
+            buffer.end_step(sim, sim.step());
+            step.reward = sim.score() - before;
+            step.done = sim.is_over();
+            played.push_back(step);
+        }
+        buffer.submit();
+        // A second chunk, cut short below
+        DatasetBuffer tail = writer->buffer();
+        play(tail, 1, 1, &pack->level(0));
+    }
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+
+    auto reader = DatasetReader::open(path);
+    REQUIRE(reader.has_value());
+    CHECK(reader->level() == "Portal");
+    REQUIRE(reader->size() == played.size());
+    Transition step;
+    for (std::size_t i = 0; i < played.size(); ++i) {
+        REQUIRE(reader->read(i, step));
+        check_same(step, played[i]);
+    }
+
+    Bytes garbage = {'S', 'N', 'K', 'X'};
+    REQUIRE(write_file_atomically(path, garbage));
+    CHECK_FALSE(DatasetReader::open(path).has_value());
+    std::filesystem::remove(path);
+}
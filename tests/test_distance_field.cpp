@@ -0,0 +1,106 @@
+#include "../src/DistanceField.hpp"
+
+#include "../src/Config.hpp"
+#include "../src/FileIO.hpp"
+#include "../src/Policy.hpp"
+#include "../src/Rng.hpp"
+#include "../src/Simulation.hpp"
+#include "../src/Snapshot.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+constexpr std::string_view pillars = "##########\n"
+                                     "#........#\n"
+                                     "#.#..A.#.#\n"
+                                     "#........#\n"
+                                     "#...<....#\n"
+                                     "#.#....#.#\n"
+                                     "#...A....#\n"
+                                     "##########\n";
+
+// True when sim's tracked field matches a from-scratch BFS in every cell
+bool matches_fresh_field(const Simulation& sim) {
+    const DistanceField& field = *sim.board().distance_field();
+    DistanceField fresh(sim.board().level());
+    fresh.reset(sim.board().food_position(), sim.snake());
+    for (int y = 0; y < sim.board().height(); ++y) {
+        for (int x = 0; x < sim.board().width(); ++x) {
+            if (field.distance({x, y}) != fresh.distance({x, y})) return false;
+        }
+    }
+    return field.reachable_count() == fresh.reachable_count();
+}
+
+// Plays heuristic games with the field enabled, checking it after every tick
+void check_games(const Level& level, std::uint64_t seeds) {
+    for (std::uint64_t seed = 1; seed <= seeds; ++seed) {
+        Simulation sim(level, Config::initial_tick, seed);
+        sim.enable_distance_field();
+        Rng rng(seed);
+        std::uint32_t foods = 0;
+        while (sim.tick() < 400) {
+            sim.set_direction(heuristic_move(sim, rng));
+            const TickEvents events = sim.step();
+            if (events.died) break;
+            if (events.ate_food) ++foods;
+            REQUIRE(matches_fresh_field(sim));
+        }
+        // One full pass per food, plus rare fallbacks; everything else is incremental
+        CHECK(sim.board().distance_field()->full_recomputes() < foods + 1 + sim.tick() / 4);
+    }
+}
+
+} // namespace
+
+TEST_CASE("DistanceField measures path lengths around obstacles", "[distance]") {
+    const Simulation sim(10, 10, Config::initial_tick, 1);
+    DistanceField field(sim.board().level());
+    field.reset({0, 0}, sim.snake());
+
+    CHECK(field.distance({0, 0}) == 0);
+    CHECK(field.distance({3, 4}) == 7);
+    CHECK(field.distance(sim.snake().head()) == DistanceField::unreachable);
+    CHECK(field.distance({-1, 0}) == DistanceField::unreachable);
+    CHECK(field.reachable_count() == 100 - 3);
+
+    // The head is blocked but still gets a first move towards the target
+    const auto move = field.next_move(sim.snake().head());
+    REQUIRE(move.has_value());
+    const sf::Vector2i next = sim.snake().head() + direction_delta(*move);
+    CHECK(field.distance(next) + 1 == 5 + 5);
+}
+
+TEST_CASE("DistanceField updates incrementally as the snake moves", "[distance]") {
+    check_games(Level::open_board(12, 12), 20);
+
+    const std::string path = "test_distance_field.pack";
+    const std::array specs = {parse_level("Pillars", pillars).value()};
+    REQUIRE(write_file_atomically(path, LevelPack::build(specs)));
+    auto pack = LevelPack::open(path);
+    std::remove(path.c_str());
+    REQUIRE(pack.has_value());
+    check_games(pack->level(0), 20);
+}
+
+TEST_CASE("DistanceField follows restores and copies", "[distance]") {
+    Simulation sim(10, 10, Config::initial_tick, 3);
+    sim.enable_distance_field();
+    Snapshot snapshot;
+    sim.snapshot(snapshot);
+    Rng rng(3);
+    for (int i = 0; i < 20 && !sim.is_over(); ++i) {
+        sim.set_direction(heuristic_move(sim, rng));
+        sim.step();
+    }
+
+    Simulation copy = sim;
+    copy.restore(snapshot);
+    CHECK(matches_fresh_field(copy));
+    CHECK(matches_fresh_field(sim));
+}
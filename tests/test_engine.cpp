@@ -0,0 +1,115 @@
+#include "../src/Engine.hpp"
+
+#include "../src/Config.hpp"
+#include "../src/Simulation.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// Answers every state with Left, and says nothing else
+constexpr const char* left_engine =
+    "read hello; echo ready shell; "
+    "while read kind id rest; do "
+    "case $kind in state) echo \"move $id L\";; quit) exit;; esac; "
+    "done";
+
+} // namespace
+
+TEST_CASE("Engine round-trips states and moves over pipes", "[engine]") {
+    auto engine = Engine::start(left_engine, 2000ms);
+    REQUIRE(engine.has_value());
+    CHECK(engine->name() == "shell");
+
+    Simulation sim(20, 20, Config::initial_tick, 1);
+    for (int i = 0; i < 5; ++i) {
+        REQUIRE(engine->request(sim, 1000us));
+        const auto move = engine->wait(Engine::Clock::now() + 2s);
+        REQUIRE(move.has_value());
+        CHECK(*move == Direction::Left);
+        sim.step();
+    }
+    // Answered already: nothing more to wait for
+    CHECK_FALSE(engine->poll().has_value());
+    CHECK_FALSE(engine->wait(Engine::Clock::now() + 10ms).has_value());
+
+    const EngineStats& stats = engine->stats();
+    CHECK(stats.requests == 5);
+    CHECK(stats.replies == 5);
+    CHECK(stats.timeouts == 0);
+    CHECK(stats.latency.count() == 5);
+}
+
+TEST_CASE("Engine replies to superseded requests count as stale", "[engine]") {
+    auto engine = Engine::start(left_engine, 2000ms);
+    REQUIRE(engine.has_value());
+
+    Simulation sim(20, 20, Config::initial_tick, 1);
+    REQUIRE(engine->request(sim, 1000us));
+    REQUIRE(engine->request(sim, 1000us));
+    REQUIRE(engine->wait(Engine::Clock::now() + 2s).has_value());
+    // The first reply precedes the second on the pipe, so both are in by now
+    CHECK(engine->stats().stale == 1);
+    CHECK(engine->stats().replies == 1);
+}
+
+TEST_CASE("Engine reports silent and missing engines", "[engine]") {
+    CHECK_FALSE(Engine::start("exit 0", 2000ms).has_value());
+    CHECK_FALSE(Engine::start("read hello; sleep 5", 50ms).has_value());
+
+    auto silent = Engine::start("read hello; echo ready; cat > /dev/null", 2000ms);
+    REQUIRE(silent.has_value());
+    Simulation sim(20, 20, Config::initial_tick, 1);
+    REQUIRE(silent->request(sim, 1000us));
+    CHECK_FALSE(silent->wait(Engine::Clock::now() + 20ms).has_value());
+    CHECK(silent->stats().timeouts == 1);
+}
+
+TEST_CASE("Engine never blocks on an engine that stops reading", "[engine]") {
+    const auto start = Engine::Clock::now();
+    {
+        auto stuck = Engine::start("read hello; echo ready; sleep 30", 2000ms);
+        REQUIRE(stuck.has_value());
+        Simulation sim(30, 30, Config::initial_tick, 1);
+        // About 60 bytes a state, so the pipe fills long before the last
+        auto slowest = Engine::Clock::duration::zero();
+        for (int i = 0; i < 5000; ++i) {
+            const auto sent = Engine::Clock::now();
+            REQUIRE(stuck->request(sim, 1000us));
+            CHECK_FALSE(stuck->poll().has_value());
+            slowest = std::max(slowest, Engine::Clock::now() - sent);
+        }
+        CHECK(slowest < 100ms);
+        CHECK(stuck->stats().skipped > 0);
+
+        const auto waited = Engine::Clock::now();
+        CHECK_FALSE(stuck->wait(waited + 20ms).has_value());
+        CHECK(Engine::Clock::now() - waited < 1s);
+        CHECK(stuck->alive());
+    }
+    // Destruction kills the engine after its grace period rather than waiting out the sleep
+    CHECK(Engine::Clock::now() - start < 10s);
+}
+
+TEST_CASE("LatencyStats percentiles stay within a bucket of the true value", "[engine]") {
+    LatencyStats stats;
+    CHECK(stats.percentile(0.5) == 0ns);
+    for (int us = 1; us <= 1000; ++us) stats.record(std::chrono::microseconds{us});
+
+    CHECK(stats.count() == 1000);
+    CHECK(stats.min() == 1us);
+    CHECK(stats.max() == 1000us);
+    CHECK(stats.mean() == 500500ns);
+    const auto p50 = stats.percentile(0.5);
+    CHECK(p50 >= 500us);
+    CHECK(p50 <= 500us * 9 / 8);
+    const auto p99 = stats.percentile(0.99);
+    CHECK(p99 >= 990us);
+    CHECK(p99 <= 1000us);
+    CHECK(stats.percentile(1.0) == 1000us);
+}
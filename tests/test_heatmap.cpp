@@ -0,0 +1,86 @@
+#include "../src/Heatmap.hpp"
+
+#include "../src/Config.hpp"
+#include "../src/Policy.hpp"
+#include "../src/Rng.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <span>
+#include <string>
+
+namespace {
+
+// Plays one heuristic game into heatmap and returns its final state
+Simulation play(Heatmap& heatmap, std::uint64_t seed) {
+    Simulation sim(10, 10, Config::initial_tick, seed);
+    Rng rng(seed);
+    heatmap.record_start(sim);
+    while (!sim.is_over() && sim.tick() < 2000) {
+        sim.set_direction(heuristic_move(sim, rng));
+        heatmap.record(sim, sim.step());
+    }
+    return sim;
+}
+
+std::uint64_t total(const Heatmap& heatmap, HeatCounter counter) {
+    const auto counts = heatmap.counts(counter);
+    return std::accumulate(counts.begin(), counts.end(), std::uint64_t{0});
+}
+
+} // namespace
+
+TEST_CASE("Heatmap counts every tick, death and food spawn", "[heatmap]") {
+    Heatmap heatmap(10, 10);
+    const Simulation sim = play(heatmap, 7);
+
+    CHECK(total(heatmap, HeatCounter::Visits) == sim.tick());
+    CHECK(total(heatmap, HeatCounter::Deaths) == (sim.is_over() ? 1 : 0));
+    // The starting food plus one per food eaten, while bonuses are worth more
+    CHECK(total(heatmap, HeatCounter::Food) >= 1);
+    CHECK(total(heatmap, HeatCounter::Food) <= static_cast<std::uint64_t>(sim.score()) + 1);
+    if (sim.is_over()) {
+        CHECK(heatmap.at(HeatCounter::Deaths, sim.snake().head()) == 1);
+    }
+}
+
+TEST_CASE("Heatmap merges per-thread counts", "[heatmap]") {
+    Heatmap a(10, 10);
+    Heatmap b(10, 10);
+    Heatmap both(10, 10);
+    play(a, 1);
+    play(b, 2);
+    play(both, 1);
+    play(both, 2);
+
+    a.merge(b);
+    for (std::size_t c = 0; c < heat_counter_count; ++c) {
+        const auto counter = static_cast<HeatCounter>(c);
+        CHECK(std::ranges::equal(a.counts(counter), both.counts(counter)));
+    }
+
+    a.clear();
+    CHECK(a.max(HeatCounter::Visits) == 0);
+}
+
+TEST_CASE("Heatmap exports CSV and PGM", "[heatmap]") {
+    Heatmap heatmap(4, 3);
+    const Simulation sim(4, 3, Config::initial_tick, 1);
+    heatmap.record_start(sim);
+    heatmap.record(sim, {.died = true});
+
+    const std::string csv = heatmap.to_csv();
+    CHECK(csv.starts_with("x,y,visits,deaths,food,bonus\n0,0,"));
+    CHECK(std::ranges::count(csv, '\n') == 1 + 4 * 3);
+
+    const Bytes pgm = heatmap.to_pgm(HeatCounter::Deaths);
+    const std::string header = "P5\n4 3\n255\n";
+    REQUIRE(pgm.size() == header.size() + 4 * 3);
+    CHECK(std::ranges::equal(header, std::span(pgm).first(header.size())));
+    const sf::Vector2i head = sim.snake().head();
+    const auto pixel = header.size() + static_cast<std::size_t>(head.y * 4 + head.x);
+    CHECK(pgm[pixel] == 255);
+    CHECK(std::ranges::count(pgm, 0) == 4 * 3 - 1);
+}
@@ -0,0 +1,132 @@
+#include "../src/FileIO.hpp"
+#include "../src/Leaderboard.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+
+using std::chrono::milliseconds;
+
+namespace {
+
+LeaderboardKey grid(int size) {
+    return LeaderboardKey::open_board(size);
+}
+
+} // namespace
+
+TEST_CASE("Leaderboard keeps the top entries per configuration", "[leaderboard]") {
+    Leaderboard board;
+    CHECK(board.submit(grid(20), milliseconds{150}, 10, 1) == 0);
+    CHECK(board.submit(grid(20), milliseconds{150}, 30, 2) == 0);
+    CHECK(board.submit(grid(20), milliseconds{150}, 20, 3) == 1);
+    CHECK(board.submit(grid(20), milliseconds{150}, 20, 4) == 2); // ties rank below existing scores
+    CHECK(board.submit(grid(30), milliseconds{100}, 5, 5) == 0);
+
+    CHECK(board.best(grid(20), milliseconds{150}) == 30);
+    CHECK(board.best(grid(30), milliseconds{100}) == 5);
+    CHECK(board.best(grid(15), milliseconds{150}) == 0);
+
+    const auto entries = board.entries(grid(20), milliseconds{150});
+    REQUIRE(entries.size() == 4);
+    CHECK(entries[1] == LeaderboardEntry{20, 3});
+    CHECK(entries[2] == LeaderboardEntry{20, 4});
+
+    for (int i = 0; i < 20; ++i) {
+        board.submit(grid(20), milliseconds{150}, 100 + i, i);
+    }
+    CHECK(board.entries(grid(20), milliseconds{150}).size() == Leaderboard::max_entries);
+    CHECK_FALSE(board.submit(grid(20), milliseconds{150}, 1, 0).has_value());
+    CHECK(board.best(grid(20), milliseconds{150}) == 119);
+}
+
+TEST_CASE("Leaderboard replaces a resubmitted game's entry rather than adding one",
+          "[leaderboard]") {
+    Leaderboard board;
+    board.submit(grid(20), milliseconds{150}, 30, 1);
+    board.submit(grid(20), milliseconds{150}, 20, 2);
+
+    CHECK(board.replace(grid(20), milliseconds{150}, LeaderboardEntry{20, 2}, 40, 3) == 0);
+    auto entries = board.entries(grid(20), milliseconds{150});
+    REQUIRE(entries.size() == 2);
+    CHECK(entries[0] == LeaderboardEntry{40, 3});
+    CHECK(entries[1] == LeaderboardEntry{30, 1});
+
+    CHECK(board.replace(grid(20), milliseconds{150}, LeaderboardEntry{40, 3}, 10, 4) == 1);
+    entries = board.entries(grid(20), milliseconds{150});
+    REQUIRE(entries.size() == 2);
+    CHECK(entries[1] == LeaderboardEntry{10, 4});
+
+    // An entry that already dropped off leaves the others alone
+    CHECK(board.replace(grid(20), milliseconds{150}, LeaderboardEntry{5, 9}, 35, 5) == 0);
+    CHECK(board.entries(grid(20), milliseconds{150}).size() == 3);
+}
+
+TEST_CASE("Leaderboard round-trips its binary format and rejects corrupt data", "[leaderboard]") {
+    Leaderboard board;
+    board.submit(grid(20), milliseconds{150}, 42, 1700000000);
+    board.submit(grid(25), milliseconds{200}, 7, 1700000001);
+
+    const Bytes bytes = board.serialize();
+    Leaderboard copy;
+    REQUIRE(copy.parse(bytes));
+    CHECK(copy.best(grid(20), milliseconds{150}) == 42);
+    CHECK(copy.entries(grid(25), milliseconds{200})[0] == LeaderboardEntry{7, 1700000001});
+
+    Bytes truncated(bytes.begin(), bytes.end() - 3);
+    CHECK_FALSE(copy.parse(truncated));
+    CHECK(copy.best(grid(20), milliseconds{150}) == 0);
+}
+
+TEST_CASE("Leaderboard keys levels by name and drops version 1's pack-index tables",
+          "[leaderboard]") {
+    Leaderboard board;
+    board.submit(LeaderboardKey::for_level("maze"), milliseconds{150}, 12, 1);
+    board.submit(LeaderboardKey::for_level("rooms"), milliseconds{150}, 9, 2);
+    board.submit(grid(20), milliseconds{150}, 5, 3);
+
+    Leaderboard copy;
+    REQUIRE(copy.parse(board.serialize()));
+    CHECK(copy.best(LeaderboardKey::for_level("maze"), milliseconds{150}) == 12);
+    CHECK(copy.best(LeaderboardKey::for_level("rooms"), milliseconds{150}) == 9);
+    CHECK(copy.best(LeaderboardKey::for_level("spiral"), milliseconds{150}) == 0);
+    CHECK(copy.best(grid(20), milliseconds{150}) == 5);
+
+    // Version 1: a 20x20 table and a level table keyed 100 + pack index
+    Bytes v1 = {'S', 'N', 'K', 'L'};
+    put_le(v1, std::uint16_t{1});
+    put_le(v1, std::uint16_t{2});
+    for (const int key : {20, 101}) {
+        put_le(v1, static_cast<std::uint8_t>(key));
+        put_le(v1, std::uint8_t{1});
+        put_le(v1, std::uint16_t{150});
+        put_le(v1, static_cast<std::int32_t>(key));
+        put_le(v1, std::int64_t{4});
+    }
+    REQUIRE(copy.parse(v1));
+    CHECK(copy.best(grid(20), milliseconds{150}) == 20);
+    CHECK(copy.best(grid(101), milliseconds{150}) == 0);
+}
+
+TEST_CASE("AsyncFileWriter replaces files atomically in the background", "[leaderboard]") {
+    const std::string path = "test_leaderboard.bin";
+    Leaderboard board;
+    board.submit(grid(20), milliseconds{150}, 9, 0);
+
+    AsyncFileWriter writer;
+    writer.write(path, Bytes{1, 2, 3});
+    writer.write(path, board.serialize()); // supersedes the first write if still queued
+    writer.flush();
+
+    CHECK_FALSE(std::filesystem::exists(path + ".tmp"));
+    Leaderboard loaded;
+    REQUIRE(loaded.load(path));
+    CHECK(loaded.best(grid(20), milliseconds{150}) == 9);
+    std::remove(path.c_str());
+
+    CHECK_FALSE(loaded.load(path));
+    CHECK(loaded.best(grid(20), milliseconds{150}) == 0);
+}
@@ -0,0 +1,153 @@
+#include "../src/FileIO.hpp"
+#include "../src/Level.hpp"
+#include "../src/Replay.hpp"
+#include "../src/Simulation.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdio>
+#include <string>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr std::string_view portal_room = "; 7x7 room with one portal\n"
+                                         "#######\n"
+                                         "#.....#\n"
+                                         "#A.#..#\n"
+                                         "#..<..#\n"
+                                         "#...A.#\n"
+                                         "#.....#\n"
+                                         "#######\n";
+
+constexpr std::string_view small_room = "#####\n"
+                                        "#<..#\n"
+                                        "#...#\n"
+                                        "#...#\n"
+                                        "#####\n";
+
+// Parses and packs the layouts into path, then maps the pack
+LevelPack make_pack(const std::string& path) {
+    const std::array specs = {parse_level("Portal", portal_room).value(),
+                              parse_level("Small", small_room).value()};
+    REQUIRE(write_file_atomically(path, LevelPack::build(specs)));
+    auto pack = LevelPack::open(path);
+    std::remove(path.c_str()); // the mapping outlives the directory entry
+    REQUIRE(pack.has_value());
+    return std::move(*pack);
+}
+
+} // namespace
+
+TEST_CASE("parse_level reads walls, spawn and portals and rejects bad layouts", "[level]") {
+    const auto spec = parse_level("Portal", portal_room);
+    REQUIRE(spec.has_value());
+    CHECK(spec->width == 7);
+    CHECK(spec->height == 7);
+    CHECK(spec->spawn == sf::Vector2i{3, 3});
+    CHECK(spec->spawn_direction == Direction::Left);
+    REQUIRE(spec->portals.size() == 1);
+    CHECK(spec->portals[0].a() == sf::Vector2i{1, 2});
+    CHECK(spec->portals[0].b() == sf::Vector2i{4, 4});
+
+    CHECK_FALSE(parse_level("Ragged", "#####\n#<..#\n#...\n#...#\n#####\n"));
+    CHECK_FALSE(parse_level("NoSpawn", "#####\n#...#\n#...#\n#...#\n#####\n"));
+    CHECK_FALSE(parse_level("OneEnd", "#####\n#<..#\n#..A#\n#...#\n#####\n"));
+    CHECK_FALSE(parse_level("Blocked", "#####\n#.>.#\n#...#\n#...#\n#####\n"));
+    CHECK_FALSE(parse_level("", small_room));
+}
+
+TEST_CASE("LevelPack maps levels and rejects corrupt packs", "[level]") {
+    const LevelPack pack = make_pack("test_levels.pack");
+    REQUIRE(pack.size() == 2);
+    CHECK(pack.find("Small") == 1);
+    CHECK_FALSE(pack.find("Missing"));
+
+    const Level& level = pack.level(0);
+    CHECK(level.name == "Portal");
+    CHECK(level.spawn == sf::Vector2i{3, 3});
+    CHECK(level.wall_count() == 25);
+    CHECK(level.free_cells.size() == 24);
+    CHECK(level.is_wall({0, 0}));
+    CHECK(level.is_wall({3, 2}));
+    CHECK_FALSE(level.is_wall({2, 2}));
+    CHECK(level.portal_exit({1, 2}) == sf::Vector2i{4, 4});
+    CHECK(level.portal_exit({2, 2}) == sf::Vector2i{2, 2});
+
+    const std::string path = "test_levels_corrupt.pack";
+    const std::array specs = {parse_level("Small", small_room).value()};
+    Bytes bytes = LevelPack::build(specs);
+    bytes[16 + 24] = 200; // width beyond any grid
+    REQUIRE(write_file_atomically(path, bytes));
+    CHECK_FALSE(LevelPack::open(path));
+    bytes[16 + 24] = 5;
+    bytes.pop_back();
+    REQUIRE(write_file_atomically(path, bytes));
+    CHECK_FALSE(LevelPack::open(path)); // size no longer matches the header
+    std::remove(path.c_str());
+    CHECK_FALSE(LevelPack::open(path));
+}
+
+TEST_CASE("Food never spawns on walls or the snake", "[level]") {
+    const LevelPack pack = make_pack("test_levels_food.pack");
+    const Level& level = pack.level(1); // nine floor cells, three under the snake
+    Snake snake;
+    snake.reset(level);
+    CHECK(snake.head() == sf::Vector2i{1, 1});
+    CHECK(snake.body().back() == sf::Vector2i{3, 1});
+
+    Board board(level, 7);
+    for (int i = 0; i < 200; ++i) {
+        board.spawn_food(snake);
+        const auto food = board.food_position();
+        CHECK_FALSE(board.is_blocked(food));
+        CHECK_FALSE(snake.occupies(food));
+    }
+}
+
+TEST_CASE("Simulation on a level dies on walls and follows portals", "[level]") {
+    const LevelPack pack = make_pack("test_levels_sim.pack");
+    const Level& level = pack.level(0);
+
+    Simulation walls(level, 150ms, 1);
+    walls.step(); // (2, 3)
+    walls.step(); // (1, 3)
+    CHECK_FALSE(walls.is_over());
+    walls.step(); // the border
+    CHECK(walls.is_over());
+
+    Simulation portal(level, 150ms, 1);
+    portal.step(); // (2, 3)
+    portal.set_direction(Direction::Up);
+    portal.step(); // (2, 2)
+    portal.set_direction(Direction::Left);
+    portal.step(); // onto the portal at (1, 2)
+    CHECK_FALSE(portal.is_over());
+    CHECK(portal.snake().head() == sf::Vector2i{4, 4});
+    portal.step();
+    CHECK(portal.snake().head() == sf::Vector2i{3, 4});
+}
+
+TEST_CASE("Replays record and verify against their level", "[level]") {
+    const LevelPack pack = make_pack("test_levels_replay.pack");
+    const Level& level = pack.level(0);
+
+    Simulation sim(level, 150ms, 99);
+    ReplayRecorder recorder;
+    recorder.begin(sim);
+    for (const Direction dir : {Direction::Left, Direction::Up, Direction::Left, Direction::Left,
+                                Direction::Left}) {
+        sim.set_direction(dir);
+        recorder.before_step(sim);
+        sim.step();
+        recorder.after_step(sim);
+    }
+
+    const auto replay = Replay::parse(recorder.replay().serialize());
+    REQUIRE(replay.has_value());
+    CHECK(replay->level == "Portal");
+    CHECK(verify_replay(*replay, level).ok);
+    CHECK_FALSE(verify_replay(*replay).ok); // the open board is a different game
+}
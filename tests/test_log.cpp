@@ -0,0 +1,71 @@
+#include "../src/Log.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("LogQueue rejects records when full and accepts them again once drained", "[log]") {
+    LogQueue queue(4);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(queue.try_push(LogLevel::Info, "message"));
+    }
+    CHECK_FALSE(queue.try_push(LogLevel::Info, "overflow"));
+
+    LogQueue::Record record;
+    REQUIRE(queue.try_pop(record));
+    CHECK(std::string(record.text.data(), record.size) == "message");
+    CHECK(queue.try_push(LogLevel::Error, "after"));
+}
+
+TEST_CASE("LogQueue delivers every record from concurrent producers exactly once", "[log]") {
+    LogQueue queue(1024);
+    constexpr int producers = 4;
+    constexpr int per_producer = 200;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, p] {
+            for (int i = 0; i < per_producer; ++i) {
+                const std::string msg = std::to_string(p * per_producer + i);
+                while (!queue.try_push(LogLevel::Info, msg)) {
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    std::vector<int> seen(producers * per_producer, 0);
+    LogQueue::Record record;
+    while (queue.try_pop(record)) {
+        ++seen[std::stoi(std::string(record.text.data(), record.size))];
+    }
+    for (const int count : seen) {
+        CHECK(count == 1);
+    }
+}
+
+TEST_CASE("Log writes formatted records with level prefixes in the background", "[log]") {
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    Log::set_output(file, file);
+
+    Log::info("Score: {}", 42);
+    Log::error("disk {}", "full");
+    Log::debug("hidden at the default level");
+    Log::flush();
+    Log::set_output(stdout, stderr);
+
+    std::string text(256, '\0');
+    std::rewind(file);
+    text.resize(std::fread(text.data(), 1, text.size(), file));
+    std::fclose(file);
+
+    CHECK(text.contains("[snake] Score: 42\n"));
+    CHECK(text.contains("[snake] Error: disk full\n"));
+    CHECK_FALSE(text.contains("hidden"));
+}
@@ -0,0 +1,83 @@
+#include "../src/Mcts.hpp"
+
+#include "../src/FileIO.hpp"
+#include "../src/Level.hpp"
+#include "../src/Policy.hpp"
+#include "../src/Snapshot.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+// Runs the snake left until its head is next to the left wall
+Simulation at_left_wall() {
+    Simulation sim(20, 20, std::chrono::milliseconds{150}, 9);
+    while (sim.snake().head().x > 0) {
+        sim.step();
+    }
+    return sim;
+}
+
+} // namespace
+
+TEST_CASE("Policy never picks a move into the wall", "[mcts]") {
+    const Simulation sim = at_left_wall();
+    CHECK_FALSE(is_safe_move(sim, Direction::Left));
+    CHECK_FALSE(is_safe_move(sim, Direction::Right)); // reversing is not a move
+
+    Rng rng(1);
+    for (int i = 0; i < 50; ++i) {
+        const Direction dir = heuristic_move(sim, rng);
+        CHECK((dir == Direction::Up || dir == Direction::Down));
+    }
+}
+
+TEST_CASE("Mcts avoids an immediately fatal move", "[mcts]") {
+    const Simulation sim = at_left_wall();
+    Mcts mcts(2);
+    const auto deadline = Mcts::Clock::now() + std::chrono::seconds(5);
+    const Direction dir = mcts.search(sim, 500, deadline);
+    CHECK((dir == Direction::Up || dir == Direction::Down));
+    CHECK(mcts.last_rollouts() >= 500);
+}
+
+TEST_CASE("Mcts plans on the root's level, not an open board of its size", "[mcts]") {
+    // Left and Up run into walls and Down enters a portal. On an open board of the same size
+    // Left and Up would be safe and Down a dead end inside the body.
+    constexpr std::string_view walled = "##########\n"
+                                        "#..#<....#\n"
+                                        "#...A....#\n"
+                                        "#........#\n"
+                                        "#......A.#\n"
+                                        "##########\n";
+    const std::string path = "test_mcts.pack";
+    const std::array specs = {parse_level("Walled", walled).value()};
+    REQUIRE(write_file_atomically(path, LevelPack::build(specs)));
+    auto pack = LevelPack::open(path);
+    std::remove(path.c_str());
+    REQUIRE(pack.has_value());
+
+    Simulation sim(pack->level(0), std::chrono::milliseconds{150}, 1);
+    Snapshot snapshot;
+    sim.snapshot(snapshot);
+    constexpr std::array<Snapshot::Cell, 9> body = {
+        {{4, 1}, {5, 1}, {5, 2}, {5, 3}, {4, 3}, {3, 3}, {3, 2}, {2, 2}, {2, 1}}};
+    snapshot.body_start = 0;
+    snapshot.body_length = body.size();
+    std::ranges::copy(body, snapshot.cells.begin());
+    snapshot.food = {1, 1};
+    sim.restore(snapshot);
+    REQUIRE_FALSE(is_safe_move(sim, Direction::Left));
+    REQUIRE_FALSE(is_safe_move(sim, Direction::Up));
+    REQUIRE(is_safe_move(sim, Direction::Down));
+
+    Mcts mcts(2);
+    const auto deadline = Mcts::Clock::now() + std::chrono::seconds(5);
+    CHECK(mcts.search(sim, 500, deadline) == Direction::Down);
+}
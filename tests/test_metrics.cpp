@@ -0,0 +1,80 @@
+#include "../src/Metrics.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// A plain HTTP/1.0 client; returns everything the server sent
+std::string fetch(std::uint16_t port, const std::string& path) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    std::string response;
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0) {
+        const std::string request = "GET " + path + " HTTP/1.0\r\nHost: localhost\r\n\r\n";
+        static_cast<void>(::send(fd, request.data(), request.size(), 0));
+        std::array<char, 4096> buf;
+        for (ssize_t got = 0; (got = ::recv(fd, buf.data(), buf.size(), 0)) > 0;) {
+            response.append(buf.data(), static_cast<std::size_t>(got));
+        }
+    }
+    ::close(fd);
+    return response;
+}
+
+} // namespace
+
+TEST_CASE("Histogram renders cumulative Prometheus buckets", "[metrics]") {
+    Histogram histogram{10, 100};
+    for (const std::uint64_t value : {5, 10, 11, 500}) histogram.observe(value);
+
+    std::string out;
+    histogram.render(out, "test_seconds", "Test values", 0.5);
+    CHECK(out == "# HELP test_seconds Test values\n"
+                 "# TYPE test_seconds histogram\n"
+                 "test_seconds_bucket{le=\"5\"} 2\n"
+                 "test_seconds_bucket{le=\"50\"} 3\n"
+                 "test_seconds_bucket{le=\"+Inf\"} 4\n"
+                 "test_seconds_sum 263\n"
+                 "test_seconds_count 4\n");
+}
+
+TEST_CASE("ShardedCounter sums increments from every thread", "[metrics]") {
+    ShardedCounter counter;
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < 1000; ++i) counter.add();
+        });
+    }
+    threads.clear();
+    CHECK(counter.value() == 8000);
+}
+
+TEST_CASE("MetricsServer serves the metrics over HTTP on localhost", "[metrics]") {
+    auto server = MetricsServer::start(0);
+    REQUIRE(server.has_value());
+    REQUIRE(server->port() != 0);
+
+    Metrics::ticks.add(3);
+    const std::string response = fetch(server->port(), "/metrics");
+    CHECK(response.starts_with("HTTP/1.0 200 OK\r\n"));
+    CHECK(response.find("text/plain; version=0.0.4") != std::string::npos);
+    CHECK(response.find("\n# TYPE snake_ticks_total counter\n") != std::string::npos);
+    CHECK(response.find("snake_frame_seconds_bucket{le=\"+Inf\"}") != std::string::npos);
+
+    CHECK(fetch(server->port(), "/other").starts_with("HTTP/1.0 404"));
+}
@@ -0,0 +1,77 @@
+#include "../src/Observation.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace {
+
+float at(std::span<const float> obs, const ObservationLayout& layout, ObservationPlane plane,
+         sf::Vector2i p) {
+    return obs[layout.plane_offset(plane) + static_cast<std::size_t>(p.y * layout.width + p.x)];
+}
+
+} // namespace
+
+TEST_CASE("Observations encode snake, food and scalars", "[observation]") {
+    const ObservationLayout layout{.width = 12, .height = 10};
+    const std::vector<Simulation> games = {Simulation(10, 10, Config::initial_tick, 1),
+                                           Simulation(12, 10, Config::initial_tick, 2)};
+    std::vector<float> out(games.size() * layout.stride(), -1.f);
+    encode_observations(games, layout, out);
+
+    const std::span<const float> first(out.data(), layout.stride());
+    const Simulation& sim = games[0];
+    const sf::Vector2i head = sim.snake().head();
+    CHECK(at(first, layout, ObservationPlane::Head, head) == 1.f);
+    CHECK(at(first, layout, ObservationPlane::Body, head) == 1.f);
+    CHECK(at(first, layout, ObservationPlane::Food, sim.board().food_position()) == 1.f);
+
+    // The body fades towards the tail; three cells at the start
+    const sf::Vector2i tail = sim.snake().body().back();
+    CHECK(at(first, layout, ObservationPlane::Body, tail) > 0.f);
+    CHECK(at(first, layout, ObservationPlane::Body, tail) < 1.f);
+    const auto body = first.subspan(layout.plane_offset(ObservationPlane::Body),
+                                    layout.plane_size());
+    CHECK(std::ranges::count_if(body, [](float v) { return v > 0.f; }) == 3);
+
+    // A 10-wide board in a 12-wide layout: the two extra columns read as walls
+    CHECK(at(first, layout, ObservationPlane::Wall, {9, 0}) == 0.f);
+    CHECK(at(first, layout, ObservationPlane::Wall, {10, 0}) == 1.f);
+    CHECK(at(first, layout, ObservationPlane::Wall, {11, 9}) == 1.f);
+
+    const auto scalars = first.subspan(layout.scalar_offset(), observation_scalar_count);
+    CHECK(scalars[static_cast<std::size_t>(sim.snake().direction())] == 1.f);
+    CHECK(std::ranges::count(scalars.first(4), 1.f) == 1);
+    CHECK(std::ranges::all_of(scalars, [](float v) { return v >= 0.f && v <= 1.f; }));
+
+    // Every value of the second observation was written
+    const std::span<const float> second(out.data() + layout.stride(), layout.stride());
+    CHECK(std::ranges::none_of(second, [](float v) { return v < 0.f; }));
+    const auto walls = second.subspan(layout.plane_offset(ObservationPlane::Wall),
+                                      layout.plane_size());
+    CHECK(std::ranges::all_of(walls, [](float v) { return v == 0.f; }));
+}
+
+TEST_CASE("uint8 observations match the float encoding", "[observation]") {
+    const ObservationLayout layout;
+    std::vector<Simulation> games;
+    for (std::uint64_t seed = 1; seed <= 4; ++seed) {
+        Simulation sim(layout.width, layout.height, Config::initial_tick, seed);
+        for (int i = 0; i < 5; ++i) sim.step();
+        games.push_back(sim);
+    }
+    std::vector<float> floats(games.size() * layout.stride());
+    std::vector<std::uint8_t> bytes(games.size() * layout.stride());
+    encode_observations(games, layout, floats);
+    encode_observations(games, layout, bytes);
+
+    for (std::size_t i = 0; i < floats.size(); ++i) {
+        CHECK((floats[i] == 0.f) == (bytes[i] == 0));
+        CHECK(std::abs(floats[i] * 255.f - static_cast<float>(bytes[i])) < 1.f);
+    }
+}
@@ -0,0 +1,47 @@
+#include "../src/Occupancy.hpp"
+#include "../src/Snake.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("Occupancy dispatches preset sizes to fixed instantiations", "[occupancy]") {
+    CHECK(std::holds_alternative<Occupancy<15, 15>>(make_occupancy(15, 15)));
+    CHECK(std::holds_alternative<Occupancy<30, 30>>(make_occupancy(30, 30)));
+    CHECK(std::holds_alternative<DynamicOccupancy>(make_occupancy(17, 17)));
+    CHECK(std::holds_alternative<DynamicOccupancy>(make_occupancy(15, 25)));
+    static_assert(sizeof(Occupancy<30, 30>) == 15 * sizeof(std::uint64_t));
+}
+
+TEST_CASE("Occupancy nth_free skips occupied and excluded cells", "[occupancy]") {
+    Occupancy<15, 15> fixed;
+    DynamicOccupancy dynamic(15, 15);
+    for (auto p : {sf::Vector2i{0, 0}, sf::Vector2i{1, 0}, sf::Vector2i{14, 14}}) {
+        fixed.set(p);
+        dynamic.set(p);
+    }
+    CHECK(fixed.count() == 3);
+
+    CHECK(fixed.nth_free(0, std::nullopt) == sf::Vector2i{2, 0});
+    CHECK(fixed.nth_free(0, sf::Vector2i{2, 0}) == sf::Vector2i{3, 0});
+    CHECK(fixed.nth_free(221, std::nullopt) == sf::Vector2i{13, 14});
+    CHECK_FALSE(fixed.nth_free(222, std::nullopt).has_value());
+
+    for (int n = 0; n < 222; n += 17) {
+        CHECK(fixed.nth_free(n, sf::Vector2i{5, 5}) == dynamic.nth_free(n, sf::Vector2i{5, 5}));
+    }
+}
+
+TEST_CASE("Snake occupancy follows the body", "[occupancy]") {
+    Snake snake;
+    snake.reset(20, 20);
+    snake.grow();
+    snake.update();
+    snake.set_direction(Direction::Up);
+    snake.update();
+
+    const int bits = std::visit([](const auto& occ) { return occ.count(); }, snake.occupancy());
+    CHECK(bits == static_cast<int>(snake.body().size()));
+    for (const auto& cell : snake.body()) {
+        CHECK(snake.occupies(cell));
+    }
+    CHECK_FALSE(snake.occupies({12, 10})); // vacated tail
+}
@@ -0,0 +1,45 @@
+#include "../src/Particles.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+
+TEST_CASE("ParticleSystem bursts up to its capacity", "[particles]") {
+    ParticleSystem particles(100, 1);
+    CHECK(particles.burst({10.f, 20.f}, 60, sf::Color::Red, 100.f, 1.f) == 60);
+    CHECK(particles.burst({10.f, 20.f}, 60, sf::Color::Red, 100.f, 1.f) == 40);
+    CHECK(particles.size() == 100);
+    CHECK(particles.burst({10.f, 20.f}, 1, sf::Color::Red, 100.f, 1.f) == 0);
+
+    CHECK(particles.x()[0] == 10.f);
+    CHECK(particles.y()[0] == 20.f);
+    CHECK(particles.fade(0) > 0.999f);
+
+    particles.clear();
+    CHECK(particles.size() == 0);
+    CHECK(particles.capacity() == 100);
+}
+
+TEST_CASE("ParticleSystem moves particles and removes expired ones", "[particles]") {
+    ParticleSystem particles(1000, 2);
+    particles.burst({0.f, 0.f}, 500, sf::Color::Red, 100.f, 0.2f);
+    particles.burst({0.f, 0.f}, 500, sf::Color::Blue, 100.f, 10.f);
+
+    particles.update(0.05f);
+    CHECK(particles.size() == 1000);
+    CHECK(std::ranges::any_of(particles.x(), [](float x) { return x != 0.f; }));
+    for (std::size_t i = 0; i < particles.size(); ++i) {
+        CHECK(particles.fade(i) > 0.f);
+        CHECK(particles.fade(i) < 1.f);
+    }
+
+    // Lifetimes are jittered to at most the requested one, so every short-lived particle is gone
+    // and compaction kept exactly the long-lived ones
+    particles.update(0.2f);
+    REQUIRE(particles.size() == 500);
+    CHECK(std::ranges::all_of(particles.colors(),
+                              [](sf::Color c) { return c == sf::Color::Blue; }));
+
+    particles.update(20.f);
+    CHECK(particles.size() == 0);
+}
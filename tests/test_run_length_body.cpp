@@ -0,0 +1,55 @@
+#include "../src/RunLengthBody.hpp"
+#include "../src/Snake.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+TEST_CASE("RunLengthBody stores one run per straight stretch", "[body]") {
+    RunLengthBody body;
+    body.push_back({5, 5});
+    for (int x = 6; x < 100'005; ++x) {
+        body.push_back({x, 5});
+    }
+    CHECK(body.size() == 100'000);
+    CHECK(body.runs().size() == 1);
+    CHECK(body.front() == sf::Vector2i{5, 5});
+    CHECK(body.back() == sf::Vector2i{100'004, 5});
+
+    body.push_front({5, 4}, Direction::Up);
+    body.push_front({5, 3}, Direction::Up);
+    body.push_front({6, 3}, Direction::Right);
+    CHECK(body.runs().size() == 3);
+    CHECK(body.size() == 100'003);
+}
+
+TEST_CASE("RunLengthBody iterates cells head to tail", "[body]") {
+    RunLengthBody body;
+    const std::vector<sf::Vector2i> cells = {{3, 1}, {2, 1}, {2, 2}, {2, 3}, {3, 3}};
+    for (const auto c : cells) {
+        body.push_back(c);
+    }
+    CHECK(body.runs().size() == 3);
+    CHECK(std::vector<sf::Vector2i>(body.begin(), body.end()) == cells);
+
+    body.pop_back();
+    body.pop_front();
+    CHECK(std::vector<sf::Vector2i>(body.begin(), body.end()) ==
+          std::vector<sf::Vector2i>{{2, 1}, {2, 2}, {2, 3}});
+}
+
+TEST_CASE("Snake body runs track turns, not length", "[body]") {
+    Snake snake;
+    snake.reset(30, 30);
+    for (int i = 0; i < 10; ++i) {
+        snake.grow();
+        snake.update();
+    }
+    CHECK(snake.body().size() == 13);
+    CHECK(snake.body().runs().size() == 1);
+
+    snake.set_direction(Direction::Up);
+    snake.update();
+    CHECK(snake.body().runs().size() == 2);
+    CHECK(snake.prev_tail() != snake.body().back());
+}
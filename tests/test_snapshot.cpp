@@ -0,0 +1,102 @@
+#include "../src/Simulation.hpp"
+#include "../src/Snapshot.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+// Steers in a square so the snake survives long enough to eat and turn
+void play(Simulation& sim, int ticks) {
+    constexpr Direction pattern[] = {Direction::Up, Direction::Right, Direction::Down,
+                                     Direction::Left};
+    for (int i = 0; i < ticks && !sim.is_over(); ++i) {
+        sim.set_direction(pattern[(sim.tick() / 4) % 4]);
+        sim.step();
+    }
+}
+
+bool same_bytes(const Snapshot& a, const Snapshot& b) {
+    return std::memcmp(&a, &b, sizeof(Snapshot)) == 0;
+}
+
+} // namespace
+
+TEST_CASE("Snapshot restore reproduces the simulation", "[snapshot]") {
+    Simulation sim(20, 20, std::chrono::milliseconds{150}, 42);
+    play(sim, 10);
+
+    Snapshot saved;
+    sim.snapshot(saved);
+
+    Simulation copy(20, 20, std::chrono::milliseconds{150}, 7);
+    copy.restore(saved);
+    CHECK(copy.snake().body() == sim.snake().body());
+    CHECK(copy.board().food_position() == sim.board().food_position());
+    CHECK(copy.score() == sim.score());
+    CHECK(copy.tick() == sim.tick());
+
+    // Same state and RNG, so both continue identically
+    play(sim, 40);
+    play(copy, 40);
+    Snapshot a;
+    Snapshot b;
+    sim.snapshot(a);
+    copy.snapshot(b);
+    CHECK(same_bytes(a, b));
+}
+
+TEST_CASE("RewindBuffer pops snapshots newest first", "[snapshot]") {
+    Simulation sim(20, 20, std::chrono::milliseconds{150}, 3);
+    RewindBuffer rewind(100, 64 * 1024);
+
+    std::vector<Snapshot> history;
+    for (int i = 0; i < 12 && !sim.is_over(); ++i) {
+        Snapshot s;
+        sim.snapshot(s);
+        history.push_back(s);
+        rewind.push(s);
+        play(sim, 1);
+    }
+    CHECK(rewind.frames() == history.size());
+
+    Snapshot out;
+    while (!history.empty()) {
+        REQUIRE(rewind.pop(out));
+        CHECK(same_bytes(out, history.back()));
+        history.pop_back();
+    }
+    CHECK_FALSE(rewind.pop(out));
+}
+
+TEST_CASE("RewindBuffer drops the oldest frames when full", "[snapshot]") {
+    Simulation sim(20, 20, std::chrono::milliseconds{150}, 5);
+    RewindBuffer rewind(4, 64 * 1024);
+
+    Snapshot s;
+    for (int i = 0; i < 10; ++i) {
+        sim.snapshot(s);
+        rewind.push(s);
+        play(sim, 1);
+    }
+    CHECK(rewind.frames() == 4);
+}
+
+TEST_CASE("RewindBuffer keeps 30 seconds of a 30x30 game under a megabyte", "[snapshot]") {
+    constexpr std::size_t frames = 30 * 1000 / 60;
+    Simulation sim(30, 30, std::chrono::milliseconds{60}, 11);
+    RewindBuffer rewind(frames, 512 * 1024);
+
+    Snapshot s;
+    std::size_t pushed = 0;
+    for (; pushed < frames * 2 && !sim.is_over(); ++pushed) {
+        sim.snapshot(s);
+        rewind.push(s);
+        play(sim, 1);
+    }
+    CHECK(rewind.frames() == std::min(frames, pushed));
+    CHECK(rewind.bytes_used() < 64 * 1024);
+    CHECK(rewind.memory_footprint() < 1024 * 1024);
+}
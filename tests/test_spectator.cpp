@@ -0,0 +1,124 @@
+#include "../src/Spectator.hpp"
+
+#include "../src/Config.hpp"
+#include "../src/Policy.hpp"
+#include "../src/Rng.hpp"
+#include "../src/Simulation.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+namespace {
+
+// Unique per test process, so parallel test runs do not share a feed
+std::string feed_name(const char* test) {
+    return "/snake-test-" + std::to_string(::getpid()) + "-" + test;
+}
+
+} // namespace
+
+TEST_CASE("SpectatorReader receives every published state in order", "[spectator]") {
+    CHECK_FALSE(SpectatorReader::open(feed_name("missing")).has_value());
+
+    auto feed = SpectatorFeed::create(feed_name("order"));
+    REQUIRE(feed.has_value());
+    auto reader = SpectatorReader::open(feed_name("order"));
+    REQUIRE(reader.has_value());
+
+    Simulation sim(20, 20, Config::initial_tick, 3);
+    Rng rng(3);
+    Snapshot state;
+    CHECK_FALSE(reader->next(state));
+    for (int tick = 0; tick < 200 && !sim.is_over(); ++tick) {
+        sim.set_direction(heuristic_move(sim, rng));
+        sim.step();
+        Snapshot published;
+        sim.snapshot(published);
+        feed->publish(published);
+
+        // Only the header and the live body slice travel, which is all restore() reads
+        REQUIRE(reader->next(state));
+        Simulation copy(20, 20, Config::initial_tick, 0);
+        copy.restore(state);
+        REQUIRE(copy.hash() == sim.hash());
+        CHECK_FALSE(reader->next(state));
+    }
+    CHECK(reader->missed() == 0);
+}
+
+TEST_CASE("SpectatorReader skips what the ring no longer holds", "[spectator]") {
+    auto feed = SpectatorFeed::create(feed_name("skip"));
+    REQUIRE(feed.has_value());
+    auto reader = SpectatorReader::open(feed_name("skip"));
+    REQUIRE(reader.has_value());
+
+    Snapshot state{};
+    constexpr std::uint32_t total = SpectatorFeed::slot_count + 10;
+    for (std::uint32_t tick = 1; tick <= total; ++tick) {
+        state.tick = tick;
+        feed->publish(state);
+    }
+    REQUIRE(reader->next(state));
+    CHECK(state.tick == 11);
+    CHECK(reader->missed() == 10);
+
+    REQUIRE(reader->latest(state));
+    CHECK(state.tick == total);
+    CHECK_FALSE(reader->next(state));
+
+    // A reader opened late starts at the oldest state still held
+    auto late = SpectatorReader::open(feed_name("skip"));
+    REQUIRE(late.has_value());
+    REQUIRE(late->next(state));
+    CHECK(state.tick == 11);
+    CHECK(late->missed() == 0);
+}
+
+TEST_CASE("SpectatorReader never returns a torn state", "[spectator]") {
+    auto feed = SpectatorFeed::create(feed_name("torn"));
+    REQUIRE(feed.has_value());
+    auto reader = SpectatorReader::open(feed_name("torn"));
+    REQUIRE(reader.has_value());
+
+    // Every cell of state t holds t, and the body slice moves around the ring, wrapping
+    constexpr std::uint32_t total = 100'000;
+    std::atomic<bool> done{false};
+    std::jthread writer([&] {
+        Snapshot state{};
+        state.body_length = 300;
+        for (std::uint32_t tick = 1; tick <= total; ++tick) {
+            const auto value = static_cast<std::int8_t>(tick % 100);
+            state.tick = tick;
+            state.body_start = static_cast<std::uint16_t>(tick * 7 % Snapshot::max_cells);
+            for (Snapshot::Cell& cell : state.cells) cell = {value, value};
+            feed->publish(state);
+        }
+        done = true;
+    });
+
+    std::uint32_t last = 0;
+    std::uint64_t reads = 0;
+    bool consistent = true;
+    Snapshot state;
+    while (!done || reader->published() > last) {
+        if (!reader->next(state)) continue;
+        ++reads;
+        const auto value = static_cast<std::int8_t>(state.tick % 100);
+        consistent = consistent && state.tick > last && state.body_length == 300;
+        for (std::uint16_t i = 0; i < state.body_length && consistent; ++i) {
+            const auto& cell = state.cells[(state.body_start + i) % Snapshot::max_cells];
+            consistent = cell.x == value && cell.y == value;
+        }
+        last = state.tick;
+        if (last == total) break;
+    }
+    CHECK(consistent);
+    CHECK(last == total);
+    CHECK(reads + reader->missed() == total);
+}
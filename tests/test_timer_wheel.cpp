@@ -0,0 +1,106 @@
+#include "../src/TimerWheel.hpp"
+
+#include "../src/Config.hpp"
+#include "../src/Policy.hpp"
+#include "../src/Rng.hpp"
+#include "../src/Simulation.hpp"
+#include "../src/Snapshot.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+TEST_CASE("TimerWheel fires every timer on its deadline, in order", "[timer]") {
+    TimerWheel<std::uint32_t> wheel;
+    Rng rng(11);
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> expected;
+    // Delays spanning every level, plus one past the top level into the overflow list
+    for (std::uint32_t id = 0; id < 2000; ++id) {
+        const std::uint64_t delay = 1 + rng.below(1U << (6 * (1 + id % 4)));
+        expected.emplace_back(delay, id);
+        wheel.schedule(delay, id);
+    }
+    const std::uint64_t far = (std::uint64_t{1} << 24) + 70;
+    expected.emplace_back(far, 2000);
+    wheel.schedule(far, 2000);
+    std::ranges::stable_sort(expected, {}, &std::pair<std::uint64_t, std::uint32_t>::first);
+
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> fired;
+    // Uneven steps, as a frame clock would advance
+    while (wheel.size() > 0) {
+        wheel.advance(wheel.now() + 1 + rng.below(300),
+                      [&](std::uint32_t id) { fired.emplace_back(wheel.now(), id); });
+    }
+    CHECK(fired == expected);
+}
+
+TEST_CASE("TimerWheel cancels timers and rejects stale handles", "[timer]") {
+    TimerWheel<int> wheel(100);
+    const auto a = wheel.schedule(5, 1);
+    const auto b = wheel.schedule(5, 2);
+    const auto c = wheel.schedule(0, 3); // runs on the next tick
+    CHECK(wheel.deadline(a) == 105);
+    CHECK(wheel.deadline(c) == 101);
+
+    CHECK(wheel.cancel(a));
+    CHECK_FALSE(wheel.cancel(a));
+    CHECK_FALSE(wheel.pending(a));
+
+    std::vector<int> fired;
+    wheel.advance(110, [&](int id) { fired.push_back(id); });
+    CHECK(fired == std::vector<int>{3, 2});
+    CHECK_FALSE(wheel.pending(b));
+    CHECK(wheel.size() == 0);
+
+    // Fired and cancelled timers' nodes are reused without reviving their old handles
+    const auto d = wheel.schedule(1, 4);
+    CHECK_FALSE(wheel.cancel(a));
+    CHECK_FALSE(wheel.cancel(b));
+    CHECK_FALSE(wheel.cancel(c));
+    CHECK(wheel.pending(d));
+}
+
+TEST_CASE("Simulation expires the bonus on its tick wheel", "[timer]") {
+    bool expired = false;
+    for (std::uint64_t seed = 1; seed < 50 && !expired; ++seed) {
+        Simulation sim(20, 20, Config::initial_tick, seed);
+        Rng rng(seed);
+        TickEvents events;
+        float interval = 0.f; // of the tick the bonus appeared on, before eating sped it up
+        while (!sim.is_over() && !events.bonus_spawned) {
+            interval = std::chrono::duration<float>(sim.tick_interval()).count();
+            sim.set_direction(heuristic_move(sim, rng));
+            events = sim.step();
+        }
+        if (!sim.board().bonus_position()) continue;
+
+        const std::uint32_t spawned = sim.tick();
+        const auto lifetime = static_cast<std::uint32_t>(Config::bonus_duration / interval);
+        CHECK(sim.bonus_time_remaining() > 0.f);
+
+        Snapshot saved;
+        sim.snapshot(saved);
+        Simulation copy(20, 20, Config::initial_tick, 0);
+        copy.restore(saved);
+
+        // Steer both the same way until the bonus goes, by expiry or by being eaten
+        bool eaten = false;
+        while (!sim.is_over() && sim.board().bonus_position()) {
+            const Direction dir = heuristic_move(sim, rng);
+            sim.set_direction(dir);
+            copy.set_direction(dir);
+            eaten = sim.step().ate_bonus;
+            copy.step();
+            REQUIRE(copy.hash() == sim.hash());
+        }
+        if (sim.is_over() || eaten) continue;
+        CHECK(sim.tick() == spawned + lifetime);
+        CHECK(sim.bonus_time_remaining() == 0.f);
+        expired = true;
+    }
+    CHECK(expired);
+}
@@ -0,0 +1,59 @@
+#include "../src/Trace.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+} // namespace
+
+TEST_CASE("Trace writes zones from every thread as Chrome trace events", "[trace]") {
+    const std::string path = "test_trace.json";
+
+    {
+        const TraceZone zone("test_main_zone");
+    }
+    std::thread([] {
+        Trace::set_thread_name("test_worker");
+        const TraceZone zone("test_worker_zone");
+    }).join();
+
+    REQUIRE(Trace::flush(path));
+    const std::string json = read_file(path);
+    std::remove(path.c_str());
+
+    CHECK(json.starts_with("{\"displayTimeUnit\""));
+    CHECK(json.contains(R"("name":"test_main_zone","ph":"X")"));
+    CHECK(json.contains(R"("name":"test_worker_zone","ph":"X")"));
+    CHECK(json.contains(R"("args":{"name":"test_worker"})"));
+}
+
+TEST_CASE("Trace keeps only the newest events once a thread's ring wraps", "[trace]") {
+    const std::string path = "test_trace_wrap.json";
+
+    std::thread([] {
+        for (int i = 0; i < 100000; ++i) {
+            Trace::record(i < 50000 ? "test_old_zone" : "test_new_zone", Trace::now(),
+                          Trace::now());
+        }
+    }).join();
+
+    REQUIRE(Trace::flush(path));
+    const std::string json = read_file(path);
+    std::remove(path.c_str());
+
+    CHECK(json.contains("test_new_zone"));
+    CHECK_FALSE(json.contains("test_old_zone"));
+}
@@ -0,0 +1,224 @@
+// Plays many headless games with the rollout policy on every core and writes where the snake
+// went, died and found food, e.g. to spot unfair food spawns or deadly corners in a level.
+//
+//   snake_batch [--games N] [--jobs N] [--grid N | --level NAME] [--levels PACK] [--seed N]
+//               [--out PREFIX] [--dataset PATH]
+//
+// Writes PREFIX.csv with every counter per cell and PREFIX-<counter>.pgm images, and with
+// --dataset every step of every game as training data (see src/Dataset.hpp).
+
+#include "../src/Config.hpp"
+#include "../src/Dataset.hpp"
+#include "../src/FileIO.hpp"
+#include "../src/Heatmap.hpp"
+#include "../src/Level.hpp"
+#include "../src/Policy.hpp"
+#include "../src/Rng.hpp"
+#include "../src/Simulation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Games stuck in a safe loop without food are cut off here
+constexpr std::uint32_t max_ticks = 20'000;
+// Games are claimed in chunks so the shared counter is touched rarely
+constexpr std::uint64_t chunk = 64;
+
+struct Options {
+    std::uint64_t games = 100'000;
+    unsigned jobs = std::max(1U, std::thread::hardware_concurrency());
+    int grid = Config::grid_width;
+    std::string level;
+    std::string levels = Config::level_pack_path;
+    std::uint64_t seed = 1;
+    std::string out = "heatmap";
+    std::string dataset; // empty: not recorded
+};
+
+struct Totals {
+    std::uint64_t games = 0;
+    std::uint64_t ticks = 0;
+    std::uint64_t score = 0;
+};
+
+void usage(const char* argv0) {
+    std::println(stderr,
+                 "usage: {} [--games N] [--jobs N] [--grid N | --level NAME] [--levels PACK] "
+                 "[--seed N] [--out PREFIX] [--dataset PATH]",
+                 argv0);
+}
+
+std::optional<Options> parse_args(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (i + 1 >= argc) return std::nullopt;
+        const char* value = argv[++i];
+        if (arg == "--games") {
+            options.games = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--jobs") {
+            options.jobs = static_cast<unsigned>(std::max(1, std::atoi(value)));
+        } else if (arg == "--grid") {
+            options.grid = std::atoi(value);
+        } else if (arg == "--level") {
+            options.level = value;
+        } else if (arg == "--levels") {
+            options.levels = value;
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--out") {
+            options.out = value;
+        } else if (arg == "--dataset") {
+            options.dataset = value;
+        } else {
+            return std::nullopt;
+        }
+    }
+    if (options.games == 0 || options.grid < 5 || options.grid > Config::max_grid_size) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+Simulation new_game(const Options& options, const Level* level, std::uint64_t seed) {
+    if (level) return Simulation(*level, Config::initial_tick, seed);
+    return Simulation(options.grid, options.grid, Config::initial_tick, seed);
+}
+
+// Plays games until the shared counter runs out, recording into this worker's own heatmap and,
+// if given, dataset buffer
+Totals play(const Options& options, const Level* level, std::atomic<std::uint64_t>& next,
+            Heatmap& heatmap, DatasetBuffer* dataset) {
+    Totals totals;
+    for (std::uint64_t begin = next.fetch_add(chunk); begin < options.games;
+         begin = next.fetch_add(chunk)) {
+        const std::uint64_t end = std::min(begin + chunk, options.games);
+        for (std::uint64_t game = begin; game < end; ++game) {
+            // Seeded by game number, so a run is reproducible whatever the thread count
+            const std::uint64_t seed = options.seed + game;
+            Simulation sim = new_game(options, level, seed);
+            Rng rng(seed);
+            heatmap.record_start(sim);
+            while (!sim.is_over() && sim.tick() < max_ticks) {
+                const Direction move = heuristic_move(sim, rng);
+                if (dataset) dataset->begin_step(sim, move);
+                sim.set_direction(move);
+                const TickEvents events = sim.step();
+                heatmap.record(sim, events);
+                if (dataset) dataset->end_step(sim, events);
+            }
+            ++totals.games;
+            totals.ticks += sim.tick();
+            totals.score += static_cast<std::uint64_t>(sim.score());
+        }
+    }
+    return totals;
+}
+
+bool write(const std::string& path, std::span<const std::uint8_t> contents) {
+    if (write_file_atomically(path, contents)) return true;
+    std::println(stderr, "Cannot write {}", path);
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto options = parse_args(argc, argv);
+    if (!options) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::optional<LevelPack> pack;
+    const Level* level = nullptr;
+    if (!options->level.empty()) {
+        auto opened = LevelPack::open(options->levels);
+        if (!opened) {
+            std::println(stderr, "{}", opened.error());
+            return 1;
+        }
+        pack = std::move(*opened);
+        const auto index = pack->find(options->level);
+        if (!index) {
+            std::println(stderr, "Level '{}' is not in {}", options->level, options->levels);
+            return 1;
+        }
+        level = &pack->level(*index);
+    }
+    const int width = level ? level->width : options->grid;
+    const int height = level ? level->height : options->grid;
+
+    const auto jobs = static_cast<unsigned>(
+        std::min<std::uint64_t>(options->jobs, (options->games + chunk - 1) / chunk));
+    std::vector<Heatmap> heatmaps(jobs, Heatmap(width, height));
+    std::vector<Totals> totals(jobs);
+    std::optional<DatasetWriter> dataset;
+    if (!options->dataset.empty()) {
+        auto writer = DatasetWriter::create(options->dataset, options->level);
+        if (!writer) {
+            std::println(stderr, "{}", writer.error());
+            return 1;
+        }
+        dataset = std::move(*writer);
+    }
+
+    std::atomic<std::uint64_t> next{0};
+    const auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> workers;
+        for (unsigned j = 0; j < jobs; ++j) {
+            workers.emplace_back([&, j] {
+                std::optional<DatasetBuffer> buffer;
+                if (dataset) buffer = dataset->buffer();
+                totals[j] = play(*options, level, next, heatmaps[j], buffer ? &*buffer : nullptr);
+            });
+        }
+    }
+    if (dataset) dataset->flush();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    Heatmap merged(width, height);
+    Totals sum;
+    for (unsigned j = 0; j < jobs; ++j) {
+        merged.merge(heatmaps[j]);
+        sum.games += totals[j].games;
+        sum.ticks += totals[j].ticks;
+        sum.score += totals[j].score;
+    }
+
+    const double seconds = std::max(elapsed.count(), 1e-9);
+    std::println("Played {} games ({} ticks) in {:.3f} s on {} threads: {:.0f} games/s, "
+                 "{:.2f} M ticks/s, average score {:.2f}",
+                 sum.games, sum.ticks, seconds, jobs, static_cast<double>(sum.games) / seconds,
+                 static_cast<double>(sum.ticks) / seconds / 1e6,
+                 static_cast<double>(sum.score) / static_cast<double>(sum.games));
+    if (dataset) {
+        std::println("Recorded {} steps in {} ({:.1f} bytes per step)", dataset->steps_written(),
+                     options->dataset,
+                     static_cast<double>(dataset->bytes_written()) /
+                         static_cast<double>(std::max<std::uint64_t>(dataset->steps_written(), 1)));
+    }
+
+    const std::string csv = merged.to_csv();
+    bool ok = write(options->out + ".csv",
+                    {reinterpret_cast<const std::uint8_t*>(csv.data()), csv.size()});
+    for (const HeatCounter counter : {HeatCounter::Visits, HeatCounter::Deaths,
+                                      HeatCounter::Food, HeatCounter::Bonus}) {
+        const std::string path = options->out + "-" + Heatmap::name(counter) + ".pgm";
+        if (!write(path, merged.to_pgm(counter))) ok = false;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+// Packs text level layouts (see parse_level in src/Level.hpp) into the memory-mapped format the
+// game loads. Each level is named after its file, without the extension.
+//
+//   snake_levelpack out.pack levels/Box.txt levels/Cross.txt ...
+
+#include "../src/FileIO.hpp"
+#include "../src/Level.hpp"
+
+#include <filesystem>
+#include <print>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::println(stderr, "usage: {} out.pack level.txt...", argv[0]);
+        return 2;
+    }
+
+    std::vector<LevelSpec> levels;
+    for (int i = 2; i < argc; ++i) {
+        const std::filesystem::path path = argv[i];
+        const auto text = read_file(path.string());
+        if (!text) {
+            std::println(stderr, "Cannot read {}", path.string());
+            return 1;
+        }
+        auto level = parse_level(path.stem().string(),
+                                 {reinterpret_cast<const char*>(text->data()), text->size()});
+        if (!level) {
+            std::println(stderr, "{}", level.error());
+            return 1;
+        }
+        levels.push_back(std::move(*level));
+    }
+
+    if (!write_file_atomically(argv[1], LevelPack::build(levels))) {
+        std::println(stderr, "Cannot write {}", argv[1]);
+        return 1;
+    }
+    std::println("Packed {} levels into {}", levels.size(), argv[1]);
+    return 0;
+}
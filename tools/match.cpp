@@ -0,0 +1,119 @@
+// Benchmarks an external engine (see src/Engine.hpp) headless: plays games back to back as fast
+// as the engine answers, each move allowed the budget it would get in the game unless
+// --budget-us says otherwise, and reports throughput, scores and reply latency.
+//
+//   snake_match --engine CMD [--games N] [--grid N] [--seed N] [--budget-us N]
+//
+// A move that misses its budget is skipped and the snake keeps its heading, as in the game.
+
+#include "../src/Config.hpp"
+#include "../src/Engine.hpp"
+#include "../src/Simulation.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+
+namespace {
+
+// Games stuck in a safe loop without food are cut off here
+constexpr std::uint32_t max_ticks = 20'000;
+
+struct Options {
+    std::string engine;
+    std::uint64_t games = 100;
+    int grid = Config::grid_width;
+    std::uint64_t seed = 1;
+    std::optional<std::chrono::microseconds> budget; // default: the game's, from tick_interval
+};
+
+void usage(const char* argv0) {
+    std::println(stderr,
+                 "usage: {} --engine CMD [--games N] [--grid N] [--seed N] [--budget-us N]",
+                 argv0);
+}
+
+std::optional<Options> parse_args(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (i + 1 >= argc) return std::nullopt;
+        const char* value = argv[++i];
+        if (arg == "--engine") {
+            options.engine = value;
+        } else if (arg == "--games") {
+            options.games = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--grid") {
+            options.grid = std::atoi(value);
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--budget-us") {
+            options.budget = std::chrono::microseconds{std::strtoll(value, nullptr, 10)};
+        } else {
+            return std::nullopt;
+        }
+    }
+    if (options.engine.empty() || options.games == 0 || options.grid < 5 ||
+        options.grid > Config::max_grid_size || (options.budget && options.budget->count() <= 0)) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+std::chrono::microseconds game_budget(const Simulation& sim) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::duration<float, std::micro>(sim.tick_interval()) *
+        Config::mcts_think_fraction);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto options = parse_args(argc, argv);
+    if (!options) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    auto engine = Engine::start(options->engine, Config::engine_handshake_timeout);
+    if (!engine) {
+        std::println(stderr, "{}", engine.error());
+        return 1;
+    }
+
+    std::uint64_t ticks = 0;
+    std::uint64_t score = 0;
+    int best = 0;
+    std::uint64_t played = 0;
+    const auto start = Engine::Clock::now();
+    for (; played < options->games && engine->alive(); ++played) {
+        Simulation sim(options->grid, options->grid, Config::initial_tick, options->seed + played);
+        while (!sim.is_over() && sim.tick() < max_ticks) {
+            const auto budget = options->budget.value_or(game_budget(sim));
+            if (!engine->request(sim, budget)) break;
+            if (const auto move = engine->wait(Engine::Clock::now() + budget)) {
+                sim.set_direction(*move);
+            }
+            sim.step();
+        }
+        ticks += sim.tick();
+        score += static_cast<std::uint64_t>(sim.score());
+        best = std::max(best, sim.score());
+    }
+    const std::chrono::duration<double> elapsed = Engine::Clock::now() - start;
+
+    if (!engine->alive()) std::println(stderr, "Engine {} exited early", engine->name());
+    const double seconds = std::max(elapsed.count(), 1e-9);
+    std::println("Engine {}: {} games ({} moves) in {:.3f} s: {:.0f} moves/s, average score "
+                 "{:.2f}, best {}",
+                 engine->name(), played, ticks, seconds, static_cast<double>(ticks) / seconds,
+                 played == 0 ? 0.0 : static_cast<double>(score) / static_cast<double>(played),
+                 best);
+    std::println("{}", engine->stats().summary());
+    return engine->alive() ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+// Minimal external engine for snake --engine and snake_match, speaking the line protocol in
+// src/Engine.hpp: heads for the food by the safe move that shortens the distance most. Uses
+// nothing from the game, as an engine in another language would.
+//
+//   snake --engine ./snake_sample_engine
+//   snake_match --engine ./snake_sample_engine
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <print>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Cell {
+    int x = 0;
+    int y = 0;
+};
+
+struct Move {
+    char name;
+    int dx;
+    int dy;
+};
+
+constexpr std::array<Move, 4> moves = {{{'U', 0, -1}, {'D', 0, 1}, {'L', -1, 0}, {'R', 1, 0}}};
+
+struct Portal {
+    Cell a;
+    Cell b;
+};
+
+// What the last level line described; an open board until one arrives
+struct Level {
+    int width = 0;
+    int height = 0;
+    std::vector<bool> walls;
+    std::vector<Portal> portals;
+
+    void read(std::istringstream& in) {
+        int wall_count = 0;
+        in >> width >> height >> wall_count;
+        walls.assign(static_cast<std::size_t>(width * height), false);
+        for (int i = 0; i < wall_count; ++i) {
+            std::size_t index = 0;
+            in >> index;
+            if (index < walls.size()) walls[index] = true;
+        }
+        int portal_count = 0;
+        in >> portal_count;
+        portals.resize(static_cast<std::size_t>(portal_count));
+        for (Portal& p : portals) in >> p.a.x >> p.a.y >> p.b.x >> p.b.y;
+    }
+
+    [[nodiscard]] Cell exit(Cell c) const {
+        for (const Portal& p : portals) {
+            if (c.x == p.a.x && c.y == p.a.y) return p.b;
+            if (c.x == p.b.x && c.y == p.b.y) return p.a;
+        }
+        return c;
+    }
+
+    [[nodiscard]] bool blocked(Cell c) const {
+        if (c.x < 0 || c.x >= width || c.y < 0 || c.y >= height) return true;
+        return !walls.empty() && walls[static_cast<std::size_t>(c.y * width + c.x)];
+    }
+};
+
+char choose(const Level& level, std::istringstream& in) {
+    std::uint64_t budget_us = 0;
+    int tick = 0;
+    int score = 0;
+    char heading = 'L';
+    Cell food;
+    Cell bonus;
+    int length = 0;
+    in >> budget_us >> tick >> score >> heading >> food.x >> food.y >> bonus.x >> bonus.y >>
+        length;
+    std::vector<Cell> body(static_cast<std::size_t>(length));
+    for (Cell& c : body) in >> c.x >> c.y;
+    if (body.empty()) return heading;
+
+    const Cell head = body.front();
+    char best = heading;
+    int best_distance = std::numeric_limits<int>::max();
+    for (const Move& move : moves) {
+        Cell next = level.exit({head.x + move.dx, head.y + move.dy});
+        if (level.blocked(next)) continue;
+        // The tail moves away this tick, so only the rest of the body is in the way
+        bool hits_body = false;
+        for (std::size_t i = 0; i + 1 < body.size() && !hits_body; ++i) {
+            hits_body = body[i].x == next.x && body[i].y == next.y;
+        }
+        if (hits_body) continue;
+        const int distance = std::abs(food.x - next.x) + std::abs(food.y - next.y);
+        if (distance < best_distance) {
+            best_distance = distance;
+            best = move.name;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    std::ios::sync_with_stdio(false);
+    Level level;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream in(line);
+        std::string kind;
+        in >> kind;
+        if (kind == "snake") {
+            std::println("ready sample");
+        } else if (kind == "level") {
+            level.read(in);
+            continue;
+        } else if (kind == "state") {
+            std::uint64_t id = 0;
+            in >> id;
+            std::println("move {} {}", id, choose(level, in));
+        } else if (kind == "quit") {
+            break;
+        } else {
+            continue;
+        }
+        std::fflush(stdout);
+    }
+}
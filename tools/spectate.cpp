@@ -0,0 +1,108 @@
+// Sample reader of the game's shared-memory feed (snake --spectate). Draws the newest state as
+// text, or with --log prints one line per tick, reading every state in order.
+//
+//   snake_spectate [--name NAME] [--log]
+//
+// Runs until interrupted; the game never waits on it, however slowly it reads.
+
+#include "../src/Config.hpp"
+#include "../src/Direction.hpp"
+#include "../src/Snapshot.hpp"
+#include "../src/Spectator.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <print>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+constexpr auto poll_interval = std::chrono::milliseconds{5};
+
+// Body cell i, counted from the head, of the ring slice the feed fills in
+Snapshot::Cell body_cell(const Snapshot& state, int i) {
+    return state.cells[(state.body_start + i) % Snapshot::max_cells];
+}
+
+const char* direction_name(std::uint8_t dir) {
+    switch (static_cast<Direction>(dir)) {
+    case Direction::Up: return "up";
+    case Direction::Down: return "down";
+    case Direction::Left: return "left";
+    case Direction::Right: return "right";
+    }
+    return "?";
+}
+
+void draw_board(const Snapshot& state, std::uint64_t missed) {
+    const int w = state.grid_w;
+    const int h = state.grid_h;
+    std::string grid(static_cast<std::size_t>(w * h), '.');
+    auto put = [&](Snapshot::Cell cell, char c) {
+        if (cell.x >= 0 && cell.x < w && cell.y >= 0 && cell.y < h) {
+            grid[static_cast<std::size_t>(cell.y * w + cell.x)] = c;
+        }
+    };
+    put(state.food, '*');
+    if ((state.flags & Snapshot::HasBonus) != 0) put(state.bonus, '$');
+    for (int i = state.body_length - 1; i >= 0; --i) put(body_cell(state, i), i == 0 ? '@' : 'o');
+
+    // Home the cursor and clear, then redraw in one write
+    std::string frame = "\x1b[H\x1b[2J";
+    frame += std::format("tick {}  score {}  length {}  missed {}{}\n", state.tick, state.score,
+                         state.body_length, missed,
+                         (state.flags & Snapshot::Over) != 0 ? "  GAME OVER" : "");
+    for (int y = 0; y < h; ++y) {
+        frame.append(grid, static_cast<std::size_t>(y * w), static_cast<std::size_t>(w));
+        frame += '\n';
+    }
+    std::print("{}", frame);
+    std::fflush(stdout);
+}
+
+void print_line(const Snapshot& state, std::uint64_t missed) {
+    const Snapshot::Cell head = body_cell(state, 0);
+    std::println("tick={} score={} length={} head={},{} dir={} missed={}{}", state.tick,
+                 state.score, state.body_length, head.x, head.y,
+                 direction_name(state.direction), missed,
+                 (state.flags & Snapshot::Over) != 0 ? " over" : "");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string name = Config::spectator_feed;
+    bool log_mode = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--name" && i + 1 < argc) {
+            name = argv[++i];
+        } else if (arg == "--log") {
+            log_mode = true;
+        } else {
+            std::println(stderr, "usage: {} [--name NAME] [--log]", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    auto reader = SpectatorReader::open(name);
+    if (!reader) {
+        std::println(stderr, "{} (is the game running with --spectate?)", reader.error());
+        return EXIT_FAILURE;
+    }
+
+    Snapshot state;
+    for (;;) {
+        if (log_mode) {
+            while (reader->next(state)) print_line(state, reader->missed());
+            std::fflush(stdout);
+        } else if (reader->latest(state)) {
+            draw_board(state, reader->missed());
+        }
+        std::this_thread::sleep_for(poll_interval);
+    }
+}
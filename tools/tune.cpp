@@ -0,0 +1,205 @@
+// Tunes the weights of the weighted autopilot (weighted_move in src/Policy.hpp) with separable
+// CMA-ES. Every candidate of every generation plays the same games, seeded --seed onwards, so
+// two candidates differ in score because of their weights rather than their food (common
+// random numbers). A generation's games are spread over every core.
+//
+//   snake_tune [--generations N] [--population N] [--games N] [--jobs N] [--grid N] [--seed N]
+//              [--sigma X] [--curve PATH]
+//
+// Prints a line per generation and the best weights found; --curve writes the convergence
+// curve as CSV, one row per generation with its best and average fitness and mean weights.
+
+#include "../src/CmaEs.hpp"
+#include "../src/Config.hpp"
+#include "../src/FileIO.hpp"
+#include "../src/Policy.hpp"
+#include "../src/Simulation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Games stuck in a safe loop are cut off once this many ticks pass without food, per cell
+constexpr std::uint32_t starve_ticks_per_cell = 2;
+
+struct Options {
+    std::uint32_t generations = 30;
+    std::size_t population = 0; // 0: SepCmaEs::default_population
+    std::uint64_t games = 64;
+    unsigned jobs = std::max(1U, std::thread::hardware_concurrency());
+    int grid = Config::grid_width;
+    std::uint64_t seed = 1;
+    double sigma = 0.5;
+    std::string curve; // empty: not written
+};
+
+void usage(const char* argv0) {
+    std::println(stderr,
+                 "usage: {} [--generations N] [--population N] [--games N] [--jobs N] "
+                 "[--grid N] [--seed N] [--sigma X] [--curve PATH]",
+                 argv0);
+}
+
+std::optional<Options> parse_args(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (i + 1 >= argc) return std::nullopt;
+        const char* value = argv[++i];
+        if (arg == "--generations") {
+            options.generations = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (arg == "--population") {
+            options.population = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--games") {
+            options.games = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--jobs") {
+            options.jobs = static_cast<unsigned>(std::max(1, std::atoi(value)));
+        } else if (arg == "--grid") {
+            options.grid = std::atoi(value);
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--sigma") {
+            options.sigma = std::strtod(value, nullptr);
+        } else if (arg == "--curve") {
+            options.curve = value;
+        } else {
+            return std::nullopt;
+        }
+    }
+    if (options.generations == 0 || options.games == 0 || options.grid < 5 ||
+        options.grid > Config::max_grid_size || options.population == 1 || options.sigma <= 0.0) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+// Score of one game with the given weights; the seed fixes the food, as the policy is
+// deterministic
+int play(const Options& options, const PolicyWeights& weights, std::uint64_t seed) {
+    Simulation sim(options.grid, options.grid, Config::initial_tick, seed);
+    sim.enable_distance_field();
+    const auto starve_after =
+        static_cast<std::uint32_t>(options.grid * options.grid) * starve_ticks_per_cell;
+    std::uint32_t fed_at = 0;
+    int score = 0;
+    while (!sim.is_over() && sim.tick() - fed_at < starve_after) {
+        sim.set_direction(weighted_move(sim, weights));
+        sim.step();
+        if (sim.score() != score) {
+            score = sim.score();
+            fed_at = sim.tick();
+        }
+    }
+    return sim.score();
+}
+
+// Average score of each candidate over the same games, with every (candidate, game) pair
+// claimed from a shared counter by whichever thread is free
+std::vector<double> evaluate(const Options& options,
+                             std::span<const std::vector<double>> candidates) {
+    std::vector<PolicyWeights> weights;
+    for (const auto& candidate : candidates) {
+        weights.push_back(
+            PolicyWeights::from(std::span<const double, PolicyWeights::count>(candidate)));
+    }
+    const std::uint64_t total = candidates.size() * options.games;
+    std::vector<int> scores(total);
+    std::atomic<std::uint64_t> next{0};
+    {
+        const auto jobs = static_cast<unsigned>(std::min<std::uint64_t>(options.jobs, total));
+        std::vector<std::jthread> workers;
+        for (unsigned j = 0; j < jobs; ++j) {
+            workers.emplace_back([&] {
+                for (std::uint64_t i = next.fetch_add(1); i < total; i = next.fetch_add(1)) {
+                    const std::uint64_t game = i % options.games;
+                    scores[i] = play(options, weights[i / options.games], options.seed + game);
+                }
+            });
+        }
+    }
+
+    std::vector<double> fitness(candidates.size(), 0.0);
+    for (std::uint64_t i = 0; i < total; ++i) fitness[i / options.games] += scores[i];
+    for (double& f : fitness) f /= static_cast<double>(options.games);
+    return fitness;
+}
+
+std::string describe(std::span<const double> values) {
+    const auto w = PolicyWeights::from(std::span<const double, PolicyWeights::count>(values));
+    return std::format("food {:.3f}, space {:.3f}, tail {:.3f}, straight {:.3f}", w.food, w.space,
+                       w.tail, w.straight);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto options = parse_args(argc, argv);
+    if (!options) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Starts from the defaults with every term switched on a little
+    const PolicyWeights start{.food = 1.0f, .space = 0.5f, .tail = 0.5f, .straight = 0.0f};
+    const auto start_values = start.to_array();
+    const std::vector<double> initial(start_values.begin(), start_values.end());
+    const double start_fitness = evaluate(*options, std::span(&initial, 1)).front();
+
+    SepCmaEs search(initial, options->sigma, options->population, options->seed);
+    std::println("Tuning {} weights: population {}, {} games each on {}x{}, {} threads; start "
+                 "average score {:.2f}",
+                 PolicyWeights::count, search.population(), options->games, options->grid,
+                 options->grid, options->jobs, start_fitness);
+
+    std::string curve = "generation,best,average,sigma,food,space,tail,straight\n";
+    std::uint64_t games = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (std::uint32_t g = 0; g < options->generations; ++g) {
+        const auto gen_start = std::chrono::steady_clock::now();
+        const auto& candidates = search.ask();
+        const std::vector<double> fitness = evaluate(*options, candidates);
+        search.tell(fitness);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - gen_start;
+        games += candidates.size() * options->games;
+
+        const double best = *std::ranges::max_element(fitness);
+        double average = 0.0;
+        for (const double f : fitness) average += f / static_cast<double>(fitness.size());
+        std::println("generation {:3}: best {:7.2f}, average {:7.2f}, sigma {:.4f}, {:.0f} "
+                     "games/s",
+                     search.generation(), best, average, search.sigma(),
+                     static_cast<double>(candidates.size() * options->games) /
+                         std::max(elapsed.count(), 1e-9));
+        curve += std::format("{},{},{},{}", search.generation(), best, average, search.sigma());
+        for (const double m : search.mean()) curve += std::format(",{}", m);
+        curve += '\n';
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::println("Best weights: {} (average score {:.2f}, start {:.2f})",
+                 describe(search.best()), search.best_fitness(), start_fitness);
+    std::println("Final mean:   {}", describe(search.mean()));
+    std::println("Played {} games in {:.3f} s: {:.0f} games/s", games, elapsed.count(),
+                 static_cast<double>(games) / std::max(elapsed.count(), 1e-9));
+
+    if (!options->curve.empty() &&
+        !write_file_atomically(options->curve, {reinterpret_cast<const std::uint8_t*>(curve.data()),
+                                                curve.size()})) {
+        std::println(stderr, "Cannot write {}", options->curve);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+// Re-simulates replay files on every core and checks each against its claimed result, e.g. to
+// validate leaderboard submissions in bulk. Directories are searched recursively for *.bin.
+//
+//   snake_verify [--jobs N] [--levels PACK] [--quiet] PATH...
+//
+// Exits 0 when every replay verifies, 1 when any fails and 2 on bad arguments.
+
+#include "../src/Config.hpp"
+#include "../src/Level.hpp"
+#include "../src/Replay.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    unsigned jobs = std::max(1U, std::thread::hardware_concurrency());
+    std::string levels = Config::level_pack_path;
+    bool quiet = false; // failures only, no per-file lines for passing replays
+    std::vector<std::filesystem::path> files;
+};
+
+struct Outcome {
+    bool ok = false;
+    std::uint64_t ticks = 0;
+    std::string detail;
+};
+
+void usage(const char* argv0) {
+    std::println(stderr, "usage: {} [--jobs N] [--levels PACK] [--quiet] PATH...", argv0);
+}
+
+std::optional<Options> parse_args(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--jobs" && i + 1 < argc) {
+            options.jobs = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--levels" && i + 1 < argc) {
+            options.levels = argv[++i];
+        } else if (arg == "--quiet") {
+            options.quiet = true;
+        } else if (arg.starts_with("--")) {
+            return std::nullopt;
+        } else if (std::filesystem::is_directory(arg)) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(arg)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".bin") {
+                    options.files.push_back(entry.path());
+                }
+            }
+        } else {
+            options.files.emplace_back(arg);
+        }
+    }
+    if (options.files.empty()) return std::nullopt;
+    std::ranges::sort(options.files);
+    return options;
+}
+
+Outcome verify_file(const std::filesystem::path& path, const LevelPack* levels) {
+    const auto replay = Replay::load(path.string());
+    if (!replay) return {.detail = "unreadable or not a replay"};
+
+    Level level;
+    if (!replay->level.empty()) {
+        const auto index = levels ? levels->find(replay->level) : std::nullopt;
+        if (!index) return {.detail = std::format("level '{}' is not in the pack", replay->level)};
+        level = levels->level(*index);
+    }
+
+    const ReplayCheck check = check_replay(*replay, level);
+    Outcome outcome{.ok = check.ok, .ticks = check.ticks, .detail = {}};
+    if (!check.same_level) {
+        outcome.detail = std::format("recorded on a {}x{} '{}', the pack's is {}x{}",
+                                     replay->grid_w, replay->grid_h, replay->level, level.width,
+                                     level.height);
+    } else if (check.first_mismatch) {
+        outcome.detail = std::format("state diverges by tick {}", *check.first_mismatch);
+    } else if (!check.ok) {
+        outcome.detail =
+            std::format("claims tick {} score {} hash {:016x}, got tick {} score {} hash {:016x}",
+                        replay->final_tick, replay->final_score, replay->final_hash, check.ticks,
+                        check.score, check.hash);
+    } else {
+        outcome.detail = std::format("{} ticks, score {}", check.ticks, check.score);
+    }
+    return outcome;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto options = parse_args(argc, argv);
+    if (!options) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Only replays recorded on a level need the pack
+    auto pack = LevelPack::open(options->levels);
+    const LevelPack* levels = pack ? &*pack : nullptr;
+
+    const auto& files = options->files;
+    std::vector<Outcome> outcomes(files.size());
+    const auto jobs = static_cast<unsigned>(std::min<std::size_t>(options->jobs, files.size()));
+    std::atomic<std::size_t> next{0};
+    const auto start = std::chrono::steady_clock::now();
+    {
+        // Files are handed out one at a time, so a few long games cannot stall a worker's share
+        std::vector<std::jthread> workers;
+        for (unsigned j = 0; j < jobs; ++j) {
+            workers.emplace_back([&] {
+                for (std::size_t i = next++; i < files.size(); i = next++) {
+                    outcomes[i] = verify_file(files[i], levels);
+                }
+            });
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::size_t failed = 0;
+    std::uint64_t ticks = 0;
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        const Outcome& outcome = outcomes[i];
+        ticks += outcome.ticks;
+        if (!outcome.ok) ++failed;
+        if (!outcome.ok || !options->quiet) {
+            std::println("{} {}: {}", outcome.ok ? "OK  " : "FAIL", files[i].string(),
+                         outcome.detail);
+        }
+    }
+
+    const double seconds = std::max(elapsed.count(), 1e-9);
+    const double rate = static_cast<double>(files.size()) / seconds;
+    std::println("Verified {} replays, {} failed, in {:.3f} s on {} threads: {:.0f} replays/s "
+                 "({:.0f} per thread), {:.2f} M ticks/s",
+                 files.size(), failed, seconds, jobs, rate, rate / jobs,
+                 static_cast<double>(ticks) / seconds / 1e6);
+    return failed == 0 ? 0 : 1;
+}